@@ -38,6 +38,11 @@ int main(int argc, char *argv[]) {
         auto end = std::chrono::steady_clock::now();
         std::cout << fmt::format("{} single threaded ran for {:L} µs with {:L} peak memory usage {:L} coroutines/s\n", argv[0], std::chrono::duration_cast<std::chrono::microseconds>(end - start).count(), getPeakRSS(),
                                  std::floor(1'000'000. / static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(end - start).count()) * EVENT_COUNT));
+        auto poolStats = Detail::getCoroutineFramePoolStats();
+        if(poolStats.allocations > 0) {
+            std::cout << fmt::format("{} coroutine frame pool {:L} allocations {:.2f}% hits {:L} frames high-water {:L} bytes cached high-water\n", argv[0], poolStats.allocations,
+                                     100. * static_cast<double>(poolStats.hits) / static_cast<double>(poolStats.allocations), poolStats.highWaterFrames, poolStats.highWaterCachedBytes);
+        }
     }
 
     if(!singleOnly) {
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <ichor/services/timer/ITimerFactory.h>
+#include <ichor/dependency_management/AdvancedService.h>
+#include <ichor/dependency_management/DependencyRegister.h>
+#include <ichor/event_queues/IEventQueue.h>
+#include <ichor/events/InternalEvents.h>
+
+#if defined(__SANITIZE_ADDRESS__)
+constexpr std::chrono::milliseconds RUN_DURATION{200};
+#else
+constexpr std::chrono::milliseconds RUN_DURATION{2'000};
+#endif
+
+using namespace Ichor;
+
+/// How late every expiry of the last run was handled, in nanoseconds
+inline std::vector<int64_t> timerLateness{};
+
+/// Runs TimerCount timers with the given Interval and Slack for RUN_DURATION
+class TestService final : public AdvancedService<TestService> {
+public:
+    TestService(DependencyRegister &reg, Properties props) : AdvancedService(std::move(props)) {
+        reg.registerDependency<ITimerFactory>(this, true);
+        _timerCount = Ichor::any_cast<uint64_t>(getProperties()["TimerCount"]);
+        _interval = Ichor::any_cast<std::chrono::nanoseconds>(getProperties()["Interval"]);
+        _slack = Ichor::any_cast<std::chrono::nanoseconds>(getProperties()["Slack"]);
+    }
+    ~TestService() final = default;
+
+private:
+    Task<tl::expected<void, Ichor::StartError>> start() final {
+        timerLateness.reserve(_timerCount * static_cast<uint64_t>(RUN_DURATION / _interval + 1));
+        _end = std::chrono::steady_clock::now() + RUN_DURATION;
+
+        for(uint64_t i = 0; i < _timerCount; i++) {
+            auto &timer = _timerFactory->createTimer();
+            timer.setChronoInterval(_interval);
+            timer.setChronoSlack(_slack);
+            // every expiry runs the callback, so the nth callback belongs to the nth deadline
+            timer.setMissedTickPolicy(TimerMissedTickPolicy::CATCH_UP);
+            // taken before the timer takes its own start, so lateness is never underestimated
+            auto const timerStart = std::chrono::steady_clock::now();
+            timer.setCallback([this, timerStart, fired = int64_t{}]() mutable {
+                auto const now = std::chrono::steady_clock::now();
+                fired++;
+                timerLateness.push_back((now - (timerStart + _interval * fired)).count());
+                if(now >= _end && !_quitting) {
+                    _quitting = true;
+                    for(auto *t : _timers) {
+                        t->stopTimer();
+                    }
+                    GetThreadLocalEventQueue().pushEvent<QuitEvent>(getServiceId());
+                }
+            });
+            timer.startTimer();
+            _timers.push_back(&timer);
+        }
+        co_return {};
+    }
+
+    Task<void> stop() final {
+        co_return;
+    }
+
+    void addDependencyInstance(ITimerFactory &factory, IService &) {
+        _timerFactory = &factory;
+    }
+
+    void removeDependencyInstance(ITimerFactory &, IService&) {
+        _timerFactory = nullptr;
+    }
+
+    friend DependencyRegister;
+
+    ITimerFactory *_timerFactory{nullptr};
+    std::vector<ITimer*> _timers{};
+    uint64_t _timerCount{};
+    std::chrono::nanoseconds _interval{};
+    std::chrono::nanoseconds _slack{};
+    std::chrono::steady_clock::time_point _end{};
+    bool _quitting{};
+};
@@ -0,0 +1,66 @@
+#include "TestService.h"
+#include <ichor/event_queues/MultimapQueue.h>
+#include <ichor/services/timer/TimerFactoryFactory.h>
+#include <ichor/services/metrics/MemoryUsageFunctions.h>
+#include <algorithm>
+#include <iostream>
+#include <array>
+
+using namespace std::chrono_literals;
+
+struct Run final {
+    std::string_view name;
+    uint64_t timerCount;
+    std::chrono::nanoseconds interval;
+    std::chrono::nanoseconds slack;
+};
+
+/// \param lateness gets partially sorted
+/// \param percentile in [0, 100]
+/// \return lateness at the given percentile
+static int64_t percentile(std::vector<int64_t> &lateness, double percentile) {
+    auto const idx = static_cast<std::size_t>(static_cast<double>(lateness.size() - 1) * percentile / 100.);
+    std::nth_element(lateness.begin(), lateness.begin() + static_cast<std::ptrdiff_t>(idx), lateness.end());
+    return lateness[idx];
+}
+
+int main(int, char *argv[]) {
+    std::locale::global(std::locale("en_US.UTF-8"));
+
+    constexpr std::array<Run, 4> runs{{
+        {"1 timer 1ms interval", 1, 1ms, 0ms},
+        {"1,000 timers 10ms interval", 1'000, 10ms, 0ms},
+        {"1,000 timers 10ms interval 1ms slack", 1'000, 10ms, 1ms},
+        {"10,000 timers 100ms interval 5ms slack", 10'000, 100ms, 5ms},
+    }};
+
+    for(auto const &run : runs) {
+        timerLateness.clear();
+        auto start = std::chrono::steady_clock::now();
+        {
+            auto queue = std::make_unique<MultimapQueue>();
+            auto &dm = queue->createManager();
+            dm.createServiceManager<TimerFactoryFactory>();
+            dm.createServiceManager<TestService>(Properties{{"TimerCount", Ichor::make_any<uint64_t>(run.timerCount)},
+                                                            {"Interval",   Ichor::make_any<std::chrono::nanoseconds>(run.interval)},
+                                                            {"Slack",      Ichor::make_any<std::chrono::nanoseconds>(run.slack)}});
+            queue->start(CaptureSigInt);
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        if(timerLateness.empty()) {
+            std::cout << fmt::format("{} {} did not expire any timers\n", argv[0], run.name);
+            continue;
+        }
+
+        auto const runtime = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        auto const expiries = timerLateness.size();
+        auto const p50 = percentile(timerLateness, 50.);
+        auto const p99 = percentile(timerLateness, 99.);
+        auto const max = *std::max_element(timerLateness.begin(), timerLateness.end());
+        std::cout << fmt::format("{} {} ran for {:L} µs with {:L} peak memory usage {:L} expiries/s lateness p50 {:L} ns p99 {:L} ns max {:L} ns\n",
+                                 argv[0], run.name, runtime, getPeakRSS(), std::floor(1'000'000. / static_cast<double>(runtime) * static_cast<double>(expiries)), p50, p99, max);
+    }
+
+    return 0;
+}
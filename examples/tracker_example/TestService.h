@@ -40,7 +40,7 @@ private:
     void addDependencyInstance(IRuntimeCreatedService &svc, IService &isvc) {
         auto const ownScopeProp = getProperties().find("scope");
         auto const svcScopeProp = isvc.getProperties().find("scope");
-        ICHOR_LOG_INFO(_logger, "Inserted IRuntimeCreatedService svcid {} with scope {} for svcid {} with scope {}", isvc.getServiceId(), Ichor::any_cast<std::string&>(svcScopeProp->second), getServiceId(), Ichor::any_cast<std::string&>(ownScopeProp->second));
+        ICHOR_LOG_INFO(_logger, "Inserted IRuntimeCreatedService svcid {} with scope {} for svcid {} with scope {}", isvc.getServiceId(), Ichor::any_cast<std::string const &>(svcScopeProp->second), getServiceId(), Ichor::any_cast<std::string const &>(ownScopeProp->second));
     }
 
     void removeDependencyInstance(IRuntimeCreatedService&, IService&) {
@@ -70,8 +70,7 @@ private:
         auto runtimeService = _scopedRuntimeServices.find(scope);
 
         if(runtimeService == end(_scopedRuntimeServices)) {
-            auto newProps = *evt.properties.value();
-            newProps.emplace("Filter", Ichor::make_any<Filter>(Filter{ScopeFilterEntry{scope}}));
+            auto newProps = evt.properties.value()->with(Detail::filterPropertyKey, Ichor::make_any<Filter>(Filter{ScopeFilterEntry{scope}}));
 
             _scopedRuntimeServices.emplace(scope, GetThreadLocalManager().createServiceManager<RuntimeCreatedService, IRuntimeCreatedService>(std::move(newProps)));
         }
@@ -13,8 +13,9 @@ namespace Ichor {
     class [[nodiscard]] EventCallbackInfo final {
     public:
         uint64_t listeningServiceId;
-        std::optional<uint64_t> filterServiceId;
-        std::function<AsyncGenerator<IchorBehaviour>(Event const &)> callback;
+        std::function<AsyncGenerator<IchorBehaviour>(Event const &)> callback; // empty if syncCallback is set
+        std::function<bool(Event const &)> syncCallback; // handlers that never suspend, returning false stops further handlers from receiving the event
+        uint64_t registrationSequence; // handlers are called in order of registration, also when split over targeted and untargeted handlers
     };
 
     class [[nodiscard]] EventInterceptInfo final {
@@ -2,6 +2,7 @@
 
 #include <ichor/ConstevalHash.h>
 #include <ichor/stl/Any.h>
+#include <ichor/Properties.h>
 #include <string_view>
 #include <chrono>
 
@@ -124,8 +125,6 @@ namespace Ichor {
     using unordered_set = std::unordered_set<T, Hash, Eq, Allocator>;
 #endif
 
-    using Properties = unordered_map<std::string, Ichor::any, string_hash>;
-
     inline constexpr bool PreventOthersHandling = false;
     inline constexpr bool AllowOthersHandling = true;
 }
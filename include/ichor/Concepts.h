@@ -67,6 +67,14 @@ namespace Ichor {
         { impl.handleEvent(evt) } -> std::same_as<AsyncGenerator<IchorBehaviour>>;
     };
 
+    /// Event handlers that never suspend. Returning false prevents handlers registered after this one from receiving the event.
+    template <class ImplT, class EventT>
+    concept ImplementsSyncEventHandlers = requires(ImplT impl, EventT const &evt) {
+        { impl.handleEvent(evt) } -> std::same_as<void>;
+    } || requires(ImplT impl, EventT const &evt) {
+        { impl.handleEvent(evt) } -> std::same_as<bool>;
+    };
+
     template <class ImplT, class EventT>
     concept ImplementsEventInterceptors = requires(ImplT impl, EventT const &evt, bool processed, uint32_t handlerAmount) {
         { impl.preInterceptEvent(evt) } -> std::same_as<bool>;
@@ -1,11 +1,15 @@
 #pragma once
 
 #include <vector>
+#include <array>
 #include <unordered_map>
 #include <memory>
 #include <chrono>
 #include <atomic>
 #include <mutex>
+#include <thread>
+#include <limits>
+#include <span>
 #include <ichor/interfaces/IFrameworkLogger.h>
 #include <ichor/dependency_management/AdvancedService.h>
 #include <ichor/events/InternalEvents.h>
@@ -13,16 +17,24 @@
 #include <ichor/coroutines/AsyncGenerator.h>
 #include <ichor/dependency_management/ILifecycleManager.h>
 #include <ichor/coroutines/AsyncManualResetEvent.h>
+#include <ichor/coroutines/AsyncCrossThreadEvent.h>
+#include <ichor/coroutines/CancellationToken.h>
 #include <ichor/Callbacks.h>
 #include <ichor/Filter.h>
 #include <ichor/dependency_management/DependencyRegistrations.h>
 #include <ichor/dependency_management/ConstructorInjectionService.h>
+#include <ichor/dependency_management/ServiceGraph.h>
+#include <ichor/dependency_management/ServicesView.h>
+#include <ichor/dependency_management/ServiceMap.h>
+#include <ichor/stl/TimingWheel.h>
 #include <ichor/event_queues/IEventQueue.h>
 
 using namespace std::chrono_literals;
 
 namespace Ichor {
     class CommunicationChannel;
+    class ParallelServiceCreator;
+    class Timer;
 
     struct DependencyTrackerInfo final {
         explicit DependencyTrackerInfo(std::function<void(Event const &)> _trackFunc) noexcept : trackFunc(std::move(_trackFunc)) {}
@@ -52,6 +64,59 @@ namespace Ichor {
         uint32_t count{1}; // default of 1, to be decremented in event completion/error
     };
 
+    namespace Detail {
+        /// Bookkeeping for a coroutine that suspended while handling an event. Generator and originating event are kept together,
+        /// as are the (at most two) service ids for which this coroutine counts as in-flight.
+        struct ScopedCoroutine final {
+            std::unique_ptr<IGenerator> generator;
+            std::shared_ptr<Event> event;
+            std::array<uint64_t, 2> trackedServiceIds{}; // 0 = not tracked
+        };
+
+        /// Entry in the ready queue of the DependencyManager, see DependencyManager::scheduleContinuation()
+        struct ReadyCoroutine final {
+            uint64_t priority;
+            uint64_t sequence; // FIFO order within the same priority
+            uint64_t promiseId;
+            uint64_t originatingService;
+            std::coroutine_handle<> awaiter{}; // set for coroutines resumed by an AsyncCrossThreadEvent, resumed directly instead of by promise id
+
+            /// ordering for std::push_heap/std::pop_heap, puts the most urgent entry at the front
+            bool operator<(ReadyCoroutine const &o) const noexcept {
+                return priority != o.priority ? priority > o.priority : sequence > o.sequence;
+            }
+        };
+
+        /// Bookkeeping for a service created with the "Lazy" property
+        struct LazyService final {
+            std::chrono::milliseconds idleTimeout; // 0 = never stopped when idle
+            std::chrono::steady_clock::time_point idleSince{};
+            bool dormant{true}; // not activated since creation or since the last idle stop
+            bool idle{};
+        };
+
+        /// Services with a true "Lazy" (bool) property are created but not started until a consumer requests one of their interfaces
+        /// or an existing service is interested in them. With a non-zero "LazyIdleTimeout" (std::chrono::milliseconds) property,
+        /// the service is stopped again once it has been without dependees for that long, and reactivated on the next request.
+        inline const PropertyKey lazyPropertyKey{"Lazy"};
+        inline const PropertyKey lazyIdleTimeoutPropertyKey{"LazyIdleTimeout"};
+
+        /// Checked on the dependency resolution path, so a "Lazy" property of another type than bool is ignored instead of throwing
+        [[nodiscard]] inline bool isLazy(Properties const &props) noexcept {
+            auto it = props.find(lazyPropertyKey);
+            return it != props.end() && it->second.type_hash() == typeNameHash<bool>() && Ichor::any_cast<bool>(it->second);
+        }
+
+        /// \return the "LazyIdleTimeout" property, or zero (never stop) if absent or not a std::chrono::milliseconds
+        [[nodiscard]] inline std::chrono::milliseconds lazyIdleTimeout(Properties const &props) noexcept {
+            auto it = props.find(lazyIdleTimeoutPropertyKey);
+            if(it == props.end() || it->second.type_hash() != typeNameHash<std::chrono::milliseconds>()) {
+                return {};
+            }
+            return Ichor::any_cast<std::chrono::milliseconds>(it->second);
+        }
+    }
+
     class DependencyManager final {
     private:
         explicit DependencyManager(IEventQueue *eventQueue);
@@ -117,8 +182,41 @@ namespace Ichor {
             return internalCreateServiceManager<ConstructorInjectionService<Impl>, Interfaces...>(std::move(properties), priority);
         }
 
+        /// Creates all services of a compile-time service graph. Instead of being started through DependencyOnlineEvent cascades,
+        /// the services are started in a precomputed order with their providers injected directly, without DependencyRequestEvents for the required interfaces.
+        /// Services created later can depend on graph services as usual.
+        /// \tparam Graph ServiceGraph type
+        /// \param properties properties per node, in declaration order
+        /// \param priority priority of the services
+        /// \return service ids, in declaration order
+        template <typename Graph>
+        std::array<uint64_t, Graph::size> createServiceGraph(std::array<Properties, Graph::size> properties = {}, uint64_t priority = INTERNAL_EVENT_PRIORITY) {
+            static_assert(Graph::error != ServiceGraphError::MISSING_PROVIDER, "ServiceGraph: a required interface is not provided by any service in the graph");
+            static_assert(Graph::error != ServiceGraphError::AMBIGUOUS_PROVIDER, "ServiceGraph: a required interface is provided by more than one service in the graph");
+            static_assert(Graph::error != ServiceGraphError::CYCLE, "ServiceGraph: the required dependencies form a cycle");
+
+            std::array<uint64_t, Graph::size> ids{};
+            createGraphServices(typename Graph::NodeList{}, ids, properties, priority, std::make_index_sequence<Graph::size>{});
+
+            std::vector<StartServiceGraphEvent::Node> nodes{};
+            nodes.reserve(Graph::size);
+            for(auto idx : Graph::startOrder) {
+                auto &node = nodes.emplace_back(StartServiceGraphEvent::Node{ids[idx], {}});
+                for(auto const &edge : Graph::edges) {
+                    if(edge.dependent == idx) {
+                        node.providers.push_back(ids[edge.provider]);
+                    }
+                }
+            }
+
+            _eventQueue->pushPrioritisedEvent<StartServiceGraphEvent>(0, std::min(INTERNAL_DEPENDENCY_EVENT_PRIORITY, priority), std::move(nodes));
+
+            return ids;
+        }
+
+        /// \param graphRequired only for services of a ServiceGraph: the interfaces whose providers the StartServiceGraphEvent injects
         template<typename Impl, typename... Interfaces>
-        Impl* internalCreateServiceManager(Properties&& properties, uint64_t priority = INTERNAL_EVENT_PRIORITY) {
+        Impl* internalCreateServiceManager(Properties&& properties, uint64_t priority = INTERNAL_EVENT_PRIORITY, std::optional<std::span<uint64_t const>> graphRequired = {}) {
 #ifdef ICHOR_USE_HARDENING
             if(_started.load(std::memory_order_acquire) && this != Detail::_local_dm) [[unlikely]] { // are we on the right thread?
                 std::terminate();
@@ -127,63 +225,10 @@ namespace Ichor {
             if constexpr(RequestsDependencies<Impl>) {
                 static_assert(!std::is_default_constructible_v<Impl>, "Cannot have a dependencies constructor and a default constructor simultaneously.");
                 static_assert(!RequestsProperties<Impl>, "Cannot have a dependencies constructor and a properties constructor simultaneously.");
-                auto cmpMgr = Detail::DependencyLifecycleManager<Impl>::template create<>(std::forward<Properties>(properties), InterfacesList<Interfaces...>);
-
-                if constexpr (sizeof...(Interfaces) > 0) {
-                    static_assert(!ListContainsInterface<IFrameworkLogger, Interfaces...>::value, "IFrameworkLogger cannot have any dependencies");
-                }
-
-                logAddService<Impl, Interfaces...>(cmpMgr->serviceId());
-
-                for (auto const &[key, registration] : cmpMgr->getDependencyRegistry()->_registrations) {
-                    auto const &props = std::get<std::optional<Properties>>(registration);
-                    _eventQueue->pushPrioritisedEvent<DependencyRequestEvent>(cmpMgr->serviceId(), priority, std::get<Dependency>(registration), props.has_value() ? &props.value() : std::optional<Properties const *>{});
-                }
-
-                auto event_priority = std::min(INTERNAL_DEPENDENCY_EVENT_PRIORITY, priority);
-                _eventQueue->pushPrioritisedEvent<StartServiceEvent>(cmpMgr->serviceId(), event_priority, cmpMgr->serviceId());
-
-                cmpMgr->getService().setServicePriority(priority);
-
-                if constexpr (DO_INTERNAL_DEBUG || DO_HARDENING) {
-                    if (_services.contains(cmpMgr->serviceId())) [[unlikely]] {
-                        std::terminate();
-                    }
-                }
-
-                Impl* impl = &cmpMgr->getService();
-                // Can't directly emplace mgr into _services as that would result into modifying the container while iterating.
-                _eventQueue->pushPrioritisedEvent<InsertServiceEvent>(cmpMgr->serviceId(), INTERNAL_INSERT_SERVICE_EVENT_PRIORITY, std::move(cmpMgr));
-
-                return impl;
+                return registerServiceManager<Impl, Interfaces...>(Detail::DependencyLifecycleManager<Impl>::template create<>(std::forward<Properties>(properties), InterfacesList<Interfaces...>), priority, graphRequired);
             } else {
                 static_assert(!(std::is_default_constructible_v<Impl> && RequestsProperties<Impl>), "Cannot have a properties constructor and a default constructor simultaneously.");
-                auto cmpMgr = Detail::LifecycleManager<Impl, Interfaces...>::template create<>(std::forward<Properties>(properties), InterfacesList<Interfaces...>);
-
-                if constexpr (sizeof...(Interfaces) > 0) {
-                    if constexpr (ListContainsInterface<IFrameworkLogger, Interfaces...>::value) {
-                        static_assert(!IsConstructorInjector<Impl>, "Framework loggers cannot use constructor injection");
-                        _logger = cmpMgr->getService().getImplementation();
-                    }
-                }
-
-                cmpMgr->getService().setServicePriority(priority);
-
-                logAddService<Impl, Interfaces...>(cmpMgr->serviceId());
-
-                auto event_priority = std::min(INTERNAL_DEPENDENCY_EVENT_PRIORITY, priority);
-                _eventQueue->pushPrioritisedEvent<StartServiceEvent>(cmpMgr->serviceId(), event_priority, cmpMgr->serviceId());
-
-                if constexpr (DO_INTERNAL_DEBUG || DO_HARDENING) {
-                    if (_services.contains(cmpMgr->serviceId())) [[unlikely]] {
-                        std::terminate();
-                    }
-                }
-
-                Impl* impl = &cmpMgr->getService();
-                _eventQueue->pushPrioritisedEvent<InsertServiceEvent>(cmpMgr->serviceId(), INTERNAL_INSERT_SERVICE_EVENT_PRIORITY, std::move(cmpMgr));
-
-                return impl;
+                return registerServiceManager<Impl, Interfaces...>(Detail::LifecycleManager<Impl, Interfaces...>::template create<>(std::forward<Properties>(properties), InterfacesList<Interfaces...>), priority, graphRequired);
             }
         }
 
@@ -212,7 +257,7 @@ namespace Ichor {
             static_assert(!std::is_same_v<EventT, RemoveEventHandlerEvent>, "RemoveEventHandlerEvent cannot be used in an async manner");
             static_assert(!std::is_same_v<EventT, RemoveEventInterceptorEvent>, "RemoveEventInterceptorEvent cannot be used in an async manner");
             static_assert(!std::is_same_v<EventT, RemoveTrackerEvent>, "RemoveTrackerEvent cannot be used in an async manner");
-            static_assert(!std::is_same_v<EventT, ContinuableEvent>, "ContinuableEvent cannot be used in an async manner");
+            static_assert(!std::is_same_v<EventT, ResumeCoroutinesEvent>, "ResumeCoroutinesEvent cannot be used in an async manner");
             static_assert(!std::is_same_v<EventT, ContinuableStartEvent>, "ContinuableStartEvent cannot be used in an async manner");
 
 #ifdef ICHOR_USE_HARDENING
@@ -279,11 +324,10 @@ namespace Ichor {
                     continue;
                 }
 
-                for (auto const &[interfaceHash, registration] : depRegistry->_registrations) {
-                    if(interfaceHash == typeNameHash<Interface>()) {
-                        auto const &props = std::get<std::optional<Properties>>(registration);
-                        requests.emplace_back(0, mgr->serviceId(), INTERNAL_EVENT_PRIORITY, std::get<Dependency>(registration), props.has_value() ? &props.value() : std::optional<Properties const *>{});
-                    }
+                auto const *registration = depRegistry->find(typeNameHash<Interface>());
+                if(registration != nullptr) {
+                    auto const &props = registration->props;
+                    requests.emplace_back(0, mgr->serviceId(), INTERNAL_EVENT_PRIORITY, registration->dependency, props.has_value() ? &props.value() : std::optional<Properties const *>{});
                 }
             }
 
@@ -327,7 +371,7 @@ namespace Ichor {
             static_assert(!std::is_same_v<EventT, RemoveEventHandlerEvent>, "RemoveEventHandlerEvent cannot be used for completion callbacks");
             static_assert(!std::is_same_v<EventT, RemoveEventInterceptorEvent>, "RemoveEventInterceptorEvent cannot be used for completion callbacks");
             static_assert(!std::is_same_v<EventT, RemoveTrackerEvent>, "RemoveTrackerEvent cannot be used for completion callbacks");
-            static_assert(!std::is_same_v<EventT, ContinuableEvent>, "ContinuableEvent cannot be used for completion callbacks");
+            static_assert(!std::is_same_v<EventT, ResumeCoroutinesEvent>, "ResumeCoroutinesEvent cannot be used for completion callbacks");
             static_assert(!std::is_same_v<EventT, ContinuableStartEvent>, "ContinuableStartEvent cannot be used for completion callbacks");
             static_assert(!std::is_same_v<EventT, InsertServiceEvent>, "InsertServiceEvent cannot be used for completion callbacks");
 
@@ -344,10 +388,10 @@ namespace Ichor {
 
         template <typename EventT, typename Impl>
 #if (!defined(WIN32) && !defined(_WIN32) && !defined(__WIN32)) || defined(__CYGWIN__)
-        requires Derived<EventT, Event> && ImplementsEventHandlers<Impl, EventT>
+        requires Derived<EventT, Event> && (ImplementsEventHandlers<Impl, EventT> || ImplementsSyncEventHandlers<Impl, EventT>)
 #endif
         [[nodiscard]]
-        /// Register an event handler
+        /// Register an event handler. Handlers returning void or bool instead of AsyncGenerator<IchorBehaviour> are called without creating a coroutine.
         /// \tparam EventT type of event (has to derive from Event)
         /// \tparam Impl type of class registering handler (auto-deducible)
         /// \param serviceId id of service registering handler
@@ -360,27 +404,24 @@ namespace Ichor {
                 std::terminate();
             }
 #endif
-            auto existingHandlers = _eventCallbacks.find(EventT::TYPE);
-            if(existingHandlers == end(_eventCallbacks)) {
-                std::vector<EventCallbackInfo> v{};
-                v.template emplace_back<>(EventCallbackInfo{
-                        self->getServiceId(),
-                        targetServiceId,
-                        std::function<AsyncGenerator<IchorBehaviour>(Event const &)>{
-                            [impl](Event const &evt) { return impl->handleEvent(static_cast<EventT const &>(evt)); }
-                        }
-                });
-                _eventCallbacks.emplace(EventT::TYPE, std::move(v));
+            EventCallbackInfo info{self->getServiceId(), {}, {}, _eventCallbackSequence++};
+            if constexpr (ImplementsEventHandlers<Impl, EventT>) {
+                info.callback = [impl](Event const &evt) { return impl->handleEvent(static_cast<EventT const &>(evt)); };
+            } else if constexpr (std::is_same_v<decltype(impl->handleEvent(std::declval<EventT const &>())), bool>) {
+                info.syncCallback = [impl](Event const &evt) { return impl->handleEvent(static_cast<EventT const &>(evt)); };
             } else {
-                existingHandlers->second.emplace_back(EventCallbackInfo{
-                    self->getServiceId(),
-                    targetServiceId,
-                    std::function<AsyncGenerator<IchorBehaviour>(Event const &)>{
-                        [impl](Event const &evt) { return impl->handleEvent(static_cast<EventT const &>(evt)); }
-                    }
-                });
+                info.syncCallback = [impl](Event const &evt) {
+                    impl->handleEvent(static_cast<EventT const &>(evt));
+                    return true;
+                };
             }
-            return EventHandlerRegistration(CallbackKey{self->getServiceId(), EventT::TYPE}, self->getServicePriority());
+
+            if(targetServiceId.has_value()) {
+                _targetedEventCallbacks[CallbackKey{*targetServiceId, EventT::TYPE}].emplace_back(std::move(info));
+            } else {
+                _eventCallbacks[EventT::TYPE].emplace_back(std::move(info));
+            }
+            return EventHandlerRegistration(CallbackKey{self->getServiceId(), EventT::TYPE}, self->getServicePriority(), targetServiceId);
         }
 
         template <typename EventT, typename Impl>
@@ -484,7 +525,7 @@ namespace Ichor {
                 std::terminate();
             }
 #endif
-            auto svc = std::find_if(_services.begin(), _services.end(), [&id](const std::pair<const uint64_t, std::unique_ptr<ILifecycleManager>> &svcPair) {
+            auto svc = std::find_if(_services.begin(), _services.end(), [&id](auto const &svcPair) {
                 return svcPair.second->getIService()->getServiceGid() == id;
             });
 
@@ -510,68 +551,66 @@ namespace Ichor {
                 return {};
             }
 
-            auto intf = std::find_if(svc->second->getInterfaces().begin(), svc->second->getInterfaces().end(), [](Dependency const &d) {
-                return d.interfaceNameHash == typeNameHash<Interface>();
-            });
+            auto impl = _services.resolveInterface(svc, typeNameHash<Interface>());
 
-            if(intf == svc->second->getInterfaces().end()) {
+            if(!impl) {
                 return {};
             }
-            Interface* ret{};
-            IService* retIsvc{};
-            std::function<void(NeverNull<void*>, IService&)> f{[&ret, &retIsvc](NeverNull<void*> svc2, IService& isvc){ ret = reinterpret_cast<Interface*>(svc2.get()); retIsvc = &isvc; }};
-            svc->second->insertSelfInto(typeNameHash<Interface>(), 0, f);
-            svc->second->getDependees().erase(0);
 
-            return std::pair<Interface*, IService*>(ret, retIsvc);
+            return std::pair<Interface*, IService*>{static_cast<Interface*>(*impl), svc->second->getIService()};
         }
 
+        /// Get all started services by given template interface type. Uses an index maintained by the DependencyManager, does not allocate.
+        /// \tparam Interface interface to search for
+        /// \return view of found services, invalidated when services start or stop
         template <typename Interface>
-        [[nodiscard]] std::vector<NeverNull<Interface*>> getStartedServices() noexcept {
+        [[nodiscard]] StartedServicesView<Interface> getStartedServices() noexcept {
 #ifdef ICHOR_USE_HARDENING
             if(this != Detail::_local_dm) [[unlikely]] { // are we on the right thread?
                 std::terminate();
             }
 #endif
-            std::vector<NeverNull<Interface*>> ret{};
-            std::function<void(NeverNull<void*>, IService&)> f{[&ret](NeverNull<void*> svc2, IService& /*isvc*/){ ret.push_back(reinterpret_cast<Interface*>(svc2.get())); }};
-            for(auto &[key, svc] : _services) {
-                if(svc->getServiceState() != ServiceState::ACTIVE) {
-                    continue;
-                }
-                svc->insertSelfInto(typeNameHash<Interface>(), 0, f);
-                svc->getDependees().erase(0);
+            auto providers = _startedServicesByInterface.find(typeNameHash<Interface>());
+
+            if(providers == _startedServicesByInterface.end()) {
+                return {};
             }
 
-            return ret;
+            return StartedServicesView<Interface>{&providers->second};
         }
 
-        template <typename Interface>
-        /// Get all services by given template interface type, regardless of state
+        /// Get all services by given template interface type, regardless of state. Uses an index maintained by the DependencyManager, does not allocate.
         /// \tparam Interface interface to search for
-        /// \return list of found services
-        [[nodiscard]] std::vector<std::pair<Interface&, IService&>> getAllServicesOfType() noexcept {
+        /// \return view of found services, invalidated when services are inserted or removed
+        template <typename Interface>
+        [[nodiscard]] AllServicesView<Interface> getAllServicesOfType() noexcept {
 #ifdef ICHOR_USE_HARDENING
             if(this != Detail::_local_dm) [[unlikely]] { // are we on the right thread?
                 std::terminate();
             }
 #endif
-            std::vector<std::pair<Interface&, IService&>> ret{};
-            std::function<void(NeverNull<void*>, IService&)> f{[&ret](NeverNull<void*> svc2, IService & isvc){ ret.emplace_back(*reinterpret_cast<Interface*>(svc2.get()), isvc); }};
-            for(auto &[key, svc] : _services) {
-                auto intf = std::find_if(svc->getInterfaces().begin(), svc->getInterfaces().end(), [](const Dependency &dep) {
-                    return dep.interfaceNameHash == typeNameHash<Interface>();
-                });
-                if(intf == svc->getInterfaces().end()) {
-                    continue;
-                }
-                svc->insertSelfInto(typeNameHash<Interface>(), 0, f);
-                svc->getDependees().erase(0);
+            auto providers = _servicesByInterface.find(typeNameHash<Interface>());
+
+            if(providers == _servicesByInterface.end()) {
+                return {};
             }
 
-            return ret;
+            return AllServicesView<Interface>{&providers->second};
         }
 
+        /// Captures which service satisfied which interface of which other service, the filters in use and a valid start order.
+        /// Meant to be called after a successful start, to be replayed with replayDependencyGraphSnapshot() on the next start of an identical configuration.
+        /// Do not use in coroutines or other threads
+        /// \return snapshot of the currently resolved dependency graph
+        [[nodiscard]] DependencyGraphSnapshot createDependencyGraphSnapshot() const;
+
+        /// Starts the currently created services using the wiring of snapshot instead of resolving dependencies through events.
+        /// The snapshot is validated first: every service has to exist with the same implementation name, interfaces and filter presence.
+        /// On any mismatch, nothing is done and the services are resolved normally. Has to be called after creating the services, either
+        /// before the DependencyManager is started or on its thread. Services with a priority below INTERNAL_DEPENDENCY_EVENT_PRIORITY may have started before the replay.
+        /// \param snapshot output of createDependencyGraphSnapshot() of a previous run
+        void replayDependencyGraphSnapshot(DependencyGraphSnapshot snapshot);
+
         /// Returns a list of currently known services and their status.
         /// Do not use in coroutines or other threads
         /// NOT thread-safe!!
@@ -585,7 +624,162 @@ namespace Ichor {
 
         [[nodiscard]] IEventQueue& getEventQueue() const noexcept;
 
+        /// Token that gets cancelled as soon as the manager starts stopping the service, before waiting on the service's in-flight coroutines.
+        /// Services pass it to the operations they await, so that stopping them does not have to wait for those to complete.
+        /// A service that is started again gets a new token.
+        /// Do not use in other threads
+        /// \param serviceId
+        /// \return
+        [[nodiscard]] CancellationToken getServiceStopToken(uint64_t serviceId);
+
+        /// Statistics of the pool coroutine frames of this manager's thread are allocated from. All zero if ICHOR_USE_COROUTINE_FRAME_POOL is not defined.
+        /// Do not use in other threads
+        /// \return hit rate, high-water marks etc.
+        [[nodiscard]] CoroutineFramePoolStats getCoroutineFramePoolStats() const noexcept {
+#ifdef ICHOR_USE_HARDENING
+            if(this != Detail::_local_dm) [[unlikely]] { // are we on the right thread?
+                std::terminate();
+            }
+#endif
+            return Detail::getCoroutineFramePoolStats();
+        }
+
     private:
+        template <typename... Nodes, size_t... Is>
+        void createGraphServices(typeList<Nodes...>, std::array<uint64_t, sizeof...(Nodes)> &ids, std::array<Properties, sizeof...(Nodes)> &properties, uint64_t priority, std::index_sequence<Is...>) {
+            ((ids[Is] = createGraphService(static_cast<Nodes*>(nullptr), std::move(properties[Is]), priority)), ...);
+        }
+
+        template <typename Impl, typename... Interfaces, typename... Required>
+        uint64_t createGraphService(GraphService<Impl, InterfacesList_t<Interfaces...>, RequiredList_t<Required...>> *, Properties&& properties, uint64_t priority) {
+            using Node = GraphService<Impl, InterfacesList_t<Interfaces...>, RequiredList_t<Required...>>;
+            using ServiceT = std::conditional_t<DerivedTemplated<Impl, AdvancedService>, Impl, ConstructorInjectionService<Impl>>;
+            static_assert(ImplementsAll<Impl, Interfaces...>, "ServiceGraph: service does not implement all of its interfaces");
+            static_assert(sizeof...(Required) == 0 || RequestsDependencies<ServiceT>, "ServiceGraph: service has required interfaces but does not register any dependencies");
+            return internalCreateServiceManager<ServiceT, Interfaces...>(std::move(properties), priority, std::span<uint64_t const>{Node::required})->getServiceId();
+        }
+
+        /// Starts a dormant lazy service
+        /// \param lazyIt entry in _lazyServices
+        /// \param mgr manager of the lazy service
+        void activateLazyService(unordered_map<uint64_t, Detail::LazyService>::iterator lazyIt, ILifecycleManager &mgr);
+        /// Activates all dormant lazy services providing interfaceHash
+        /// \param interfaceHash requested interface
+        /// \param requestingServiceId service requesting the interface, used to apply filters
+        void activateLazyProviders(uint64_t interfaceHash, uint64_t requestingServiceId);
+        /// Schedules the next LazyIdleCheckEvent on the timer wheel, a few times per idle timeout of the active lazy services. Does nothing if none with an idle timeout is active.
+        void scheduleLazyIdleCheck() noexcept;
+        /// Makes the timer findable for the TimerEvents it pushes
+        /// \param timer
+        void registerTimer(Timer &timer);
+        void unregisterTimer(Timer &timer) noexcept;
+        /// Schedules a timer, or the lazy idle check, to expire at when, rounded up to the wheel's microsecond ticks. The entry has to be unscheduled.
+        /// \param entry
+        /// \param when
+        /// \param slack how much later the entry may expire, used to share a tick with other timers
+        void scheduleTimer(Detail::TimingWheelEntry &entry, std::chrono::steady_clock::time_point when, std::chrono::nanoseconds slack) noexcept;
+        void cancelTimer(Detail::TimingWheelEntry &entry) noexcept;
+        /// \return moment at which expireTimers() has work to do, which may be in the past, or nothing if no timer is scheduled
+        [[nodiscard]] std::optional<std::chrono::steady_clock::time_point> nextTimerExpiry() const noexcept;
+        /// Lets every timer that expired by now push its event. Cheap if none did, called by the event queue before it waits for events.
+        void expireTimers();
+
+        /// Maps the services of snapshot onto the current services
+        /// \param snapshot
+        /// \return nodes to start in order, or nullopt if snapshot does not match the current services
+        [[nodiscard]] std::optional<std::vector<StartServiceGraphEvent::Node>> matchDependencyGraphSnapshot(DependencyGraphSnapshot const &snapshot) const;
+
+        /// Adds mgr to the index of all services, for every interface it provides
+        void indexService(ILifecycleManager &mgr);
+        /// Removes mgr from both indices
+        void unindexService(ILifecycleManager const &mgr) noexcept;
+        /// Adds mgr to the index of started services, called when it became ACTIVE
+        void indexStartedService(ILifecycleManager &mgr);
+        /// Removes mgr from the index of started services, called when it is no longer ACTIVE
+        void unindexStartedService(ILifecycleManager const &mgr) noexcept;
+
+        /// Hands a constructed manager to the event loop: wires up framework loggers, requests its dependencies, starts and inserts it.
+        /// Every way of creating services ends up here, including services constructed off-thread by ParallelServiceCreator.
+        /// \tparam Impl service type of the manager
+        /// \tparam Interfaces interfaces provided by Impl
+        /// \param cmpMgr manager to insert
+        /// \param priority priority of the service
+        /// \param graphRequired only for services of a ServiceGraph, which are started by a StartServiceGraphEvent. The interfaces whose providers it injects,
+        /// these are not requested through DependencyRequestEvents. Has to match the required dependencies the service registers.
+        /// \return the service
+        template<typename Impl, typename... Interfaces, typename ManagerT>
+        Impl* registerServiceManager(std::unique_ptr<ManagerT> cmpMgr, uint64_t priority, std::optional<std::span<uint64_t const>> graphRequired = {}) {
+#ifdef ICHOR_USE_HARDENING
+            if(_started.load(std::memory_order_acquire) && this != Detail::_local_dm) [[unlikely]] { // are we on the right thread?
+                std::terminate();
+            }
+#endif
+            if constexpr (sizeof...(Interfaces) > 0) {
+                if constexpr (ListContainsInterface<IFrameworkLogger, Interfaces...>::value) {
+                    static_assert(!RequestsDependencies<Impl>, "IFrameworkLogger cannot have any dependencies");
+                    static_assert(!IsConstructorInjector<Impl>, "Framework loggers cannot use constructor injection");
+                    _logger = cmpMgr->getService().getImplementation();
+                }
+            }
+
+            cmpMgr->getService().setServicePriority(priority);
+
+            logAddService<Impl, Interfaces...>(cmpMgr->serviceId());
+
+            if constexpr(RequestsDependencies<Impl>) {
+                auto const &registrations = cmpMgr->getDependencyRegistry()->_registrations;
+
+                if constexpr (DO_INTERNAL_DEBUG || DO_HARDENING) {
+                    if(graphRequired) {
+                        size_t requiredRegistrations{};
+                        for (auto const &registration : registrations) {
+                            if(!registration.dependency.required) {
+                                continue;
+                            }
+                            requiredRegistrations++;
+                            if(std::find(graphRequired->begin(), graphRequired->end(), registration.dependency.interfaceNameHash) == graphRequired->end()) [[unlikely]] {
+                                std::terminate(); // the Required list of the GraphService is missing a required dependency of Impl
+                            }
+                        }
+                        if(requiredRegistrations != graphRequired->size()) [[unlikely]] {
+                            std::terminate(); // the Required list of the GraphService contains interfaces Impl does not require
+                        }
+                    }
+                }
+
+                for (auto const &registration : registrations) {
+                    if(graphRequired && std::find(graphRequired->begin(), graphRequired->end(), registration.dependency.interfaceNameHash) != graphRequired->end()) {
+                        continue;
+                    }
+                    auto const &props = registration.props;
+                    _eventQueue->pushPrioritisedEvent<DependencyRequestEvent>(cmpMgr->serviceId(), priority, registration.dependency, props.has_value() ? &props.value() : std::optional<Properties const *>{});
+                }
+            }
+
+            if(!graphRequired && !Detail::isLazy(cmpMgr->getProperties())) {
+                auto event_priority = std::min(INTERNAL_DEPENDENCY_EVENT_PRIORITY, priority);
+                _eventQueue->pushPrioritisedEvent<StartServiceEvent>(cmpMgr->serviceId(), event_priority, cmpMgr->serviceId());
+            }
+
+            if constexpr (DO_INTERNAL_DEBUG || DO_HARDENING) {
+                if (_services.contains(cmpMgr->serviceId())) [[unlikely]] {
+                    std::terminate();
+                }
+            }
+
+            Impl* impl = &cmpMgr->getService();
+            // Can't directly emplace mgr into _services as that would result into modifying the container while iterating.
+            _eventQueue->pushPrioritisedEvent<InsertServiceEvent>(cmpMgr->serviceId(), INTERNAL_INSERT_SERVICE_EVENT_PRIORITY, std::move(cmpMgr));
+
+            return impl;
+        }
+
+        /// Injects manager, which just came online, into all services interested in it
+        /// \param manager service that came online
+        /// \param eventId id of the event causing this, for debugging
+        /// \param skip services that should not be notified
+        void notifyDependentsOnline(std::unique_ptr<ILifecycleManager> &manager, uint64_t eventId, std::vector<uint64_t> const &skip);
+
         template <typename EventT>
 #if (!defined(WIN32) && !defined(_WIN32) && !defined(__WIN32)) || defined(__CYGWIN__)
         requires Derived<EventT, Event>
@@ -658,6 +852,29 @@ namespace Ichor {
         void processEvent(std::unique_ptr<Event> &&evt);
         void stop();
         [[nodiscard]] bool existingCoroutineFor(uint64_t serviceId) const noexcept;
+        /// Stores a suspended coroutine and its originating event, increments the in-flight count of the services it belongs to.
+        /// \param promiseId
+        /// \param generator
+        /// \param evt
+        void addScopedCoroutine(uint64_t promiseId, std::unique_ptr<IGenerator> generator, std::shared_ptr<Event> evt);
+        /// Counterpart of addScopedCoroutine, removes the coroutine and decrements the in-flight count of the services it belongs to.
+        /// \param promiseId
+        void removeScopedCoroutine(uint64_t promiseId) noexcept;
+        /// Queues a scoped coroutine to be continued at the given priority. Only pushes a ResumeCoroutinesEvent if none is queued that would handle it in time,
+        /// so that continuing many coroutines does not allocate an event and take the queue's lock for each of them.
+        /// \param promiseId
+        /// \param originatingService
+        /// \param priority
+        void scheduleContinuation(uint64_t promiseId, uint64_t originatingService, uint64_t priority);
+        /// Ensures a ResumeCoroutinesEvent with a priority equal to or more urgent than priority is queued
+        void armResumeCoroutines(uint64_t priority);
+        void continueScopedCoroutine(Detail::ReadyCoroutine const &ready);
+        /// Hands a suspended coroutine, e.g. one awaiting an AsyncCrossThreadEvent, over to this manager's ready queue. Safe to call from any thread.
+        /// Lock-free, only pushes a ResumeCoroutinesEvent if none has been pushed for a priority equal to or more urgent than the resumption's since the last drain.
+        /// \param resumption
+        void scheduleRemoteResumption(Detail::RemoteResumption &resumption) noexcept;
+        /// Moves all resumptions handed over by other threads into the ready queue, in the order they were scheduled
+        void drainRemoteResumptions();
         /// Coroutine based method to wait for a service to have finished with either DependencyOfflineEvent or StopServiceEvent
         /// \param serviceId
         /// \param eventType
@@ -670,17 +887,34 @@ namespace Ichor {
         /// \return
         bool finishWaitingService(uint64_t serviceId, uint64_t eventType, [[maybe_unused]] std::string_view eventName) noexcept;
 
-        unordered_map<uint64_t, std::unique_ptr<ILifecycleManager>> _services{}; // key = service id
+        Detail::ServiceMap _services{}; // key = service id
+        mutable unordered_map<uint64_t, std::vector<Detail::InterfaceProvider>> _servicesByInterface{}; // key = interface name hash, mutable to cache resolved pointers
+        unordered_map<uint64_t, std::vector<Detail::InterfaceProvider>> _startedServicesByInterface{}; // key = interface name hash, only ACTIVE services
         unordered_map<uint64_t, std::vector<DependencyTrackerInfo>> _dependencyRequestTrackers{}; // key = interface name hash
         unordered_map<uint64_t, std::vector<DependencyTrackerInfo>> _dependencyUndoRequestTrackers{}; // key = interface name hash
         unordered_map<CallbackKey, std::function<void(Event const &)>> _completionCallbacks{}; // key = listening service id + event type
         unordered_map<CallbackKey, std::function<void(Event const &)>> _errorCallbacks{}; // key = listening service id + event type
-        unordered_map<uint64_t, std::vector<EventCallbackInfo>> _eventCallbacks{}; // key = event id
+        unordered_map<uint64_t, std::vector<EventCallbackInfo>> _eventCallbacks{}; // key = event id, only handlers without target service
+        unordered_map<CallbackKey, std::vector<EventCallbackInfo>> _targetedEventCallbacks{}; // key = target service id + event id
+        uint64_t _eventCallbackSequence{}; // registrationSequence of the next registered event handler
         unordered_map<uint64_t, std::vector<EventInterceptInfo>> _eventInterceptors{}; // key = event id
-        unordered_map<uint64_t, std::unique_ptr<IGenerator>> _scopedGenerators{}; // key = promise id
-        unordered_map<uint64_t, std::shared_ptr<Event>> _scopedEvents{}; // key = promise id
+        unordered_map<uint64_t, Detail::ScopedCoroutine> _scopedCoroutines{}; // key = promise id
+        std::vector<Detail::ReadyCoroutine> _readyCoroutines{}; // binary heap, most urgent first
+        std::vector<uint64_t> _resumeCoroutinesPriorities{}; // priorities of the queued ResumeCoroutinesEvents
+        uint64_t _readyCoroutineSequence{};
+        std::atomic<Detail::RemoteResumption*> _remoteResumptions{}; // intrusive stack, pushed by any thread, drained by the manager's thread
+        std::atomic<uint64_t> _remoteResumptionPriority{std::numeric_limits<uint64_t>::max()}; // most urgent ResumeCoroutinesEvent pushed for remote resumptions since the last drain
+        unordered_map<uint64_t, uint64_t> _scopedCoroutineCounts{}; // key = service id, value = amount of in-flight coroutines
         unordered_map<uint64_t, EventWaiter> _eventWaiters{}; // key = event id
         unordered_map<uint64_t, EventWaiter> _dependencyWaiters{}; // key = event id
+        unordered_map<uint64_t, Detail::LazyService> _lazyServices{}; // key = service id
+        unordered_map<uint64_t, CancellationSource> _serviceStopSources{}; // key = service id, created on first request
+        Detail::TimingWheelEntry _lazyIdleCheckEntry{}; // on _timerWheel while lazy services with an idle timeout are active
+        std::chrono::steady_clock::time_point _lazyIdleCheckDeadline{};
+        Detail::TimingWheel _timerWheel{}; // all scheduled timers of this manager, one tick per microsecond since _timerWheelStart
+        std::chrono::steady_clock::time_point _timerWheelStart{std::chrono::steady_clock::now()};
+        std::chrono::steady_clock::time_point _nextTimerExpiry{std::chrono::steady_clock::time_point::max()}; // may be earlier than needed, never later
+        unordered_map<uint64_t, Timer*> _timers{}; // key = timer id
         IEventQueue *_eventQueue;
         IFrameworkLogger *_logger{nullptr};
         std::atomic<bool> _started{false};
@@ -692,6 +926,11 @@ namespace Ichor {
         friend class ILifecycleManager;
         friend class EventCompletionHandlerRegistration;
         friend class CommunicationChannel;
+        friend class ParallelServiceCreator;
+        friend class Timer;
+        friend void Detail::resumeOn(DependencyManager *dm, Detail::RemoteResumption &resumption) noexcept;
+        template <typename T>
+        friend class Detail::AsyncGeneratorPromise;
     };
 
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <fmt/core.h>
 
 namespace Ichor
@@ -52,7 +53,10 @@ namespace Ichor
     //
     // [C] - Consumer performs this transition
     // [P] - Producer performs this transition
-    enum class state
+    //
+    // Ichor's producer goes from VNRCS to VRPS directly and transfers to the consumer (symmetric transfer),
+    // instead of resuming the consumer from within VRPA.
+    enum class state : uint8_t
     {
         value_not_ready_consumer_active,
         value_not_ready_consumer_suspended,
@@ -75,6 +79,10 @@ namespace Ichor
         FAILED
     };
 
+    enum class TimeoutError {
+        TIMED_OUT
+    };
+
     // Necessary to prevent excessive events on the queue.
     // Every async call using this will end up adding an event to the queue on co_return/co_yield.
     enum class IchorBehaviour {
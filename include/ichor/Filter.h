@@ -1,14 +1,17 @@
 #pragma once
 
 #include <ichor/Common.h>
+#include <ichor/dependency_management/ILifecycleManager.h>
 #include <string>
+#include <vector>
+#include <optional>
 
 namespace Ichor {
 
     template <typename T>
     class PropertiesFilterEntry final {
     public:
-        PropertiesFilterEntry(std::string _key, T _val) noexcept : key(std::move(_key)), val(std::move(_val)) {}
+        PropertiesFilterEntry(std::string_view _key, T _val) : key(_key), val(std::move(_val)) {}
 
         [[nodiscard]] bool matches(ILifecycleManager const &manager) const noexcept {
             auto const propVal = manager.getProperties().find(key);
@@ -21,10 +24,10 @@ namespace Ichor {
                 return false;
             }
 
-            return Ichor::any_cast<T&>(propVal->second) == val;
+            return Ichor::any_cast<T const &>(propVal->second) == val;
         }
 
-        std::string key;
+        PropertyKey key;
         T val;
     };
 
@@ -39,34 +42,63 @@ namespace Ichor {
         uint64_t id;
     };
 
-    class ITemplatedFilter {
-    public:
-        virtual ~ITemplatedFilter() noexcept = default;
-        [[nodiscard]] virtual bool compareTo(ILifecycleManager const &manager) const noexcept = 0;
-    };
-
     template <typename T>
-    class TemplatedFilter final : public ITemplatedFilter {
-    public:
-        TemplatedFilter(T&& _entries) noexcept : entries(std::forward<T>(_entries)) {}
-        ~TemplatedFilter() noexcept final = default;
+    concept FilterEntry = requires(T const &entry, ILifecycleManager const &manager) {
+        { entry.matches(manager) } -> std::same_as<bool>;
+    };
 
-        TemplatedFilter(const TemplatedFilter&) = default;
-        TemplatedFilter(TemplatedFilter&&) noexcept = default;
-        TemplatedFilter& operator=(const TemplatedFilter&) = default;
-        TemplatedFilter& operator=(TemplatedFilter&&) noexcept = default;
+    namespace Detail {
+        using matchesFnPtr = bool(*)(void const *entry, ILifecycleManager const &manager) noexcept;
+
+        /// Filter entries flattened into a list of non-virtual predicates. Immutable once constructed, shared between copies of a Filter.
+        struct CompiledFilter final {
+            struct PropertyPredicate final {
+                PropertyKey key; // interned, so matching looks the property up by id
+                uint64_t typeHash;
+                bool(*equals)(Ichor::any const &propVal, void const *expected) noexcept;
+                std::shared_ptr<void const> expected;
+            };
+
+            struct CustomPredicate final {
+                matchesFnPtr matches;
+                std::shared_ptr<void const> entry;
+            };
+
+            [[nodiscard]] bool matches(ILifecycleManager const &manager) const noexcept {
+                if(!propertyPredicates.empty()) {
+                    auto const &props = manager.getProperties();
+                    for (auto const &pred : propertyPredicates) {
+                        auto const propVal = props.find(pred.key);
+
+                        if (propVal == cend(props) || propVal->second.type_hash() != pred.typeHash || !pred.equals(propVal->second, pred.expected.get())) {
+                            return false;
+                        }
+                    }
+                }
+
+                for(auto const &pred : customPredicates) {
+                    if(!pred.matches(pred.entry.get(), manager)) {
+                        return false;
+                    }
+                }
+
+                return true;
+            }
 
-        [[nodiscard]] bool compareTo(ILifecycleManager const &manager) const noexcept final {
-            return entries.matches(manager);
-        }
-
-        T entries;
-    };
+            std::vector<PropertyPredicate> propertyPredicates{};
+            std::vector<CustomPredicate> customPredicates{};
+        };
+    }
 
+    /// All entries have to match for the filter to match. ServiceIdFilterEntry and PropertiesFilterEntry are compiled into
+    /// flat predicates, other entries are type erased. A ServiceIdFilterEntry makes the filter selective, which allows
+    /// the DependencyManager to look up the single possibly matching service rather than testing all of them.
     class Filter final {
     public:
-        template <typename... T>
-        Filter(T&&... entries) noexcept : _templatedFilter(new TemplatedFilter<T...>(std::forward<T>(entries)...)) {}
+        template <FilterEntry... T>
+        Filter(T&&... entries) {
+            (compile(std::forward<T>(entries)), ...);
+        }
 
         Filter(Filter&) = default;
         Filter(const Filter&) = default;
@@ -75,9 +107,68 @@ namespace Ichor {
         Filter& operator=(Filter&&) noexcept = default;
 
         [[nodiscard]] bool compareTo(ILifecycleManager const &manager) const noexcept {
-            return _templatedFilter->compareTo(manager);
+            if(_serviceId.has_value() && *_serviceId != manager.serviceId()) {
+                return false;
+            }
+
+            return _compiled == nullptr || _compiled->matches(manager);
+        }
+
+        /// \return the id of the only service this filter can possibly match, if any
+        [[nodiscard]] std::optional<uint64_t> selectedServiceId() const noexcept {
+            return _serviceId;
         }
 
-        std::shared_ptr<ITemplatedFilter> _templatedFilter;
+    private:
+        void compile(ServiceIdFilterEntry entry) {
+            if(!_serviceId.has_value()) {
+                _serviceId = entry.id;
+                return;
+            }
+
+            compileCustom(std::move(entry));
+        }
+
+        template <typename T>
+        void compile(PropertiesFilterEntry<T> entry) {
+            compiled().propertyPredicates.push_back(Detail::CompiledFilter::PropertyPredicate{
+                entry.key,
+                typeNameHash<T>(),
+                [](Ichor::any const &propVal, void const *expected) noexcept {
+                    return Ichor::any_cast<T const &>(propVal) == *static_cast<T const *>(expected);
+                },
+                std::make_shared<T const>(std::move(entry.val))
+            });
+        }
+
+        template <typename T>
+        void compile(T&& entry) {
+            compileCustom(std::forward<T>(entry));
+        }
+
+        template <typename T>
+        void compileCustom(T&& entry) {
+            using EntryT = std::remove_cvref_t<T>;
+            compiled().customPredicates.push_back(Detail::CompiledFilter::CustomPredicate{
+                [](void const *e, ILifecycleManager const &manager) noexcept {
+                    return static_cast<EntryT const *>(e)->matches(manager);
+                },
+                std::make_shared<EntryT const>(std::forward<T>(entry))
+            });
+        }
+
+        Detail::CompiledFilter& compiled() {
+            if(_compiled == nullptr) {
+                _compiled = std::make_shared<Detail::CompiledFilter>();
+            }
+            return *_compiled;
+        }
+
+        std::optional<uint64_t> _serviceId{};
+        std::shared_ptr<Detail::CompiledFilter> _compiled{}; // only modified during construction, shared by all copies afterwards
     };
+
+    namespace Detail {
+        inline const PropertyKey filterPropertyKey{"Filter"};
+    }
 }
@@ -0,0 +1,233 @@
+#pragma once
+
+#include <ichor/stl/Any.h>
+#include <algorithm>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace Ichor {
+
+    /// Property key interned to a small integer id. Interning happens once per distinct name, when the first key with that name is created.
+    /// Looking up a PropertyKey in Properties is a binary search on the id, without hashing or comparing strings.
+    /// Interned names are never freed. Only creating keys interns, looking up a name in Properties does not, so names that were never inserted do not grow the table.
+    class PropertyKey final {
+    public:
+        explicit PropertyKey(std::string_view name);
+
+        /// Thread-safe.
+        /// \param name
+        /// \return the key of name if a key with that name was created before, without interning it
+        [[nodiscard]] static std::optional<PropertyKey> findInterned(std::string_view name);
+
+        [[nodiscard]] uint32_t id() const noexcept {
+            return _id;
+        }
+
+        [[nodiscard]] std::string_view name() const noexcept {
+            return _name;
+        }
+
+        friend bool operator==(PropertyKey const &a, PropertyKey const &b) noexcept {
+            return a._id == b._id;
+        }
+
+        friend bool operator==(PropertyKey const &a, std::string_view b) noexcept {
+            return a._name == b;
+        }
+
+    private:
+        PropertyKey(std::string_view name, uint32_t id) noexcept : _name(name), _id(id) {}
+
+        std::string_view _name; // refers to the interned name
+        uint32_t _id;
+    };
+
+    namespace Detail {
+        using PropertyEntry = std::pair<PropertyKey, Ichor::any>;
+
+        /// Shared, never modified after construction. Entries are sorted by key id and shadow entries in base with the same key.
+        /// base never has a base itself, so lookups visit at most two flat arrays.
+        struct PropertiesNode final {
+            std::vector<PropertyEntry> entries{};
+            std::shared_ptr<PropertiesNode const> base{};
+        };
+
+        class PropertiesIterator final {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = PropertyEntry;
+            using difference_type = std::ptrdiff_t;
+            using pointer = PropertyEntry const *;
+            using reference = PropertyEntry const &;
+
+            PropertiesIterator() noexcept = default;
+            PropertiesIterator(PropertiesNode const *node, size_t idx) noexcept : _node(node), _idx(idx) {
+                skipShadowed();
+            }
+
+            reference operator*() const noexcept {
+                if(_idx < _node->entries.size()) {
+                    return _node->entries[_idx];
+                }
+                return _node->base->entries[_idx - _node->entries.size()];
+            }
+
+            pointer operator->() const noexcept {
+                return &**this;
+            }
+
+            PropertiesIterator& operator++() noexcept {
+                ++_idx;
+                skipShadowed();
+                return *this;
+            }
+
+            PropertiesIterator operator++(int) noexcept {
+                auto ret = *this;
+                ++*this;
+                return ret;
+            }
+
+            friend bool operator==(PropertiesIterator const &a, PropertiesIterator const &b) noexcept {
+                return a._idx == b._idx;
+            }
+
+        private:
+            void skipShadowed() noexcept;
+
+            PropertiesNode const *_node{};
+            size_t _idx{};
+        };
+    }
+
+    /// Immutable, reference counted set of properties with a sorted flat layout and interned keys.
+    /// Copying only increments a reference count, so services created from the same Properties share a single set.
+    /// Modifying a shared set (emplace, erase, operator[]) first copies it into a private one (copy-on-write), lookups never do.
+    /// with() derives a set containing one extra key that refers to the original set instead of copying it.
+    ///
+    /// Lookups are a binary search on the interned id of the key. Lookups by name look up the id of the name first, a PropertyKey already has it.
+    class Properties final {
+    public:
+        using key_type = PropertyKey;
+        using mapped_type = Ichor::any;
+        using value_type = Detail::PropertyEntry;
+        using size_type = size_t;
+        using iterator = Detail::PropertiesIterator;
+        using const_iterator = Detail::PropertiesIterator;
+
+        Properties() noexcept = default;
+        Properties(std::initializer_list<std::pair<std::string_view, Ichor::any>> entries);
+        Properties(const Properties&) noexcept = default;
+        Properties(Properties&&) noexcept = default;
+        Properties& operator=(const Properties&) noexcept = default;
+        Properties& operator=(Properties&&) noexcept = default;
+
+        [[nodiscard]] const_iterator begin() const noexcept {
+            return _node == nullptr ? const_iterator{} : const_iterator{_node.get(), 0};
+        }
+
+        [[nodiscard]] const_iterator end() const noexcept {
+            return _node == nullptr ? const_iterator{} : const_iterator{_node.get(), totalEntries()};
+        }
+
+        [[nodiscard]] const_iterator cbegin() const noexcept {
+            return begin();
+        }
+
+        [[nodiscard]] const_iterator cend() const noexcept {
+            return end();
+        }
+
+        [[nodiscard]] const_iterator find(PropertyKey const &key) const noexcept;
+        [[nodiscard]] const_iterator find(std::string_view key) const noexcept;
+
+        [[nodiscard]] bool contains(PropertyKey const &key) const noexcept {
+            return find(key) != end();
+        }
+
+        [[nodiscard]] bool contains(std::string_view key) const noexcept {
+            return find(key) != end();
+        }
+
+        [[nodiscard]] size_type size() const noexcept;
+
+        [[nodiscard]] bool empty() const noexcept {
+            return size() == 0;
+        }
+
+        /// Inserts the key with a value constructed from args, if the key is not present yet
+        /// \param key std::string_view or PropertyKey
+        /// \param args arguments to construct the Ichor::any with
+        /// \return iterator to the entry with this key, true if inserted
+        template <typename Key, typename... Args>
+        std::pair<const_iterator, bool> emplace(Key &&key, Args&&... args) {
+            auto [entry, inserted] = insertEntry(toPropertyKey(std::forward<Key>(key)));
+            if(inserted) {
+                entry->second = Ichor::any(std::forward<Args>(args)...);
+            }
+            return {find(entry->first), inserted};
+        }
+
+        /// Returns a mutable reference to the value of key, inserting an empty value if not present. Copies the set if it is shared.
+        Ichor::any& operator[](std::string_view key);
+        Ichor::any& operator[](PropertyKey const &key);
+
+        size_type erase(std::string_view key);
+
+        /// Derives a new set containing all entries of this set plus key, overriding an existing value for key.
+        /// The entries of this set are shared with the derived set rather than copied.
+        /// \param key key to add
+        /// \param value value to add
+        /// \return derived set
+        [[nodiscard]] Properties with(PropertyKey const &key, Ichor::any value) const;
+        [[nodiscard]] Properties with(std::string_view key, Ichor::any value) const {
+            return with(PropertyKey{key}, std::move(value));
+        }
+
+        /// \return true if both sets refer to the same underlying storage
+        [[nodiscard]] bool sharesStorageWith(Properties const &other) const noexcept {
+            return _node == other._node || (_node != nullptr && other._node != nullptr && _node->base != nullptr && (_node->base == other._node || _node->base == other._node->base));
+        }
+
+    private:
+        static PropertyKey toPropertyKey(PropertyKey const &key) noexcept {
+            return key;
+        }
+
+        static PropertyKey toPropertyKey(std::string_view key) {
+            return PropertyKey{key};
+        }
+
+        [[nodiscard]] size_t totalEntries() const noexcept {
+            return _node->entries.size() + (_node->base != nullptr ? _node->base->entries.size() : 0);
+        }
+
+        /// Makes sure _node is flat and not shared with anyone else, so that it can be modified.
+        std::vector<Detail::PropertyEntry>& detach();
+        std::pair<Detail::PropertyEntry*, bool> insertEntry(PropertyKey key);
+
+        std::shared_ptr<Detail::PropertiesNode> _node{};
+    };
+
+    inline Properties::const_iterator begin(Properties const &props) noexcept {
+        return props.begin();
+    }
+
+    inline Properties::const_iterator end(Properties const &props) noexcept {
+        return props.end();
+    }
+
+    inline Properties::const_iterator cbegin(Properties const &props) noexcept {
+        return props.cbegin();
+    }
+
+    inline Properties::const_iterator cend(Properties const &props) noexcept {
+        return props.cend();
+    }
+}
@@ -0,0 +1,287 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <coroutine>
+#include <optional>
+#include <vector>
+#include <ichor/coroutines/AsyncCrossThreadEvent.h>
+#include <ichor/coroutines/AsyncGenerator.h>
+
+namespace Ichor {
+    namespace Detail {
+        /// Coroutine suspended in an AsyncChannel or AsyncCrossThreadChannel. Lives inside the awaiting coroutine's frame.
+        template <typename T>
+        struct ChannelWaiter final {
+            RemoteResumption resumption{};
+            DependencyManager *dm{};
+            ChannelWaiter *next{};
+            T *sendValue{}; // sender: value to move into the channel
+            std::optional<T> *received{}; // receiver: slot to move a value into, left empty if the channel got closed
+            bool sent{}; // sender: false if the channel got closed before the value could be sent
+        };
+
+        /// Intrusive FIFO of ChannelWaiters
+        template <typename T>
+        class ChannelWaiterQueue final {
+        public:
+            [[nodiscard]] bool empty() const noexcept {
+                return _head == nullptr;
+            }
+
+            [[nodiscard]] ChannelWaiter<T>& front() const noexcept {
+                return *_head;
+            }
+
+            void push(ChannelWaiter<T> &waiter) noexcept {
+                waiter.next = nullptr;
+                if(_tail == nullptr) {
+                    _head = &waiter;
+                } else {
+                    _tail->next = &waiter;
+                }
+                _tail = &waiter;
+            }
+
+            ChannelWaiter<T>& pop() noexcept {
+                auto &waiter = *_head;
+                _head = waiter.next;
+                if(_head == nullptr) {
+                    _tail = nullptr;
+                }
+                return waiter;
+            }
+
+            /// Waiters are destroyed once resumed, so this should be called on a queue that was moved out of the channel's lock.
+            void resumeAll(uint64_t priority) noexcept {
+                while(_head != nullptr) {
+                    auto &waiter = pop();
+                    waiter.resumption.priority = priority;
+                    resumeOn(waiter.dm, waiter.resumption);
+                }
+            }
+
+        private:
+            ChannelWaiter<T> *_head{};
+            ChannelWaiter<T> *_tail{};
+        };
+    }
+
+    template <typename T>
+    class AsyncChannel;
+
+    template <typename T>
+    class AsyncChannelSendOperation final {
+    public:
+        AsyncChannelSendOperation(AsyncChannel<T> &channel, T &&value) noexcept(std::is_nothrow_move_constructible_v<T>) : _channel(channel), _value(std::move(value)) {}
+
+        bool await_ready();
+        bool await_suspend(std::coroutine_handle<> awaiter) noexcept;
+
+        /// \return false if the channel was closed and the value was not sent
+        bool await_resume() const noexcept {
+            return _waiter.sent;
+        }
+
+    private:
+        AsyncChannel<T> &_channel;
+        T _value;
+        Detail::ChannelWaiter<T> _waiter{};
+    };
+
+    template <typename T>
+    class AsyncChannelReceiveOperation final {
+    public:
+        explicit AsyncChannelReceiveOperation(AsyncChannel<T> &channel) noexcept : _channel(channel) {}
+
+        bool await_ready();
+        bool await_suspend(std::coroutine_handle<> awaiter) noexcept;
+
+        /// \return the received value, or nothing if the channel is closed and all values sent before closing have been received
+        std::optional<T> await_resume() noexcept(std::is_nothrow_move_constructible_v<T>) {
+            return std::move(_value);
+        }
+
+    private:
+        AsyncChannel<T> &_channel;
+        std::optional<T> _value{};
+        Detail::ChannelWaiter<T> _waiter{};
+    };
+
+    /// Bounded FIFO channel between coroutines of a single DependencyManager, e.g. to connect the stages of a pipeline.
+    /// co_await send(value) suspends while the channel is full, co_await receive() while it is empty, so a slow consumer
+    /// slows down the producer instead of letting a queue grow without bounds.
+    ///
+    /// Values are handed directly to waiting receivers and senders are served in the order they started waiting.
+    /// Woken coroutines are resumed from the ready queue of their manager, not inside the send or receive that woke them.
+    /// Use AsyncCrossThreadChannel to send values to coroutines on another thread.
+    template <typename T>
+    class AsyncChannel final {
+    public:
+        using value_type = T;
+
+        /// \param capacity maximum amount of values buffered in the channel, at least 1
+        /// \param priority priority with which woken coroutines are resumed, see Event::priority
+        explicit AsyncChannel(std::size_t capacity, uint64_t priority = INTERNAL_COROUTINE_EVENT_PRIORITY) : _buffer(capacity), _priority(priority) {
+            assert(capacity > 0);
+        }
+
+        ~AsyncChannel() {
+            // There should be no coroutines still waiting on the channel.
+            assert(_sendWaiters.empty());
+            assert(_receiveWaiters.empty());
+        }
+
+        AsyncChannel(const AsyncChannel&) = delete;
+        AsyncChannel(AsyncChannel&&) = delete;
+        AsyncChannel& operator=(const AsyncChannel&) = delete;
+        AsyncChannel& operator=(AsyncChannel&&) = delete;
+
+        /// Usage: bool sent = co_await channel.send(std::move(value));
+        /// \param value
+        /// \return operation resulting in false if the channel is closed
+        [[nodiscard]] AsyncChannelSendOperation<T> send(T value) noexcept(std::is_nothrow_move_constructible_v<T>) {
+            return AsyncChannelSendOperation<T>{*this, std::move(value)};
+        }
+
+        /// Usage: std::optional<T> value = co_await channel.receive();
+        /// \return operation resulting in nothing once the channel is closed and drained
+        [[nodiscard]] AsyncChannelReceiveOperation<T> receive() noexcept {
+            return AsyncChannelReceiveOperation<T>{*this};
+        }
+
+        /// \param value only moved from if sent
+        /// \return false if the channel is full or closed
+        [[nodiscard]] bool trySend(T &value) {
+            if(_closed) {
+                return false;
+            }
+
+            if(!_receiveWaiters.empty()) {
+                auto &waiter = _receiveWaiters.pop();
+                waiter.received->emplace(std::move(value));
+                resume(waiter);
+                return true;
+            }
+
+            if(_size == _buffer.size()) {
+                return false;
+            }
+
+            _buffer[(_head + _size) % _buffer.size()].emplace(std::move(value));
+            _size++;
+            return true;
+        }
+
+        /// \return nothing if the channel is empty
+        [[nodiscard]] std::optional<T> tryReceive() {
+            if(_size == 0) {
+                return {};
+            }
+
+            auto &slot = _buffer[_head];
+            std::optional<T> value{std::move(*slot)};
+            slot.reset();
+            _head = (_head + 1) % _buffer.size();
+            _size--;
+
+            if(!_sendWaiters.empty()) {
+                auto &waiter = _sendWaiters.pop();
+                _buffer[(_head + _size) % _buffer.size()].emplace(std::move(*waiter.sendValue));
+                _size++;
+                waiter.sent = true;
+                resume(waiter);
+            }
+
+            return value;
+        }
+
+        /// Closes the channel: pending and future sends fail, receivers get the values that were already sent and then nothing.
+        void close() noexcept {
+            if(_closed) {
+                return;
+            }
+            _closed = true;
+
+            auto sendWaiters = std::exchange(_sendWaiters, {});
+            auto receiveWaiters = std::exchange(_receiveWaiters, {});
+            sendWaiters.resumeAll(_priority);
+            receiveWaiters.resumeAll(_priority);
+        }
+
+        [[nodiscard]] bool isClosed() const noexcept {
+            return _closed;
+        }
+
+        /// \return amount of values buffered in the channel
+        [[nodiscard]] std::size_t size() const noexcept {
+            return _size;
+        }
+
+        [[nodiscard]] std::size_t capacity() const noexcept {
+            return _buffer.size();
+        }
+
+    private:
+        friend class AsyncChannelSendOperation<T>;
+        friend class AsyncChannelReceiveOperation<T>;
+
+        void resume(Detail::ChannelWaiter<T> &waiter) noexcept {
+            waiter.resumption.priority = _priority;
+            resumeOn(waiter.dm, waiter.resumption);
+        }
+
+        std::vector<std::optional<T>> _buffer;
+        std::size_t _head{};
+        std::size_t _size{};
+        uint64_t _priority;
+        bool _closed{};
+        Detail::ChannelWaiterQueue<T> _sendWaiters{};
+        Detail::ChannelWaiterQueue<T> _receiveWaiters{};
+    };
+
+    template <typename T>
+    bool AsyncChannelSendOperation<T>::await_ready() {
+        _waiter.sent = _channel.trySend(_value);
+        return _waiter.sent || _channel._closed;
+    }
+
+    template <typename T>
+    bool AsyncChannelSendOperation<T>::await_suspend(std::coroutine_handle<> awaiter) noexcept {
+        _waiter.resumption.awaiter = awaiter;
+        _waiter.dm = Detail::_local_dm;
+        _waiter.sendValue = &_value;
+        _channel._sendWaiters.push(_waiter);
+        return true;
+    }
+
+    template <typename T>
+    bool AsyncChannelReceiveOperation<T>::await_ready() {
+        _value = _channel.tryReceive();
+        return _value.has_value() || _channel._closed;
+    }
+
+    template <typename T>
+    bool AsyncChannelReceiveOperation<T>::await_suspend(std::coroutine_handle<> awaiter) noexcept {
+        _waiter.resumption.awaiter = awaiter;
+        _waiter.dm = Detail::_local_dm;
+        _waiter.received = &_value;
+        _channel._receiveWaiters.push(_waiter);
+        return true;
+    }
+
+    /// Adapts a channel to a generator, e.g. to hand it to code consuming generators.
+    /// Yields every received value and finally nothing, once the channel is closed and drained.
+    /// \tparam Channel AsyncChannel or AsyncCrossThreadChannel
+    /// \param channel has to outlive the generator
+    template <typename Channel>
+    AsyncGenerator<std::optional<typename Channel::value_type>> receiveAll(Channel &channel) {
+        while(true) {
+            auto value = co_await channel.receive();
+            if(!value) {
+                co_return std::optional<typename Channel::value_type>{};
+            }
+            co_yield std::move(value);
+        }
+    }
+}
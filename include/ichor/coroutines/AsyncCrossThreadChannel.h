@@ -0,0 +1,376 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <ichor/coroutines/AsyncChannel.h>
+#include <ichor/stl/RealtimeMutex.h>
+
+namespace Ichor {
+    namespace Detail {
+        /// Bounded lock-free multi-producer multi-consumer ring, after Dmitry Vyukov's bounded MPMC queue.
+        /// Each cell carries a sequence number telling producers and consumers whether it is theirs to use for the current lap.
+        template <typename T>
+        class MpmcRing final {
+        public:
+            explicit MpmcRing(std::size_t capacity) : _mask(std::bit_ceil(std::max<std::size_t>(capacity, 2)) - 1), _cells(std::make_unique<Cell[]>(_mask + 1)) {
+                for(std::size_t i = 0; i <= _mask; i++) {
+                    _cells[i].sequence.store(i, std::memory_order_relaxed);
+                }
+            }
+
+            ~MpmcRing() {
+                while(tryPop()) {
+                }
+            }
+
+            MpmcRing(const MpmcRing&) = delete;
+            MpmcRing(MpmcRing&&) = delete;
+            MpmcRing& operator=(const MpmcRing&) = delete;
+            MpmcRing& operator=(MpmcRing&&) = delete;
+
+            /// \param value only moved from if pushed
+            /// \return false if full
+            bool tryPush(T &value) noexcept(std::is_nothrow_move_constructible_v<T>) {
+                Cell *cell;
+                auto pos = _enqueuePos.load(std::memory_order_relaxed);
+                while(true) {
+                    cell = &_cells[pos & _mask];
+                    auto const seq = cell->sequence.load(std::memory_order_acquire);
+                    auto const diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+                    if(diff == 0) {
+                        if(_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                            break;
+                        }
+                    } else if(diff < 0) {
+                        return false;
+                    } else {
+                        pos = _enqueuePos.load(std::memory_order_relaxed);
+                    }
+                }
+
+                ::new (static_cast<void*>(cell->storage)) T(std::move(value));
+                cell->sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+
+            /// \return nothing if empty
+            std::optional<T> tryPop() noexcept(std::is_nothrow_move_constructible_v<T>) {
+                Cell *cell;
+                auto pos = _dequeuePos.load(std::memory_order_relaxed);
+                while(true) {
+                    cell = &_cells[pos & _mask];
+                    auto const seq = cell->sequence.load(std::memory_order_acquire);
+                    auto const diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+                    if(diff == 0) {
+                        if(_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                            break;
+                        }
+                    } else if(diff < 0) {
+                        return {};
+                    } else {
+                        pos = _dequeuePos.load(std::memory_order_relaxed);
+                    }
+                }
+
+                auto *value = std::launder(reinterpret_cast<T*>(cell->storage));
+                std::optional<T> ret{std::move(*value)};
+                value->~T();
+                cell->sequence.store(pos + _mask + 1, std::memory_order_release);
+                return ret;
+            }
+
+            [[nodiscard]] std::size_t capacity() const noexcept {
+                return _mask + 1;
+            }
+
+        private:
+            struct Cell final {
+                std::atomic<std::size_t> sequence;
+                alignas(T) std::byte storage[sizeof(T)];
+            };
+
+            std::size_t const _mask;
+            std::unique_ptr<Cell[]> _cells;
+            alignas(64) std::atomic<std::size_t> _enqueuePos{};
+            alignas(64) std::atomic<std::size_t> _dequeuePos{};
+        };
+    }
+
+    template <typename T>
+    class AsyncCrossThreadChannel;
+
+    template <typename T>
+    class AsyncCrossThreadChannelSendOperation final {
+    public:
+        AsyncCrossThreadChannelSendOperation(AsyncCrossThreadChannel<T> &channel, T &&value) noexcept(std::is_nothrow_move_constructible_v<T>) : _channel(channel), _value(std::move(value)) {}
+
+        bool await_ready() noexcept(std::is_nothrow_move_constructible_v<T>);
+        bool await_suspend(std::coroutine_handle<> awaiter) noexcept(std::is_nothrow_move_constructible_v<T>);
+
+        /// \return false if the channel was closed and the value was not sent
+        bool await_resume() const noexcept {
+            return _waiter.sent;
+        }
+
+    private:
+        AsyncCrossThreadChannel<T> &_channel;
+        T _value;
+        Detail::ChannelWaiter<T> _waiter{};
+    };
+
+    template <typename T>
+    class AsyncCrossThreadChannelReceiveOperation final {
+    public:
+        explicit AsyncCrossThreadChannelReceiveOperation(AsyncCrossThreadChannel<T> &channel) noexcept : _channel(channel) {}
+
+        bool await_ready() noexcept(std::is_nothrow_move_constructible_v<T>);
+        bool await_suspend(std::coroutine_handle<> awaiter) noexcept(std::is_nothrow_move_constructible_v<T>);
+
+        /// \return the received value, or nothing if the channel is closed and all values sent before closing have been received
+        std::optional<T> await_resume() noexcept(std::is_nothrow_move_constructible_v<T>) {
+            return std::move(_value);
+        }
+
+    private:
+        AsyncCrossThreadChannel<T> &_channel;
+        std::optional<T> _value{};
+        Detail::ChannelWaiter<T> _waiter{};
+    };
+
+    /// Bounded FIFO channel between coroutines on different threads, e.g. between services of different DependencyManagers.
+    /// Same interface and backpressure as AsyncChannel.
+    ///
+    /// Values go through a lock-free ring, so sending to a channel that is not full and receiving from one that is not empty
+    /// never takes a lock. Only coroutines that have to suspend, and whoever wakes them, take the waiter lock.
+    /// Woken coroutines are resumed from the ready queue of the manager they suspended on.
+    /// Contrary to AsyncChannel, values are not handed directly to suspended coroutines, so a woken coroutine
+    /// may lose its slot to a coroutine that did not have to suspend.
+    template <typename T>
+    class AsyncCrossThreadChannel final {
+    public:
+        using value_type = T;
+
+        /// \param capacity maximum amount of values buffered in the channel, rounded up to a power of two of at least 2
+        /// \param priority priority with which woken coroutines are resumed, see Event::priority
+        explicit AsyncCrossThreadChannel(std::size_t capacity, uint64_t priority = INTERNAL_COROUTINE_EVENT_PRIORITY) : _ring(capacity), _priority(priority) {
+            assert(capacity > 0);
+        }
+
+        ~AsyncCrossThreadChannel() {
+            // There should be no coroutines still waiting on the channel.
+            assert(_sendWaiters.empty());
+            assert(_receiveWaiters.empty());
+        }
+
+        AsyncCrossThreadChannel(const AsyncCrossThreadChannel&) = delete;
+        AsyncCrossThreadChannel(AsyncCrossThreadChannel&&) = delete;
+        AsyncCrossThreadChannel& operator=(const AsyncCrossThreadChannel&) = delete;
+        AsyncCrossThreadChannel& operator=(AsyncCrossThreadChannel&&) = delete;
+
+        /// Usage: bool sent = co_await channel.send(std::move(value));
+        /// Safe to call from any thread.
+        /// \param value
+        /// \return operation resulting in false if the channel is closed
+        [[nodiscard]] AsyncCrossThreadChannelSendOperation<T> send(T value) noexcept(std::is_nothrow_move_constructible_v<T>) {
+            return AsyncCrossThreadChannelSendOperation<T>{*this, std::move(value)};
+        }
+
+        /// Usage: std::optional<T> value = co_await channel.receive();
+        /// Safe to call from any thread.
+        /// \return operation resulting in nothing once the channel is closed and drained
+        [[nodiscard]] AsyncCrossThreadChannelReceiveOperation<T> receive() noexcept {
+            return AsyncCrossThreadChannelReceiveOperation<T>{*this};
+        }
+
+        /// Safe to call from any thread.
+        /// \param value only moved from if sent
+        /// \return false if the channel is full or closed
+        [[nodiscard]] bool trySend(T &value) noexcept(std::is_nothrow_move_constructible_v<T>) {
+            if(_closed.load(std::memory_order_acquire) || !_ring.tryPush(value)) {
+                return false;
+            }
+            wakeReceiver();
+            return true;
+        }
+
+        /// Safe to call from any thread.
+        /// \return nothing if the channel is empty
+        [[nodiscard]] std::optional<T> tryReceive() noexcept(std::is_nothrow_move_constructible_v<T>) {
+            auto value = _ring.tryPop();
+            if(value) {
+                wakeSender();
+            }
+            return value;
+        }
+
+        /// Closes the channel: pending and future sends fail, receivers get the values that were already sent and then nothing.
+        /// Safe to call from any thread.
+        void close() noexcept {
+            Detail::ChannelWaiterQueue<T> resumable{};
+            {
+                std::unique_lock const lg{_waiterLock};
+                if(_closed.exchange(true, std::memory_order_acq_rel)) {
+                    return;
+                }
+
+                while(!_sendWaiters.empty()) {
+                    _sendWaiterCount.fetch_sub(1, std::memory_order_relaxed);
+                    resumable.push(_sendWaiters.pop());
+                }
+
+                // receivers only wait on an empty ring, hand them what was sent concurrently before waking them empty handed
+                while(!_receiveWaiters.empty()) {
+                    auto &waiter = _receiveWaiters.pop();
+                    _receiveWaiterCount.fetch_sub(1, std::memory_order_relaxed);
+                    *waiter.received = _ring.tryPop();
+                    resumable.push(waiter);
+                }
+            }
+
+            resumable.resumeAll(_priority);
+        }
+
+        /// Safe to call from any thread.
+        [[nodiscard]] bool isClosed() const noexcept {
+            return _closed.load(std::memory_order_acquire);
+        }
+
+        [[nodiscard]] std::size_t capacity() const noexcept {
+            return _ring.capacity();
+        }
+
+    private:
+        friend class AsyncCrossThreadChannelSendOperation<T>;
+        friend class AsyncCrossThreadChannelReceiveOperation<T>;
+
+        // A suspending coroutine increments the waiter count and retries the ring with the waiter lock held, the other side
+        // checks the count after using the ring. Both separated by a full fence, so either the retry sees the change to the ring
+        // or the other side sees the count and takes the lock to wake the waiter.
+
+        void wakeReceiver() noexcept(std::is_nothrow_move_constructible_v<T>) {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if(_receiveWaiterCount.load(std::memory_order_relaxed) == 0) {
+                return;
+            }
+
+            Detail::ChannelWaiter<T> *waiter{};
+            {
+                std::unique_lock const lg{_waiterLock};
+                if(_receiveWaiters.empty()) {
+                    return;
+                }
+                auto value = _ring.tryPop();
+                if(!value) {
+                    // taken by a receiver that did not have to wait
+                    return;
+                }
+                waiter = &_receiveWaiters.pop();
+                _receiveWaiterCount.fetch_sub(1, std::memory_order_relaxed);
+                *waiter->received = std::move(value);
+            }
+
+            // popping made room for a waiting sender
+            wakeSender();
+            waiter->resumption.priority = _priority;
+            Detail::resumeOn(waiter->dm, waiter->resumption);
+        }
+
+        void wakeSender() noexcept(std::is_nothrow_move_constructible_v<T>) {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if(_sendWaiterCount.load(std::memory_order_relaxed) == 0) {
+                return;
+            }
+
+            Detail::ChannelWaiter<T> *waiter{};
+            {
+                std::unique_lock const lg{_waiterLock};
+                if(_sendWaiters.empty() || !_ring.tryPush(*_sendWaiters.front().sendValue)) {
+                    // slot taken by a sender that did not have to wait
+                    return;
+                }
+                waiter = &_sendWaiters.pop();
+                _sendWaiterCount.fetch_sub(1, std::memory_order_relaxed);
+                waiter->sent = true;
+            }
+
+            waiter->resumption.priority = _priority;
+            Detail::resumeOn(waiter->dm, waiter->resumption);
+            // pushing may have to wake a waiting receiver
+            wakeReceiver();
+        }
+
+        Detail::MpmcRing<T> _ring;
+        uint64_t _priority;
+        std::atomic<bool> _closed{};
+        std::atomic<uint64_t> _sendWaiterCount{};
+        std::atomic<uint64_t> _receiveWaiterCount{};
+        RealtimeMutex _waiterLock{};
+        Detail::ChannelWaiterQueue<T> _sendWaiters{};
+        Detail::ChannelWaiterQueue<T> _receiveWaiters{};
+    };
+
+    template <typename T>
+    bool AsyncCrossThreadChannelSendOperation<T>::await_ready() noexcept(std::is_nothrow_move_constructible_v<T>) {
+        _waiter.sent = _channel.trySend(_value);
+        return _waiter.sent || _channel.isClosed();
+    }
+
+    template <typename T>
+    bool AsyncCrossThreadChannelSendOperation<T>::await_suspend(std::coroutine_handle<> awaiter) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        {
+            std::unique_lock const lg{_channel._waiterLock};
+            if(!_channel._closed.load(std::memory_order_acquire)) {
+                _channel._sendWaiterCount.fetch_add(1, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if(!_channel._ring.tryPush(_value)) {
+                    _waiter.resumption.awaiter = awaiter;
+                    _waiter.dm = Detail::_local_dm;
+                    _waiter.sendValue = &_value;
+                    _channel._sendWaiters.push(_waiter);
+                    return true;
+                }
+                _channel._sendWaiterCount.fetch_sub(1, std::memory_order_relaxed);
+                _waiter.sent = true;
+            }
+        }
+
+        if(_waiter.sent) {
+            _channel.wakeReceiver();
+        }
+        return false;
+    }
+
+    template <typename T>
+    bool AsyncCrossThreadChannelReceiveOperation<T>::await_ready() noexcept(std::is_nothrow_move_constructible_v<T>) {
+        _value = _channel.tryReceive();
+        return _value.has_value();
+    }
+
+    template <typename T>
+    bool AsyncCrossThreadChannelReceiveOperation<T>::await_suspend(std::coroutine_handle<> awaiter) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        {
+            std::unique_lock const lg{_channel._waiterLock};
+            _channel._receiveWaiterCount.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            _value = _channel._ring.tryPop();
+            if(!_value && !_channel._closed.load(std::memory_order_acquire)) {
+                _waiter.resumption.awaiter = awaiter;
+                _waiter.dm = Detail::_local_dm;
+                _waiter.received = &_value;
+                _channel._receiveWaiters.push(_waiter);
+                return true;
+            }
+            _channel._receiveWaiterCount.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        if(_value) {
+            _channel.wakeSender();
+        }
+        return false;
+    }
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <coroutine>
+#include <ichor/events/Event.h>
+
+namespace Ichor {
+    class DependencyManager;
+    class AsyncCrossThreadEventOperation;
+
+    namespace Detail {
+        /// Intrusive node in the cross-thread resume stack of a DependencyManager, lives inside the awaiting coroutine's frame
+        struct RemoteResumption final {
+            std::coroutine_handle<> awaiter;
+            RemoteResumption *next;
+            uint64_t priority;
+        };
+
+        /// Resumes resumption.awaiter from the ready queue of dm, or inside this call if dm is nullptr, i.e. when the coroutine
+        /// suspended on a thread without a DependencyManager. Safe to call from any thread.
+        /// The resumption may be destroyed as soon as it has been handed over, so it is not touched after that.
+        void resumeOn(DependencyManager *dm, RemoteResumption &resumption) noexcept;
+    }
+
+    /// Manual-reset event that can be set from any thread, e.g. from a boost.asio or hiredis completion handler.
+    ///
+    /// Contrary to AsyncManualResetEvent, awaiting coroutines are not resumed inside set(). Each awaiter is handed
+    /// to the DependencyManager of the thread it suspended on and resumed from that manager's ready queue.
+    /// Handing over is lock-free and does not allocate, a ResumeCoroutinesEvent is only pushed when the manager
+    /// has no pending cross-thread resumptions at the same or a more urgent priority yet.
+    ///
+    /// Coroutines awaiting this event on a thread without a DependencyManager are resumed inside set().
+    class AsyncCrossThreadEvent final {
+    public:
+        /// \param priority priority with which set() resumes awaiting coroutines, see Event::priority
+        /// \param initiallySet
+        explicit AsyncCrossThreadEvent(uint64_t priority = INTERNAL_COROUTINE_EVENT_PRIORITY, bool initiallySet = false) noexcept;
+        ~AsyncCrossThreadEvent();
+
+        AsyncCrossThreadEvent(const AsyncCrossThreadEvent&) = delete;
+        AsyncCrossThreadEvent(AsyncCrossThreadEvent&&) = delete;
+        AsyncCrossThreadEvent& operator=(const AsyncCrossThreadEvent&) = delete;
+        AsyncCrossThreadEvent& operator=(AsyncCrossThreadEvent&&) = delete;
+
+        /// Wait for the event to enter the 'set' state. Continues without suspending if it already is.
+        AsyncCrossThreadEventOperation operator co_await() const noexcept;
+
+        /// Query if the event is currently in the 'set' state. Safe to call from any thread.
+        [[nodiscard]] bool is_set() const noexcept;
+
+        /// Set the state of the event to 'set' and schedule all awaiting coroutines on their manager. Safe to call from any thread.
+        ///
+        /// The event may be destroyed by a resumed coroutine as soon as the first awaiter has been handed over,
+        /// so the event is not touched after that.
+        void set() noexcept;
+        /// As set(), but resumes the awaiting coroutines with the given priority instead of the one the event was constructed with
+        /// \param priority
+        void set(uint64_t priority) noexcept;
+
+        /// Set the state of the event to 'not set'. No-op if the event is not set.
+        void reset() noexcept;
+
+    private:
+        friend class AsyncCrossThreadEventOperation;
+
+        // This variable has 3 states:
+        // - this    - The state is 'set'.
+        // - nullptr - The state is 'not set' with no waiters.
+        // - other   - The state is 'not set'.
+        //             Points to an 'AsyncCrossThreadEventOperation' that is
+        //             the head of a linked-list of waiters.
+        mutable std::atomic<void*> _state;
+        uint64_t _priority;
+    };
+
+    class AsyncCrossThreadEventOperation final {
+    public:
+        explicit AsyncCrossThreadEventOperation(const AsyncCrossThreadEvent& event) noexcept;
+
+        bool await_ready() const noexcept;
+        bool await_suspend(std::coroutine_handle<> awaiter) noexcept;
+        void await_resume() const noexcept {}
+
+    private:
+        friend class AsyncCrossThreadEvent;
+
+        const AsyncCrossThreadEvent& _event;
+        AsyncCrossThreadEventOperation* _next{};
+        DependencyManager *_dm{};
+        Detail::RemoteResumption _resumption{};
+    };
+}
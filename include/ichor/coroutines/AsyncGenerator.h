@@ -51,48 +51,21 @@ namespace Ichor {
                 return _initialState == state::value_ready_producer_suspended;
             }
 
+            /// The producer is suspended elsewhere, e.g. on an event, and will transfer back to the consumer when it yields.
             bool await_suspend(std::coroutine_handle<> consumerCoroutine) noexcept {
                 INTERNAL_COROUTINE_DEBUG("AsyncGeneratorAdvanceOperation::await_suspend {} {}", _promise->_id, _promise->finished());
                 _promise->_consumerCoroutine = consumerCoroutine;
-                if(!_promise->_hasSuspended.has_value()) {
-                    _promise->_hasSuspended = false;
-                }
-
-                auto currentState = _initialState;
-                if (currentState == state::value_ready_producer_active) {
-                    if (_promise->_state == currentState) {
-                        _promise->_state = state::value_not_ready_consumer_suspended;
-                        if(!_promise->finished()) {
-                            _promise->_hasSuspended = true;
-                        }
-                        INTERNAL_COROUTINE_DEBUG("AsyncGeneratorAdvanceOperation::await_suspend1");
-                        return true;
-                    }
-                    currentState = _promise->_state;
-
-                    assert(currentState == state::value_ready_producer_suspended);
-
-                    _promise->_state = state::value_not_ready_consumer_active;
-
-                    _producerCoroutine.resume();
-
-                    currentState = _promise->_state;
-                    if (currentState == state::value_ready_producer_suspended) {
-                        // Producer coroutine produced a value synchronously.
-                        INTERNAL_COROUTINE_DEBUG("AsyncGeneratorAdvanceOperation::await_suspend2");
-                        return false;
-                    }
-                }
+                _promise->mark_engaged();
 
-                assert(currentState == state::value_not_ready_consumer_active);
+                assert(_initialState == state::value_not_ready_consumer_active);
 
-                if(_promise->_state == currentState) {
+                if(_promise->_state == _initialState) {
                     _promise->_state = state::value_not_ready_consumer_suspended;
-                    _promise->_hasSuspended = true;
-                    INTERNAL_COROUTINE_DEBUG("AsyncGeneratorAdvanceOperation::await_suspend3");
+                    _promise->mark_suspended();
+                    INTERNAL_COROUTINE_DEBUG("AsyncGeneratorAdvanceOperation::await_suspend1");
                     return true;
                 }
-                INTERNAL_COROUTINE_DEBUG("AsyncGeneratorAdvanceOperation::await_suspend4");
+                INTERNAL_COROUTINE_DEBUG("AsyncGeneratorAdvanceOperation::await_suspend2");
                 return false;
             }
 
@@ -209,7 +182,7 @@ namespace Ichor {
             /// suspended is in an un-set state and is considered as suspended.
             /// \return true if suspended or never engaged
             [[nodiscard]] bool get_has_suspended() const noexcept final {
-                return _promise != nullptr && (!_promise->_hasSuspended.has_value() || *_promise->_hasSuspended);
+                return _promise != nullptr && _promise->may_have_suspended();
             }
 
             [[nodiscard]] state get_op_state() const noexcept final {
@@ -254,64 +227,46 @@ namespace Ichor {
             }
         };
 
-        inline bool AsyncGeneratorYieldOperation::await_suspend(std::coroutine_handle<> producer) noexcept {
+        inline std::coroutine_handle<> AsyncGeneratorYieldOperation::await_suspend(std::coroutine_handle<> producer) noexcept {
             INTERNAL_COROUTINE_DEBUG("AsyncGeneratorYieldOperation::await_suspend {} {}", _promise._id, _promise.finished());
-            state currentState = _initialState;
-            if(!_promise._hasSuspended.has_value()) {
-                _promise._hasSuspended = false;
+            _promise.mark_engaged();
+
+            if (_initialState == state::value_not_ready_consumer_suspended) {
+                // The consumer is waiting for this value. Instead of resuming it on top of the producer's stack,
+                // suspend the producer and transfer to the consumer, so that long chains of generators
+                // run in constant stack space. The consumer resumes the producer when it wants the next value.
+                _promise._state = state::value_ready_producer_suspended;
+                _promise.mark_suspended();
+                INTERNAL_COROUTINE_DEBUG("AsyncGeneratorYieldOperation::await_suspend1");
+                return _promise._consumerCoroutine;
             }
 
-            if (currentState == state::value_not_ready_consumer_active) {
-                bool producerSuspended{};
-                if(_promise._state == currentState) {
-                    _promise._state = state::value_ready_producer_suspended;
-                    producerSuspended = true;
-                }
-                if (producerSuspended) {
-                    INTERNAL_COROUTINE_DEBUG("AsyncGeneratorYieldOperation::await_suspend1");
-                    if(!_promise.finished()) {
-                        _promise._hasSuspended = true;
-                    }
-                    return true;
+            if (_initialState == state::value_not_ready_consumer_active) {
+                // The consumer is not waiting, f.e. because the DependencyManager started us, it will pick up the value later.
+                _promise._state = state::value_ready_producer_suspended;
+                if(!_promise.finished()) {
+                    _promise.mark_suspended();
                 }
-
-                std::terminate();
+                INTERNAL_COROUTINE_DEBUG("AsyncGeneratorYieldOperation::await_suspend2");
+                return std::noop_coroutine();
             }
 
-            // By this point the consumer has been resumed if required and is now active.
-
-            if (currentState == state::value_ready_producer_active) {
-                // Try to suspend the producer.
-                // If we failed to suspend then it's either because the consumer destructed, transitioning
-                // the state to cancelled, or requested the next item, transitioning the state to value_not_ready_consumer_suspended.
-                bool suspendedProducer{};
-                if(_promise._state == currentState) {
-                    _promise._state = state::value_ready_producer_suspended;
-                    suspendedProducer = true;
-                }
-                if (suspendedProducer) {
-                    _promise._hasSuspended = true;
-                    INTERNAL_COROUTINE_DEBUG("AsyncGeneratorYieldOperation::await_suspend3");
-                    return true;
-                }
-
+            if (_initialState != state::cancelled) [[unlikely]] {
                 std::terminate();
             }
 
-            assert(currentState == state::cancelled);
-
             // async_generator object has been destroyed and we're now at a
             // co_yield/co_return suspension point so we can just destroy
             // the coroutine.
             producer.destroy();
 
-            INTERNAL_COROUTINE_DEBUG("AsyncGeneratorYieldOperation::await_suspend5");
-            return true;
+            INTERNAL_COROUTINE_DEBUG("AsyncGeneratorYieldOperation::await_suspend3");
+            return std::noop_coroutine();
         }
 
         inline AsyncGeneratorYieldOperation AsyncGeneratorPromiseBase::final_suspend() noexcept {
             INTERNAL_COROUTINE_DEBUG("AsyncGeneratorPromiseBase::final_suspend {}", _id);
-            set_finished();
+            _finished = true;
             return internal_yield_value();
         }
 
@@ -319,18 +274,6 @@ namespace Ichor {
             assert(_state != state::value_ready_producer_active);
             assert(_state != state::value_ready_producer_suspended);
 
-            if (_state == state::value_not_ready_consumer_suspended) {
-                _state = state::value_ready_producer_active;
-
-                // Resume the consumer.
-                // It might ask for another value before returning, in which case it'll
-                // transition to value_not_ready_consumer_suspended and we can return from
-                // yield_value without suspending, otherwise we should try to suspend
-                // the producer in which case the consumer will wake us up again
-                // when it wants the next value.
-                _consumerCoroutine.resume();
-            }
-
             return AsyncGeneratorYieldOperation{ *this, _state };
         }
     }
@@ -359,7 +302,7 @@ namespace Ichor {
             other._coroutine = nullptr;
             if(_coroutine != nullptr) {
                 // Assume we're moving because an iterator has not finished and has suspended
-                _coroutine.promise()._hasSuspended = true;
+                _coroutine.promise().mark_suspended();
             }
         }
 
@@ -379,7 +322,7 @@ namespace Ichor {
             swap(temp);
             if(_coroutine != nullptr) {
                 // Assume we're moving because an iterator has not finished and has suspended
-                _coroutine.promise()._hasSuspended = true;
+                _coroutine.promise().mark_suspended();
             }
             return *this;
         }
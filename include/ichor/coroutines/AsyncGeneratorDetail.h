@@ -20,7 +20,7 @@ namespace Ichor::Detail {
         }
 #endif
 
-        Ichor::Detail::_local_dm->getEventQueue().pushPrioritisedEvent<Ichor::ContinuableEvent>(0u, INTERNAL_DEPENDENCY_EVENT_PRIORITY, _id);
+        Ichor::Detail::_local_dm->scheduleContinuation(_id, 0u, INTERNAL_DEPENDENCY_EVENT_PRIORITY);
 
         INTERNAL_COROUTINE_DEBUG("yield_value<{}>(&) {} {}", typeName<T>(), _id, !!_consumerCoroutine);
         _currentValue.emplace(std::move(value));
@@ -39,7 +39,7 @@ namespace Ichor::Detail {
         }
 #endif
 
-        Ichor::Detail::_local_dm->getEventQueue().pushPrioritisedEvent<Ichor::ContinuableEvent>(0u, INTERNAL_DEPENDENCY_EVENT_PRIORITY, _id);
+        Ichor::Detail::_local_dm->scheduleContinuation(_id, 0u, INTERNAL_DEPENDENCY_EVENT_PRIORITY);
 
         INTERNAL_COROUTINE_DEBUG("yield_value<{}>(&&) {} {}", typeName<T>(), _id, !!_consumerCoroutine);
         _currentValue.emplace(std::forward<T>(value));
@@ -58,15 +58,15 @@ namespace Ichor::Detail {
 #endif
 
         if constexpr(std::is_same_v<T, StartBehaviour>) {
-            if(_hasSuspended.has_value() && *_hasSuspended) {
+            if(has_suspended()) {
                 auto evtId = Ichor::Detail::_local_dm->getEventQueue().pushPrioritisedEvent<Ichor::ContinuableStartEvent>(0u, INTERNAL_COROUTINE_EVENT_PRIORITY, _id);
                 INTERNAL_COROUTINE_DEBUG("push continuable {} {}", _id, evtId);
             }
         }
         if constexpr(std::is_same_v<T, IchorBehaviour>) {
-            if(_hasSuspended.has_value() && *_hasSuspended) {
-                auto evtId = Ichor::Detail::_local_dm->getEventQueue().pushPrioritisedEvent<Ichor::ContinuableEvent>(0u, INTERNAL_COROUTINE_EVENT_PRIORITY, _id);
-                INTERNAL_COROUTINE_DEBUG("push {} {}", _id, evtId);
+            if(has_suspended()) {
+                Ichor::Detail::_local_dm->scheduleContinuation(_id, 0u, INTERNAL_COROUTINE_EVENT_PRIORITY);
+                INTERNAL_COROUTINE_DEBUG("schedule {}", _id);
             }
         }
 
@@ -86,15 +86,15 @@ namespace Ichor::Detail {
 #endif
 
         if constexpr(std::is_same_v<T, StartBehaviour>) {
-            if(_hasSuspended.has_value() && *_hasSuspended) {
+            if(has_suspended()) {
                 auto evtId = Ichor::Detail::_local_dm->getEventQueue().pushPrioritisedEvent<Ichor::ContinuableStartEvent>(0u, INTERNAL_COROUTINE_EVENT_PRIORITY, _id);
                 INTERNAL_COROUTINE_DEBUG("push continuable {} {}", _id, evtId);
             }
         }
         if constexpr(std::is_same_v<T, IchorBehaviour>) {
-            if(_hasSuspended.has_value() && *_hasSuspended) {
-                auto evtId = Ichor::Detail::_local_dm->getEventQueue().pushPrioritisedEvent<Ichor::ContinuableEvent>(0u, INTERNAL_COROUTINE_EVENT_PRIORITY, _id);
-                INTERNAL_COROUTINE_DEBUG("push {}", _id, evtId);
+            if(has_suspended()) {
+                Ichor::Detail::_local_dm->scheduleContinuation(_id, 0u, INTERNAL_COROUTINE_EVENT_PRIORITY);
+                INTERNAL_COROUTINE_DEBUG("schedule {}", _id);
             }
         }
 
@@ -15,6 +15,7 @@
 #include <utility>
 #include <ichor/Enums.h>
 #include <ichor/Common.h>
+#include <ichor/coroutines/CoroutineFramePool.h>
 
 namespace Ichor {
     template<typename T>
@@ -33,18 +34,25 @@ namespace Ichor::Detail {
     class AsyncGeneratorYieldOperation;
     class AsyncGeneratorAdvanceOperation;
 
+    /// Whether a generator has suspended since it was started, see IAsyncGeneratorBeginOperation::get_has_suspended()
+    enum class suspension : uint8_t {
+        unknown,
+        not_suspended,
+        suspended
+    };
+
     class AsyncGeneratorPromiseBase {
     public:
         AsyncGeneratorPromiseBase() noexcept
-                : _state(state::value_ready_producer_suspended)
-                , _exception(nullptr)
+                : _exception(nullptr)
                 , _id(_idCounter++)
         {
             // Other variables left intentionally uninitialised as they're
             // only referenced in certain states by which time they should
             // have been initialised.
         }
-        virtual ~AsyncGeneratorPromiseBase() = default;
+
+        ICHOR_COROUTINE_FRAME_ALLOCATOR
 
         AsyncGeneratorPromiseBase(const AsyncGeneratorPromiseBase& other) = delete;
         AsyncGeneratorPromiseBase& operator=(const AsyncGeneratorPromiseBase& other) = delete;
@@ -71,9 +79,9 @@ namespace Ichor::Detail {
         ///
         /// Only valid to call after resuming from an awaited advance operation.
         /// i.e. Either a begin() or iterator::operator++() operation.
-        [[nodiscard]] virtual bool finished() const noexcept = 0;
-
-        virtual void set_finished() noexcept = 0;
+        [[nodiscard]] bool finished() const noexcept {
+            return _finished;
+        }
 
         void rethrow_if_unhandled_exception() {
             if (_exception)
@@ -110,23 +118,48 @@ namespace Ichor::Detail {
             return _id;
         }
 
+        /// Called whenever the consumer or producer reaches a point where it may suspend
+        void mark_engaged() noexcept {
+            if(_suspension == suspension::unknown) {
+                _suspension = suspension::not_suspended;
+            }
+        }
+
+        void mark_suspended() noexcept {
+            _suspension = suspension::suspended;
+        }
+
+        [[nodiscard]] bool has_suspended() const noexcept {
+            return _suspension == suspension::suspended;
+        }
+
+        /// \return true if suspended or never engaged
+        [[nodiscard]] bool may_have_suspended() const noexcept {
+            return _suspension != suspension::not_suspended;
+        }
+
     protected:
+        // Not virtual: promises are only destroyed through their coroutine frame, which knows the derived type.
+        ~AsyncGeneratorPromiseBase() = default;
+
         AsyncGeneratorYieldOperation internal_yield_value() noexcept;
 
     public:
         friend class AsyncGeneratorYieldOperation;
         friend class AsyncGeneratorAdvanceOperation;
 
-        // Ichor forces everything to be on the same thread (or terminates the program)
-        // Therefore, we don't need atomic state, like is used in cppcoro
-        state _state;
         std::exception_ptr _exception;
         std::coroutine_handle<> _consumerCoroutine;
+        // key with which the DependencyManager tracks and continues this coroutine
         uint64_t _id;
 #ifdef ICHOR_USE_HARDENING
         DependencyManager *_dmAtTimeOfCreation{_local_dm};
 #endif
-        std::optional<bool> _hasSuspended{};
+        // Ichor forces everything to be on the same thread (or terminates the program)
+        // Therefore, we don't need atomic state, like is used in cppcoro
+        state _state{state::value_ready_producer_suspended};
+        suspension _suspension{suspension::unknown};
+        bool _finished{};
 
     private:
         static thread_local uint64_t _idCounter;
@@ -145,10 +178,13 @@ namespace Ichor::Detail {
 
         bool await_ready() const noexcept {
             INTERNAL_COROUTINE_DEBUG("AsyncGeneratorYieldOperation::await_ready {} {}", _initialState, _promise._id);
-            return _initialState == state::value_not_ready_consumer_suspended;
+            return false;
         }
 
-        bool await_suspend(std::coroutine_handle<> producer) noexcept;
+        /// Suspends the producer and, if the consumer is waiting for this value, transfers execution to it.
+        /// \param producer
+        /// \return coroutine to continue with
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> producer) noexcept;
 
         void await_resume() noexcept {
         }
@@ -167,7 +203,7 @@ namespace Ichor::Detail {
         AsyncGeneratorPromise() noexcept : _destroyed(new bool(false)) {
 
         }
-        ~AsyncGeneratorPromise() final {
+        ~AsyncGeneratorPromise() {
             *_destroyed = true;
         };
 
@@ -175,6 +211,21 @@ namespace Ichor::Detail {
             return AsyncGenerator<T>{ *this };
         }
 
+        AsyncGeneratorYieldOperation final_suspend() noexcept {
+            INTERNAL_COROUTINE_DEBUG("set_finished {} {}", _id, typeName<T>());
+
+#ifdef ICHOR_USE_HARDENING
+            if(!_currentValue) [[unlikely]] {
+                if(_exception) {
+                    std::rethrow_exception(std::move(_exception));
+                } else {
+                    std::terminate();
+                }
+            }
+#endif
+            return AsyncGeneratorPromiseBase::final_suspend();
+        }
+
         template <typename U = T> requires(!std::is_same_v<U, StartBehaviour>)
         AsyncGeneratorYieldOperation yield_value(value_type& value) noexcept(std::is_nothrow_constructible_v<T, T&&>);
 
@@ -189,32 +240,12 @@ namespace Ichor::Detail {
             return _currentValue.value();
         }
 
-        [[nodiscard]] bool finished() const noexcept final {
-            return _finished;
-        }
-
         std::shared_ptr<bool>& get_destroyed() noexcept  {
             return _destroyed;
         }
 
     private:
-        void set_finished() noexcept final {
-            INTERNAL_COROUTINE_DEBUG("set_finished {} {}", _id, typeName<T>());
-
-#ifdef ICHOR_USE_HARDENING
-            if(!_currentValue) [[unlikely]] {
-                if(_exception) {
-                    std::rethrow_exception(std::move(_exception));
-                } else {
-                    std::terminate();
-                }
-            }
-#endif
-            _finished = true;
-        }
-
         std::optional<T> _currentValue{};
-        bool _finished{};
         std::shared_ptr<bool> _destroyed;
     };
 
@@ -225,7 +256,7 @@ namespace Ichor::Detail {
         AsyncGeneratorPromise() noexcept : _destroyed(new bool(false)) {
 
         }
-        ~AsyncGeneratorPromise() final {
+        ~AsyncGeneratorPromise() {
             *_destroyed = true;
         };
 
@@ -235,21 +266,11 @@ namespace Ichor::Detail {
 
         void return_void() noexcept;
 
-        [[nodiscard]] bool finished() const noexcept final {
-            return _finished;
-        }
-
         std::shared_ptr<bool>& get_destroyed() noexcept  {
             return _destroyed;
         }
 
     private:
-        void set_finished() noexcept final {
-            INTERNAL_COROUTINE_DEBUG("set_finished {}", _id);
-            _finished = true;
-        }
-
-        bool _finished{};
         std::shared_ptr<bool> _destroyed;
     };
 }
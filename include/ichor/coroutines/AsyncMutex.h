@@ -0,0 +1,109 @@
+#pragma once
+
+#include <ichor/coroutines/AsyncSemaphore.h>
+#include <optional>
+#include <utility>
+
+namespace Ichor {
+    template <typename Lock>
+    class BasicAsyncMutex;
+
+    /// Owns a locked BasicAsyncMutex and unlocks it when destroyed
+    template <typename Lock>
+    class [[nodiscard]] BasicAsyncMutexLock final {
+    public:
+        explicit BasicAsyncMutexLock(BasicAsyncMutex<Lock> &mutex) noexcept : _mutex(&mutex) {}
+        BasicAsyncMutexLock(BasicAsyncMutexLock &&o) noexcept : _mutex(std::exchange(o._mutex, nullptr)) {}
+        BasicAsyncMutexLock& operator=(BasicAsyncMutexLock &&o) noexcept {
+            if(this != &o) {
+                unlock();
+                _mutex = std::exchange(o._mutex, nullptr);
+            }
+            return *this;
+        }
+        BasicAsyncMutexLock(const BasicAsyncMutexLock&) = delete;
+        BasicAsyncMutexLock& operator=(const BasicAsyncMutexLock&) = delete;
+
+        ~BasicAsyncMutexLock() {
+            unlock();
+        }
+
+        /// Unlocks the mutex before this lock gets destroyed. No-op if already unlocked.
+        void unlock() noexcept {
+            if(_mutex != nullptr) {
+                std::exchange(_mutex, nullptr)->unlock();
+            }
+        }
+
+    private:
+        BasicAsyncMutex<Lock> *_mutex;
+    };
+
+    template <typename Lock>
+    class BasicAsyncMutexLockOperation final {
+    public:
+        explicit BasicAsyncMutexLockOperation(BasicAsyncMutex<Lock> &mutex, BasicAsyncSemaphore<Lock> &semaphore) noexcept : _mutex(mutex), _acquire(semaphore.acquire()) {}
+
+        bool await_ready() const noexcept {
+            return _acquire.await_ready();
+        }
+
+        bool await_suspend(std::coroutine_handle<> awaiter) noexcept {
+            return _acquire.await_suspend(awaiter);
+        }
+
+        BasicAsyncMutexLock<Lock> await_resume() const noexcept {
+            return BasicAsyncMutexLock<Lock>{_mutex};
+        }
+
+    private:
+        BasicAsyncMutex<Lock> &_mutex;
+        BasicAsyncSemaphoreOperation<Lock> _acquire;
+    };
+
+    /// Mutex that suspends awaiting coroutines instead of blocking the thread, e.g. to serialise access to protocol state
+    /// across a co_await. Same fairness and resumption behaviour as BasicAsyncSemaphore, of which it is a thin wrapper.
+    ///
+    /// Usage:
+    /// auto lock = co_await _mutex.lock();
+    /// co_await _connection->sendAsync(...);
+    ///
+    /// Use AsyncMutex within a single DependencyManager and AsyncCrossThreadMutex to share it between threads.
+    template <typename Lock>
+    class BasicAsyncMutex final {
+    public:
+        /// \param priority priority with which waiters are resumed, see Event::priority
+        explicit BasicAsyncMutex(uint64_t priority = INTERNAL_COROUTINE_EVENT_PRIORITY) noexcept : _semaphore(1, priority) {}
+
+        /// \return operation resulting in a BasicAsyncMutexLock that unlocks the mutex when destroyed
+        [[nodiscard]] BasicAsyncMutexLockOperation<Lock> lock() noexcept {
+            return BasicAsyncMutexLockOperation<Lock>{*this, _semaphore};
+        }
+
+        /// \return the lock if the mutex was not locked and nobody was waiting for it
+        [[nodiscard]] std::optional<BasicAsyncMutexLock<Lock>> tryLock() noexcept {
+            if(!_semaphore.tryAcquire()) {
+                return {};
+            }
+            return BasicAsyncMutexLock<Lock>{*this};
+        }
+
+        [[nodiscard]] bool isLocked() const noexcept {
+            return _semaphore.available() == 0;
+        }
+
+    private:
+        friend class BasicAsyncMutexLock<Lock>;
+
+        void unlock() noexcept {
+            _semaphore.release();
+        }
+
+        BasicAsyncSemaphore<Lock> _semaphore;
+    };
+
+    using AsyncMutex = BasicAsyncMutex<Detail::SingleThreadLock>;
+    using AsyncMutexLock = BasicAsyncMutexLock<Detail::SingleThreadLock>;
+    using AsyncCrossThreadMutex = BasicAsyncMutex<RealtimeMutex>;
+    using AsyncCrossThreadMutexLock = BasicAsyncMutexLock<RealtimeMutex>;
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <cstdint>
+#include <coroutine>
+#include <ichor/coroutines/AsyncCrossThreadEvent.h>
+#include <ichor/stl/RealtimeMutex.h>
+
+namespace Ichor {
+    namespace Detail {
+        /// Lock of the primitives that may only be used from the thread of a single DependencyManager.
+        /// Does nothing, apart from terminating under ICHOR_USE_HARDENING when used from a second manager's thread.
+        class SingleThreadLock final {
+        public:
+            void lock() noexcept;
+            void unlock() noexcept {}
+
+        private:
+#ifdef ICHOR_USE_HARDENING
+            DependencyManager *_dm{};
+#endif
+        };
+
+        /// Coroutine waiting for permits of an AsyncSemaphore or tokens of an AsyncRateLimiter. Lives inside the awaiting coroutine's frame.
+        struct AsyncWaiter final {
+            RemoteResumption resumption{};
+            DependencyManager *dm{};
+            AsyncWaiter *next{};
+            uint64_t count{};
+        };
+
+        /// Intrusive FIFO of AsyncWaiters
+        class AsyncWaiterQueue final {
+        public:
+            [[nodiscard]] bool empty() const noexcept {
+                return _head == nullptr;
+            }
+
+            [[nodiscard]] AsyncWaiter& front() const noexcept {
+                return *_head;
+            }
+
+            void push(AsyncWaiter &waiter) noexcept {
+                waiter.next = nullptr;
+                if(_tail == nullptr) {
+                    _head = &waiter;
+                } else {
+                    _tail->next = &waiter;
+                }
+                _tail = &waiter;
+            }
+
+            AsyncWaiter& pop() noexcept {
+                auto &waiter = *_head;
+                _head = waiter.next;
+                if(_head == nullptr) {
+                    _tail = nullptr;
+                }
+                return waiter;
+            }
+
+            /// Resumes all waiters in the queue on their manager, with the given priority.
+            /// Waiters are destroyed once resumed, so this should be called on a queue that was moved out of the primitive's lock.
+            void resumeAll(uint64_t priority) noexcept {
+                while(_head != nullptr) {
+                    auto &waiter = pop();
+                    waiter.resumption.priority = priority;
+                    resumeOn(waiter.dm, waiter.resumption);
+                }
+            }
+
+        private:
+            AsyncWaiter *_head{};
+            AsyncWaiter *_tail{};
+        };
+    }
+
+    template <typename Lock>
+    class BasicAsyncSemaphoreOperation;
+
+    /// Counting semaphore that suspends awaiting coroutines instead of blocking the thread, e.g. to cap the amount of concurrent outgoing connections.
+    ///
+    /// Permits are handed to waiters in the order they started waiting, a release() does not let a later tryAcquire() barge in.
+    /// Waiters are not resumed inside release(), but from the ready queue of the manager they suspended on, so that releasing
+    /// from a loop does not nest resumptions. Coroutines that suspended on a thread without a DependencyManager are resumed inside release().
+    ///
+    /// Use AsyncSemaphore within a single DependencyManager and AsyncCrossThreadSemaphore to share it between threads.
+    template <typename Lock>
+    class BasicAsyncSemaphore final {
+    public:
+        /// \param permits initial amount of permits
+        /// \param priority priority with which waiters are resumed, see Event::priority
+        explicit BasicAsyncSemaphore(uint64_t permits, uint64_t priority = INTERNAL_COROUTINE_EVENT_PRIORITY) noexcept;
+        ~BasicAsyncSemaphore();
+
+        BasicAsyncSemaphore(const BasicAsyncSemaphore&) = delete;
+        BasicAsyncSemaphore(BasicAsyncSemaphore&&) = delete;
+        BasicAsyncSemaphore& operator=(const BasicAsyncSemaphore&) = delete;
+        BasicAsyncSemaphore& operator=(BasicAsyncSemaphore&&) = delete;
+
+        /// Usage: co_await semaphore.acquire();
+        /// \return operation that continues without suspending if a permit is available and nobody is waiting for one
+        [[nodiscard]] BasicAsyncSemaphoreOperation<Lock> acquire() noexcept;
+
+        /// \return true if a permit was taken
+        [[nodiscard]] bool tryAcquire() noexcept;
+
+        /// Returns permits, handing them to waiters first
+        /// \param count
+        void release(uint64_t count = 1) noexcept;
+
+        /// \return amount of permits that can be acquired without suspending
+        [[nodiscard]] uint64_t available() const noexcept;
+
+    private:
+        friend class BasicAsyncSemaphoreOperation<Lock>;
+
+        mutable Lock _lock{};
+        uint64_t _permits;
+        uint64_t _priority;
+        Detail::AsyncWaiterQueue _waiters{};
+    };
+
+    template <typename Lock>
+    class BasicAsyncSemaphoreOperation final {
+    public:
+        explicit BasicAsyncSemaphoreOperation(BasicAsyncSemaphore<Lock> &semaphore) noexcept : _semaphore(semaphore) {}
+
+        bool await_ready() const noexcept {
+            return false;
+        }
+
+        bool await_suspend(std::coroutine_handle<> awaiter) noexcept;
+
+        void await_resume() const noexcept {}
+
+    private:
+        BasicAsyncSemaphore<Lock> &_semaphore;
+        Detail::AsyncWaiter _waiter{};
+    };
+
+    extern template class BasicAsyncSemaphore<Detail::SingleThreadLock>;
+    extern template class BasicAsyncSemaphore<RealtimeMutex>;
+    extern template class BasicAsyncSemaphoreOperation<Detail::SingleThreadLock>;
+    extern template class BasicAsyncSemaphoreOperation<RealtimeMutex>;
+
+    using AsyncSemaphore = BasicAsyncSemaphore<Detail::SingleThreadLock>;
+    using AsyncCrossThreadSemaphore = BasicAsyncSemaphore<RealtimeMutex>;
+}
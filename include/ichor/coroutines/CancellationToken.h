@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+namespace Ichor {
+    namespace Detail {
+        struct CancellationState;
+    }
+
+    class CancellationSource;
+    class CancellationRegistration;
+
+    /// Observes cancellation requests of a CancellationSource. Cheap to copy, pass it by value into the operations that should be cancellable.
+    /// A default-constructed token can never be cancelled.
+    class CancellationToken final {
+    public:
+        CancellationToken() noexcept = default;
+
+        /// Thread-safe.
+        [[nodiscard]] bool isCancellationRequested() const noexcept;
+        /// Thread-safe.
+        /// \return false if this token is default-constructed
+        [[nodiscard]] bool canBeCancelled() const noexcept;
+
+    private:
+        explicit CancellationToken(std::shared_ptr<Detail::CancellationState> state) noexcept;
+
+        friend class CancellationSource;
+        friend class CancellationRegistration;
+
+        std::shared_ptr<Detail::CancellationState> _state{};
+    };
+
+    /// Requests cancellation of all operations holding one of its tokens. Copies share the same state.
+    /// Once requested, cancellation cannot be undone, create a new source instead.
+    class CancellationSource final {
+    public:
+        CancellationSource();
+
+        [[nodiscard]] CancellationToken getToken() const noexcept;
+        /// Requests cancellation and runs the callbacks of all CancellationRegistrations on the calling thread.
+        /// Not thread-safe, call from the thread of the DependencyManager the registrations were made on. No-op if already requested.
+        void requestCancellation();
+        /// Thread-safe.
+        [[nodiscard]] bool isCancellationRequested() const noexcept;
+
+    private:
+        std::shared_ptr<Detail::CancellationState> _state;
+    };
+
+    /// Runs a callback when cancellation is requested for a token, as long as the registration is alive.
+    /// Typically used to abort the underlying I/O of an awaited operation, e.g. by posting a cancel to the asio context.
+    class CancellationRegistration final {
+    public:
+        /// Registers callback, or runs it immediately if cancellation has already been requested. Callbacks may destroy registrations, including their own.
+        /// \param token
+        /// \param callback
+        CancellationRegistration(CancellationToken const &token, std::function<void()> callback);
+        ~CancellationRegistration();
+
+        CancellationRegistration(const CancellationRegistration&) = delete;
+        CancellationRegistration(CancellationRegistration&&) = delete;
+        CancellationRegistration& operator=(const CancellationRegistration&) = delete;
+        CancellationRegistration& operator=(CancellationRegistration&&) = delete;
+
+    private:
+        std::shared_ptr<Detail::CancellationState> _state{};
+        uint64_t _id{};
+    };
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Ichor {
+    /// Statistics of the coroutine frame pool of the calling thread, see DependencyManager::getCoroutineFramePoolStats()
+    struct CoroutineFramePoolStats final {
+        uint64_t allocations; // frames allocated through the pool, including those too large to be pooled
+        uint64_t hits; // allocations served from a cached frame
+        uint64_t remoteFrees; // frames allocated on this thread and freed on another
+        uint64_t outstandingFrames; // frames currently in use
+        uint64_t highWaterFrames; // maximum of outstandingFrames
+        uint64_t cachedBytes; // memory kept in the pool for reuse
+        uint64_t highWaterCachedBytes; // maximum of cachedBytes
+    };
+}
+
+namespace Ichor::Detail {
+    /// Allocates a coroutine frame from the calling thread's pool. Frames are bucketed by size, frames too large for a bucket go to the global allocator.
+    /// Used by the promise types of AsyncGenerator and Task when ICHOR_USE_COROUTINE_FRAME_POOL is defined.
+    [[nodiscard]] void* allocateCoroutineFrame(std::size_t size);
+    /// Returns a frame to the pool of the thread that allocated it. Safe to call from any thread.
+    void freeCoroutineFrame(void *frame) noexcept;
+    [[nodiscard]] CoroutineFramePoolStats getCoroutineFramePoolStats() noexcept;
+}
+
+#ifdef ICHOR_USE_COROUTINE_FRAME_POOL
+#define ICHOR_COROUTINE_FRAME_ALLOCATOR \
+    static void* operator new(std::size_t size) { \
+        return ::Ichor::Detail::allocateCoroutineFrame(size); \
+    } \
+    static void operator delete(void *frame) noexcept { \
+        ::Ichor::Detail::freeCoroutineFrame(frame); \
+    }
+#else
+#define ICHOR_COROUTINE_FRAME_ALLOCATOR
+#endif
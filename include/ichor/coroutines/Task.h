@@ -11,6 +11,7 @@
 #include <cstdint>
 #include <cassert>
 #include <coroutine>
+#include <ichor/coroutines/CoroutineFramePool.h>
 
 
 namespace Ichor
@@ -27,10 +28,18 @@ namespace Ichor
             {
                 bool await_ready() const noexcept { return false; }
 
+                // Transfer to the awaiting coroutine instead of resuming it on top of this one,
+                // so that long chains of (synchronously completing) tasks run in constant stack space.
                 template<typename PROMISE>
-                void await_suspend(std::coroutine_handle<PROMISE> coroutine) noexcept
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<PROMISE> coroutine) noexcept
                 {
-                    coroutine.promise().m_continuation.resume();
+                    auto continuation = coroutine.promise().m_continuation;
+                    if (!continuation)
+                    {
+                        return std::noop_coroutine();
+                    }
+
+                    return continuation;
                 }
 
                 void await_resume() noexcept {}
@@ -41,6 +50,8 @@ namespace Ichor
             TaskPromiseBase() noexcept
             {}
 
+            ICHOR_COROUTINE_FRAME_ALLOCATOR
+
             auto initial_suspend() noexcept
             {
                 return std::suspend_always{};
@@ -259,10 +270,10 @@ namespace Ichor
                 return !m_coroutine || m_coroutine.done();
             }
 
-            void await_suspend(std::coroutine_handle<> awaitingCoroutine) noexcept
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaitingCoroutine) noexcept
             {
                 m_coroutine.promise().set_continuation(awaitingCoroutine);
-                m_coroutine.resume();
+                return m_coroutine;
             }
         };
 
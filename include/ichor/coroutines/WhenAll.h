@@ -0,0 +1,298 @@
+#pragma once
+
+#include <ichor/coroutines/Task.h>
+#include <ichor/coroutines/AsyncGenerator.h>
+#include <ichor/Enums.h>
+#include <tl/expected.h>
+#include <array>
+#include <exception>
+#include <optional>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Ichor {
+    /// Awaits the first value of generator, e.g. to pass a service function returning an AsyncGenerator to whenAll or whenAny.
+    /// The generator is destroyed afterwards, so it should not yield more than one value.
+    /// \tparam T
+    /// \param generator
+    /// \return the first value
+    template <typename T>
+    Task<T> firstValue(AsyncGenerator<T> generator) {
+        auto it = co_await generator.begin();
+
+        if constexpr (!std::is_void_v<T>) {
+            if(it == generator.end()) [[unlikely]] {
+                std::terminate();
+            }
+
+            co_return std::move(*it);
+        }
+    }
+
+    namespace Detail {
+        template <typename T>
+        using WhenAllValue = std::conditional_t<std::is_void_v<T>, Empty, T>;
+
+        template <typename T, typename E>
+        WhenAllValue<T> expectedValue(tl::expected<T, E> &&result) {
+            if constexpr (std::is_void_v<T>) {
+                return {};
+            } else {
+                return std::move(*result);
+            }
+        }
+
+        template <typename T>
+        struct WhenAllTraits;
+
+        template <typename T>
+        struct WhenAllTraits<Task<T>> {
+            using value_type = T;
+
+            static Task<T> toTask(Task<T> task) noexcept {
+                return task;
+            }
+        };
+
+        template <typename T>
+        struct WhenAllTraits<AsyncGenerator<T>> {
+            using value_type = T;
+
+            static Task<T> toTask(AsyncGenerator<T> generator) {
+                return firstValue(std::move(generator));
+            }
+        };
+
+        template <typename T>
+        concept WhenAllOperand = requires { typename WhenAllTraits<std::remove_cvref_t<T>>::value_type; };
+
+        template <typename T>
+        using WhenAllValueOf = typename WhenAllTraits<std::remove_cvref_t<T>>::value_type;
+
+        /// Counts the tasks of a whenAll that have not completed yet, plus one for the awaiting coroutine until it suspends.
+        /// Tasks are resumed by the event loop of the awaiting coroutine, so no synchronisation is needed.
+        class WhenAllCounter final {
+        public:
+            explicit WhenAllCounter(std::size_t count) noexcept : _remaining(count + 1) {
+#ifdef ICHOR_USE_HARDENING
+                _dm = _local_dm;
+#endif
+            }
+
+            /// \param awaiting
+            /// \return false if all tasks have already completed, meaning awaiting does not have to suspend
+            bool trySuspend(std::coroutine_handle<> awaiting) noexcept {
+                _awaiting = awaiting;
+                return --_remaining != 0;
+            }
+
+            /// \return coroutine to continue with, the awaiting coroutine once the last task completed
+            std::coroutine_handle<> notifyCompleted() noexcept {
+#ifdef ICHOR_USE_HARDENING
+                // tasks have to complete on the thread that awaits them
+                if(_dm != _local_dm) [[unlikely]] {
+                    std::terminate();
+                }
+#endif
+                if(--_remaining == 0) {
+                    return _awaiting;
+                }
+                return std::noop_coroutine();
+            }
+
+        private:
+            std::size_t _remaining;
+            std::coroutine_handle<> _awaiting{};
+#ifdef ICHOR_USE_HARDENING
+            DependencyManager *_dm;
+#endif
+        };
+
+        /// Runs one task of a whenAll, the frame is owned by the whenAll that created it.
+        class WhenAllChild final {
+        public:
+            struct promise_type final {
+                struct FinalAwaitable final {
+                    bool await_ready() const noexcept { return false; }
+
+                    std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> coroutine) noexcept {
+                        return coroutine.promise()._counter->notifyCompleted();
+                    }
+
+                    void await_resume() noexcept {}
+                };
+
+                ICHOR_COROUTINE_FRAME_ALLOCATOR
+
+                WhenAllChild get_return_object() noexcept {
+                    return WhenAllChild{std::coroutine_handle<promise_type>::from_promise(*this)};
+                }
+
+                std::suspend_always initial_suspend() noexcept {
+                    return {};
+                }
+
+                FinalAwaitable final_suspend() noexcept {
+                    return {};
+                }
+
+                void return_void() noexcept {}
+
+                void unhandled_exception() noexcept {
+                    _exception = std::current_exception();
+                }
+
+                WhenAllCounter *_counter{};
+                std::exception_ptr _exception{};
+            };
+
+            explicit WhenAllChild(std::coroutine_handle<promise_type> coroutine) noexcept : _coroutine(coroutine) {}
+
+            WhenAllChild(WhenAllChild &&o) noexcept : _coroutine(std::exchange(o._coroutine, nullptr)) {}
+            WhenAllChild& operator=(WhenAllChild &&o) noexcept {
+                if(this != &o) {
+                    if(_coroutine) {
+                        _coroutine.destroy();
+                    }
+                    _coroutine = std::exchange(o._coroutine, nullptr);
+                }
+                return *this;
+            }
+            WhenAllChild(const WhenAllChild&) = delete;
+            WhenAllChild& operator=(const WhenAllChild&) = delete;
+
+            ~WhenAllChild() {
+                if(_coroutine) {
+                    _coroutine.destroy();
+                }
+            }
+
+            void start(WhenAllCounter &counter) noexcept {
+                _coroutine.promise()._counter = &counter;
+                _coroutine.resume();
+            }
+
+            void rethrowIfFailed() const {
+                if(_coroutine.promise()._exception) {
+                    std::rethrow_exception(_coroutine.promise()._exception);
+                }
+            }
+
+        private:
+            std::coroutine_handle<promise_type> _coroutine;
+        };
+
+        template <typename T>
+        WhenAllChild makeWhenAllChild(Task<T> task, std::optional<WhenAllValue<T>> &result) {
+            if constexpr (std::is_void_v<T>) {
+                co_await std::move(task);
+                result.emplace();
+            } else {
+                result.emplace(co_await std::move(task));
+            }
+        }
+
+        /// Starts all children and suspends the awaiting coroutine until the last one completed
+        class WhenAllAwaitable final {
+        public:
+            explicit WhenAllAwaitable(std::span<WhenAllChild> children) noexcept : _children(children), _counter(children.size()) {}
+
+            bool await_ready() const noexcept {
+                return _children.empty();
+            }
+
+            bool await_suspend(std::coroutine_handle<> awaiting) noexcept {
+                for(auto &child : _children) {
+                    child.start(_counter);
+                }
+                return _counter.trySuspend(awaiting);
+            }
+
+            void await_resume() const {
+                for(auto const &child : _children) {
+                    child.rethrowIfFailed();
+                }
+            }
+
+        private:
+            std::span<WhenAllChild> _children;
+            WhenAllCounter _counter;
+        };
+    }
+
+    /// Runs all tasks concurrently on the calling event loop and completes when all of them have.
+    /// Instead of awaiting three redis replies one after the other, they can be awaited together:
+    ///
+    /// auto [a, b, c] = co_await whenAll(_redis->get("a"), _redis->get("b"), _redis->get("c"));
+    ///
+    /// Generators are awaited for their first value, see firstValue.
+    /// If any task throws, the first exception (in argument order) is rethrown once all tasks completed.
+    /// \tparam Awaitables Task<T> or AsyncGenerator<T>
+    /// \param awaitables
+    /// \return tuple of the results, in argument order. Tasks returning void result in Empty.
+    template <typename... Awaitables> requires (Detail::WhenAllOperand<Awaitables> && ...)
+    Task<std::tuple<Detail::WhenAllValue<Detail::WhenAllValueOf<Awaitables>>...>> whenAll(Awaitables... awaitables) {
+        std::tuple<std::optional<Detail::WhenAllValue<Detail::WhenAllValueOf<Awaitables>>>...> results{};
+        auto children = [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+            return std::array<Detail::WhenAllChild, sizeof...(Awaitables)>{
+                Detail::makeWhenAllChild(Detail::WhenAllTraits<Awaitables>::toTask(std::move(awaitables)), std::get<Is>(results))...
+            };
+        }(std::index_sequence_for<Awaitables...>{});
+
+        co_await Detail::WhenAllAwaitable{children};
+
+        co_return std::apply([](auto &...result) {
+            return std::tuple<Detail::WhenAllValue<Detail::WhenAllValueOf<Awaitables>>...>{std::move(*result)...};
+        }, results);
+    }
+
+    /// Runs all tasks concurrently on the calling event loop and completes when all of them have.
+    /// If any task throws, the first exception (in vector order) is rethrown once all tasks completed.
+    /// \tparam T
+    /// \param tasks
+    /// \return the results, in the order of tasks. Tasks returning void result in Empty.
+    template <typename T>
+    Task<std::vector<Detail::WhenAllValue<T>>> whenAll(std::vector<Task<T>> tasks) {
+        std::vector<std::optional<Detail::WhenAllValue<T>>> results(tasks.size());
+        std::vector<Detail::WhenAllChild> children;
+        children.reserve(tasks.size());
+        for(std::size_t i = 0; i < tasks.size(); i++) {
+            children.emplace_back(Detail::makeWhenAllChild(std::move(tasks[i]), results[i]));
+        }
+
+        co_await Detail::WhenAllAwaitable{children};
+
+        std::vector<Detail::WhenAllValue<T>> ret;
+        ret.reserve(results.size());
+        for(auto &result : results) {
+            ret.emplace_back(std::move(*result));
+        }
+        co_return ret;
+    }
+
+    /// Like whenAll, for tasks returning tl::expected with the same error type.
+    /// All tasks are awaited, after which the first error (in argument order) is returned, if any.
+    /// \tparam E common error type
+    /// \param tasks
+    /// \return tuple of the values, in argument order. Tasks returning tl::expected<void, E> result in Empty.
+    template <typename E, typename... Ts>
+    Task<tl::expected<std::tuple<Detail::WhenAllValue<Ts>...>, E>> whenAllExpected(Task<tl::expected<Ts, E>>... tasks) {
+        auto results = co_await whenAll(std::move(tasks)...);
+
+        std::optional<E> error{};
+        std::apply([&error](auto const &...result) {
+            ((!error && !result ? (void)error.emplace(result.error()) : (void)0), ...);
+        }, results);
+
+        if(error) {
+            co_return tl::unexpected(std::move(*error));
+        }
+
+        co_return std::apply([](auto &...result) {
+            return std::tuple<Detail::WhenAllValue<Ts>...>{Detail::expectedValue<Ts>(std::move(result))...};
+        }, results);
+    }
+}
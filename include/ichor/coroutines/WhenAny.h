@@ -0,0 +1,205 @@
+#pragma once
+
+#include <ichor/coroutines/WhenAll.h>
+#include <memory>
+
+namespace Ichor {
+    template <typename T>
+    struct WhenAnyResult final {
+        std::size_t index; // argument index of the task that completed first
+        T value;
+    };
+
+    namespace Detail {
+        /// Shared between a whenAny and its tasks, as the tasks that did not complete first outlive the whenAny
+        template <typename T>
+        struct WhenAnyState final {
+            void complete(std::size_t index, T &&value) noexcept(std::is_nothrow_move_constructible_v<T>) {
+                if(done) {
+                    return;
+                }
+                done = true;
+                result.emplace(WhenAnyResult<T>{index, std::move(value)});
+                resumeAwaiting();
+            }
+
+            void fail(std::exception_ptr ptr) noexcept {
+                if(done) {
+                    return;
+                }
+                done = true;
+                exception = std::move(ptr);
+                resumeAwaiting();
+            }
+
+            void resumeAwaiting() noexcept {
+#ifdef ICHOR_USE_HARDENING
+                // tasks have to complete on the thread that awaits them
+                if(dm != _local_dm) [[unlikely]] {
+                    std::terminate();
+                }
+#endif
+                if(suspended) {
+                    awaiting.resume();
+                }
+            }
+
+            bool done{};
+            bool suspended{};
+            std::coroutine_handle<> awaiting{};
+            std::optional<WhenAnyResult<T>> result{};
+            std::exception_ptr exception{};
+#ifdef ICHOR_USE_HARDENING
+            DependencyManager *dm{_local_dm};
+#endif
+        };
+
+        /// Runs one task of a whenAny. Once started, the frame destroys itself when the task completes.
+        class WhenAnyChild final {
+        public:
+            struct promise_type final {
+                ICHOR_COROUTINE_FRAME_ALLOCATOR
+
+                WhenAnyChild get_return_object() noexcept {
+                    return WhenAnyChild{std::coroutine_handle<promise_type>::from_promise(*this)};
+                }
+
+                std::suspend_always initial_suspend() noexcept {
+                    return {};
+                }
+
+                std::suspend_never final_suspend() noexcept {
+                    return {};
+                }
+
+                void return_void() noexcept {}
+
+                void unhandled_exception() noexcept {
+                    std::terminate();
+                }
+            };
+
+            explicit WhenAnyChild(std::coroutine_handle<promise_type> coroutine) noexcept : _coroutine(coroutine) {}
+
+            WhenAnyChild(WhenAnyChild &&o) noexcept : _coroutine(std::exchange(o._coroutine, nullptr)) {}
+            WhenAnyChild& operator=(WhenAnyChild &&) = delete;
+            WhenAnyChild(const WhenAnyChild&) = delete;
+            WhenAnyChild& operator=(const WhenAnyChild&) = delete;
+
+            /// Destroys the task if it never got started
+            ~WhenAnyChild() {
+                if(_coroutine) {
+                    _coroutine.destroy();
+                }
+            }
+
+            void start() noexcept {
+                std::exchange(_coroutine, nullptr).resume();
+            }
+
+        private:
+            std::coroutine_handle<promise_type> _coroutine;
+        };
+
+        template <typename T>
+        WhenAnyChild makeWhenAnyChild(Task<T> task, std::shared_ptr<WhenAnyState<WhenAllValue<T>>> state, std::size_t index) {
+            try {
+                if constexpr (std::is_void_v<T>) {
+                    co_await std::move(task);
+                    state->complete(index, Empty{});
+                } else {
+                    state->complete(index, co_await std::move(task));
+                }
+            } catch(...) {
+                state->fail(std::current_exception());
+            }
+        }
+
+        /// Starts children until one completes synchronously and suspends the awaiting coroutine until one completed
+        template <typename T>
+        class WhenAnyAwaitable final {
+        public:
+            WhenAnyAwaitable(std::span<WhenAnyChild> children, WhenAnyState<T> &state) noexcept : _children(children), _state(state) {}
+
+            bool await_ready() const noexcept {
+                return false;
+            }
+
+            bool await_suspend(std::coroutine_handle<> awaiting) noexcept {
+                _state.awaiting = awaiting;
+                for(auto &child : _children) {
+                    child.start();
+                    if(_state.done) {
+                        return false;
+                    }
+                }
+                _state.suspended = true;
+                return true;
+            }
+
+            void await_resume() const noexcept {}
+
+        private:
+            std::span<WhenAnyChild> _children;
+            WhenAnyState<T> &_state;
+        };
+
+        template <typename T>
+        Task<WhenAnyResult<T>> awaitWhenAny(std::span<WhenAnyChild> children, std::shared_ptr<WhenAnyState<T>> state) {
+            co_await WhenAnyAwaitable<T>{children, *state};
+
+            if(state->exception) {
+                std::rethrow_exception(state->exception);
+            }
+
+            co_return std::move(*state->result);
+        }
+    }
+
+    /// Runs the tasks concurrently on the calling event loop and completes as soon as the first one does.
+    /// Tasks are started in argument order and tasks after one that completes without suspending are not started at all.
+    /// Tasks that did not complete first keep running in the background and their results are discarded,
+    /// so pass them a CancellationToken and cancel it afterwards if they should stop early:
+    ///
+    /// CancellationSource source;
+    /// auto fastest = co_await whenAny(_primary->sendAsync(HttpMethod::get, "/", {}, {}, source.getToken()), _fallback->sendAsync(HttpMethod::get, "/", {}, {}, source.getToken()));
+    /// source.requestCancellation();
+    ///
+    /// Generators are awaited for their first value, see firstValue.
+    /// \tparam Awaitables Task<T> or AsyncGenerator<T>, all with the same T
+    /// \param awaitables
+    /// \return the index and result of the first task to complete, or rethrows its exception. Tasks returning void result in Empty.
+    template <typename First, typename... Awaitables>
+    requires (Detail::WhenAllOperand<First> && (Detail::WhenAllOperand<Awaitables> && ...) && (std::is_same_v<Detail::WhenAllValueOf<First>, Detail::WhenAllValueOf<Awaitables>> && ...))
+    Task<WhenAnyResult<Detail::WhenAllValue<Detail::WhenAllValueOf<First>>>> whenAny(First first, Awaitables... awaitables) {
+        using T = Detail::WhenAllValueOf<First>;
+        auto state = std::make_shared<Detail::WhenAnyState<Detail::WhenAllValue<T>>>();
+        std::size_t index{};
+        std::array<Detail::WhenAnyChild, sizeof...(Awaitables) + 1> children{
+            Detail::makeWhenAnyChild(Detail::WhenAllTraits<First>::toTask(std::move(first)), state, index++),
+            Detail::makeWhenAnyChild(Detail::WhenAllTraits<Awaitables>::toTask(std::move(awaitables)), state, index++)...
+        };
+
+        co_return co_await Detail::awaitWhenAny(std::span<Detail::WhenAnyChild>{children}, std::move(state));
+    }
+
+    /// Runs the tasks concurrently on the calling event loop and completes as soon as the first one does, see the variadic whenAny.
+    /// \tparam T
+    /// \param tasks must not be empty
+    /// \return the index and result of the first task to complete, or rethrows its exception. Tasks returning void result in Empty.
+    template <typename T>
+    Task<WhenAnyResult<Detail::WhenAllValue<T>>> whenAny(std::vector<Task<T>> tasks) {
+        if(tasks.empty()) [[unlikely]] {
+            std::terminate();
+        }
+
+        auto state = std::make_shared<Detail::WhenAnyState<Detail::WhenAllValue<T>>>();
+        std::vector<Detail::WhenAnyChild> children;
+        children.reserve(tasks.size());
+        for(std::size_t i = 0; i < tasks.size(); i++) {
+            children.emplace_back(Detail::makeWhenAnyChild(std::move(tasks[i]), state, i));
+        }
+
+        co_return co_await Detail::awaitWhenAny(std::span<Detail::WhenAnyChild>{children}, std::move(state));
+    }
+}
@@ -24,20 +24,18 @@ namespace Ichor {
         requires Derived<ServiceType, IService>
 #endif
         class DependencyLifecycleManager;
-
-        extern std::atomic<uint64_t> _serviceIdCounter;
     }
 
     template <typename T>
     class AdvancedService : public IService {
     public:
         template <typename U = T> requires (!RequestsProperties<U> && !RequestsDependencies<U>)
-        AdvancedService() noexcept : IService(), _serviceId(Detail::_serviceIdCounter.fetch_add(1, std::memory_order_relaxed)), _servicePriority(INTERNAL_EVENT_PRIORITY), _serviceGid(sole::uuid4()), _serviceState(ServiceState::INSTALLED) {
+        AdvancedService() noexcept : IService(), _serviceId(Detail::reserveServiceId()), _servicePriority(INTERNAL_EVENT_PRIORITY), _serviceGid(sole::uuid4()), _serviceState(ServiceState::INSTALLED) {
 
         }
 
         template <typename U = T> requires (RequestsProperties<U> || RequestsDependencies<U>)
-        AdvancedService(Properties&& props) noexcept : IService(), _properties(std::move(props)), _serviceId(Detail::_serviceIdCounter.fetch_add(1, std::memory_order_relaxed)), _servicePriority(INTERNAL_EVENT_PRIORITY), _serviceGid(sole::uuid4()), _serviceState(ServiceState::INSTALLED) {
+        AdvancedService(Properties&& props) noexcept : IService(), _properties(std::move(props)), _serviceId(Detail::reserveServiceId()), _servicePriority(INTERNAL_EVENT_PRIORITY), _serviceGid(sole::uuid4()), _serviceState(ServiceState::INSTALLED) {
 
         }
 
@@ -181,7 +179,7 @@ namespace Ichor {
         uint64_t _serviceId;
         uint64_t _servicePriority;
         sole::uuid _serviceGid;
-        ServiceState _serviceState;
+        Detail::MirroredServiceState _serviceState;
 
         template<class ServiceType, typename... IFaces>
 #if (!defined(WIN32) && !defined(_WIN32) && !defined(__WIN32)) || defined(__CYGWIN__)
@@ -5,6 +5,7 @@
 #include <ichor/dependency_management/DependencyInfo.h>
 #include <ichor/dependency_management/DependencyRegister.h>
 #include <ichor/dependency_management/IService.h>
+#include <tuple>
 #include <utility>
 #include <variant>
 
@@ -119,7 +120,13 @@ namespace Ichor {
     }  // namespace refl
 
     namespace Detail {
-        extern std::atomic<uint64_t> _serviceIdCounter;
+        template <typename T, typename... Ts>
+        inline constexpr size_t typeCount = (static_cast<size_t>(std::is_same_v<T, Ts>) + ... + 0);
+
+        template <typename Tuple>
+        struct TupleTypesUnique : std::false_type {};
+        template <typename... Ts>
+        struct TupleTypesUnique<std::tuple<Ts...>> : std::bool_constant<((typeCount<Ts, Ts...> == 1) && ...)> {};
 
         template<class ServiceType, typename... IFaces>
 #if (!defined(WIN32) && !defined(_WIN32) && !defined(__WIN32)) || defined(__CYGWIN__)
@@ -144,8 +151,10 @@ namespace Ichor {
 
     template <HasConstructorInjectionDependencies T>
     class ConstructorInjectionService<T> : public IService {
+        // dependencies are injected into the slot of their type, a second parameter of the same type could never be told apart
+        static_assert(Detail::TupleTypesUnique<refl::as_tuple<T>>::value, "Constructor injection can only request every interface once, take the interface in a single constructor parameter");
     public:
-        ConstructorInjectionService(DependencyRegister &reg, Properties props) noexcept : IService(), _properties(std::move(props)), _serviceId(Detail::_serviceIdCounter.fetch_add(1, std::memory_order_relaxed)), _servicePriority(INTERNAL_EVENT_PRIORITY), _serviceGid(sole::uuid4()), _serviceState(ServiceState::INSTALLED) {
+        ConstructorInjectionService(DependencyRegister &reg, Properties props) noexcept : IService(), _properties(std::move(props)), _serviceId(Detail::reserveServiceId()), _servicePriority(INTERNAL_EVENT_PRIORITY), _serviceGid(sole::uuid4()), _serviceState(ServiceState::INSTALLED) {
             registerDependenciesSpecialSauce(reg, std::optional<refl::as_variant<T>>());
         }
 
@@ -163,10 +172,19 @@ namespace Ichor {
         void registerDependenciesSpecialSauce(DependencyRegister &reg, std::optional<std::variant<CO_ARGS...>> = {}) {
             (reg.registerDependencyConstructor<std::remove_pointer_t<CO_ARGS>>(this), ...);
         }
-        template <typename... CO_ARGS>
-        void createServiceSpecialSauce(std::optional<std::variant<CO_ARGS...>> = {}) {
+        void createServiceSpecialSauce() {
+            if constexpr (DO_INTERNAL_DEBUG || DO_HARDENING) {
+                std::apply([](auto... deps) {
+                    if(((deps == nullptr) || ...)) [[unlikely]] {
+                        std::terminate();
+                    }
+                }, _deps);
+            }
+
             try {
-                new (buf) T(std::get<CO_ARGS>(_deps[typeNameHash<std::remove_pointer_t<CO_ARGS>>()])...);
+                std::apply([this](auto... deps) {
+                    new (buf) T(deps...);
+                }, _deps);
             } catch (std::exception const &e) {
                 std::terminate();
             }
@@ -230,7 +248,7 @@ namespace Ichor {
 
             INTERNAL_DEBUG("internal_start service {}:{} state {} -> {}", getServiceId(), typeName<T>(), getState(), ServiceState::STARTING);
             _serviceState = ServiceState::STARTING;
-            createServiceSpecialSauce(std::optional<refl::as_variant<T>>());
+            createServiceSpecialSauce();
 
             INTERNAL_DEBUG("internal_start service {}:{} state {} -> {}", getServiceId(), typeName<T>(), getState(), ServiceState::INJECTING);
             _serviceState = ServiceState::INJECTING;
@@ -286,12 +304,18 @@ namespace Ichor {
 
         template <typename depT>
         void addDependencyInstance(NeverNull<depT*> dep, NeverNull<IService*>) {
-            _deps.emplace(typeNameHash<depT>(), dep);
+            auto &slot = std::get<depT*>(_deps);
+            if(slot == nullptr) {
+                slot = dep.get();
+            }
         }
 
         template <typename depT>
-        void removeDependencyInstance(NeverNull<depT*>, NeverNull<IService*>) {
-            _deps.erase(typeNameHash<depT>());
+        void removeDependencyInstance(NeverNull<depT*> dep, NeverNull<IService*>) {
+            auto &slot = std::get<depT*>(_deps);
+            if(slot == dep.get()) {
+                slot = nullptr;
+            }
         }
 
         [[nodiscard]] T* getImplementation() noexcept {
@@ -305,8 +329,8 @@ namespace Ichor {
         uint64_t _serviceId;
         uint64_t _servicePriority;
         sole::uuid _serviceGid;
-        ServiceState _serviceState;
-        unordered_map<uint64_t, refl::as_variant<T>> _deps{};
+        Detail::MirroredServiceState _serviceState;
+        refl::as_tuple<T> _deps{}; // one slot per constructor parameter, in constructor order
         alignas(T) std::byte buf[sizeof(T)];
 
         friend struct DependencyRegister;
@@ -322,7 +346,7 @@ namespace Ichor {
     template <DoesNotHaveConstructorInjectionDependencies T>
     class ConstructorInjectionService<T> : public IService {
     public:
-        ConstructorInjectionService(Properties props) noexcept : IService(), _properties(std::move(props)), _serviceId(Detail::_serviceIdCounter.fetch_add(1, std::memory_order_relaxed)), _servicePriority(INTERNAL_EVENT_PRIORITY), _serviceGid(sole::uuid4()), _serviceState(ServiceState::INSTALLED) {
+        ConstructorInjectionService(Properties props) noexcept : IService(), _properties(std::move(props)), _serviceId(Detail::reserveServiceId()), _servicePriority(INTERNAL_EVENT_PRIORITY), _serviceGid(sole::uuid4()), _serviceState(ServiceState::INSTALLED) {
         }
 
         ~ConstructorInjectionService() noexcept override {
@@ -457,7 +481,7 @@ namespace Ichor {
         uint64_t _serviceId;
         uint64_t _servicePriority;
         sole::uuid _serviceGid;
-        ServiceState _serviceState;
+        Detail::MirroredServiceState _serviceState;
         alignas(T) std::byte buf[sizeof(T)];
 
         friend struct DependencyRegister;
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Ichor {
+    /// Resolved dependency graph of a DependencyManager, see DependencyManager::createDependencyGraphSnapshot() and DependencyManager::replayDependencyGraphSnapshot().
+    /// Services are identified by implementation name plus their position among services with the same name, as service ids differ between runs.
+    struct DependencyGraphSnapshot final {
+        struct Service final {
+            std::string implementationName;
+            bool active;
+            bool hasFilter;
+        };
+
+        struct Edge final {
+            uint32_t provider; // index into services
+            uint32_t dependent; // index into services
+            uint64_t interfaceHash;
+        };
+
+        /// Text representation, meant to be written to a file and read back on the next start
+        [[nodiscard]] std::string serialize() const;
+        /// \param data output of serialize()
+        /// \return snapshot or nullopt if data is malformed
+        [[nodiscard]] static std::optional<DependencyGraphSnapshot> deserialize(std::string_view data);
+
+        std::vector<Service> services{}; // in order of creation
+        std::vector<Edge> edges{};
+        std::vector<uint32_t> startOrder{}; // indices of the active services, providers before their dependents
+    };
+}
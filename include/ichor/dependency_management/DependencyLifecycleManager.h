@@ -12,7 +12,7 @@ namespace Ichor::Detail {
     public:
         explicit DependencyLifecycleManager(std::vector<Dependency> interfaces, Properties&& properties) : _interfaces(std::move(interfaces)), _registry(), _dependencies(), _service(_registry, std::move(properties)) {
             for(auto const &reg : _registry._registrations) {
-                _dependencies.addDependency(std::get<0>(reg.second));
+                _dependencies.addDependency(reg.dependency);
             }
         }
 
@@ -21,6 +21,7 @@ namespace Ichor::Detail {
             for(auto const &dep : _dependencies._dependencies) {
                 GetThreadLocalEventQueue().template pushPrioritisedEvent<DependencyUndoRequestEvent>(_service.getServiceId(), INTERNAL_DEPENDENCY_EVENT_PRIORITY, Dependency{dep.interfaceNameHash, dep.required, dep.satisfied}, getProperties());
             }
+            releaseServiceId(_service.getServiceId());
         }
 
         template<typename... Interfaces>
@@ -63,19 +64,9 @@ namespace Ichor::Detail {
                 }
             }
 
-            auto interested = DependencyChange::NOT_FOUND;
+            auto interested = injectDependencies(dependentService, iterators) ? DependencyChange::FOUND : DependencyChange::NOT_FOUND;
 
-            for(auto &dep : iterators) {
-                if(dep->satisfied == 0) {
-                    interested = DependencyChange::FOUND;
-                }
-
-                _serviceIdsOfInjectedDependencies.insert(dependentService->serviceId());
-                injectIntoSelfDoubleDispatch(dep->interfaceNameHash, dependentService);
-                dep->satisfied++;
-            }
-
-            if(interested == DependencyChange::FOUND && getServiceState() <= ServiceState::INSTALLED && _dependencies.allSatisfied()) {
+            if(interested == DependencyChange::FOUND && !_dormant && getServiceState() <= ServiceState::INSTALLED && _dependencies.allSatisfied()) {
                 StartBehaviour ret = co_await _service.internal_start(nullptr); // we already checked the dependencies, pass in nullptr;
 
                 if(ret == StartBehaviour::STOPPED) {
@@ -182,28 +173,94 @@ namespace Ichor::Detail {
             co_return ret;
         }
 
+        bool dependencyOnlineSync(NeverNull<ILifecycleManager*> dependentService, std::vector<decltype(std::declval<DependencyInfo>().begin())> &iterators) final {
+            // starting the service requires the coroutine path, check if this injection would satisfy the last required dependency
+            if(!_dormant && getServiceState() <= ServiceState::INSTALLED) {
+                bool found = std::any_of(iterators.begin(), iterators.end(), [](auto const &dep) {
+                    return dep->satisfied == 0;
+                });
+
+                if(found && std::all_of(_dependencies.begin(), _dependencies.end(), [&iterators](Dependency const &dep) {
+                    return dep.satisfied > 0 || !dep.required || std::any_of(iterators.begin(), iterators.end(), [&dep](auto const &it) { return &*it == &dep; });
+                })) {
+                    return false;
+                }
+            }
+
+            INTERNAL_DEBUG("dependencyOnlineSync() svc {}:{} {} dependent {}:{}", serviceId(), implementationName(), getServiceState(), dependentService->serviceId(), dependentService->implementationName());
+            injectDependencies(dependentService, iterators);
+            return true;
+        }
+
+        bool dependencyOfflineSync(NeverNull<ILifecycleManager*> dependentService, std::vector<decltype(std::declval<DependencyInfo>().begin())> &iterators) final {
+            // losing the last instance of a required dependency while not stopped means waiting for or stopping this service
+            if(getServiceState() != ServiceState::INSTALLED && getServiceState() != ServiceState::UNINSTALLED) {
+                for(auto const &dep : iterators) {
+                    if(dep->required && dep->satisfied <= 1) {
+                        return false;
+                    }
+                }
+            }
+
+            INTERNAL_DEBUG("dependencyOfflineSync() svc {}:{} {} dependent {}:{}", serviceId(), implementationName(), getServiceState(), dependentService->serviceId(), dependentService->implementationName());
+            for(auto &dep : iterators) {
+                dep->satisfied--;
+                _serviceIdsOfInjectedDependencies.erase(dependentService->serviceId());
+
+#ifdef ICHOR_USE_HARDENING
+                if(dep->satisfied == std::numeric_limits<decltype(dep->satisfied)>::max()) [[unlikely]] {
+                    std::terminate();
+                }
+#endif
+
+                removeSelfIntoDoubleDispatch(dep->interfaceNameHash, dependentService);
+            }
+
+            return true;
+        }
+
+        /// Injects dependentService for all iterators
+        /// \param dependentService
+        /// \param iterators
+        /// \return true if at least one of the dependencies was not satisfied before
+        bool injectDependencies(NeverNull<ILifecycleManager*> dependentService, std::vector<decltype(std::declval<DependencyInfo>().begin())> &iterators) {
+            bool found{};
+
+            for(auto &dep : iterators) {
+                if(dep->satisfied == 0) {
+                    found = true;
+                }
+
+                _serviceIdsOfInjectedDependencies.insert(dependentService->serviceId());
+                injectIntoSelfDoubleDispatch(dep->interfaceNameHash, dependentService);
+                dep->satisfied++;
+            }
+
+            return found;
+        }
+
         /// We found a dependency that we're interested in, tell that dependency to inject itself into us
         /// We take this roundabout way because we have no way of casting the servicetype embedded in the lifecycle manager to the correct type
         /// \param keyOfInterfaceToInject
         /// \param dependentService
         void injectIntoSelfDoubleDispatch(uint64_t keyOfInterfaceToInject, NeverNull<ILifecycleManager*> dependentService) {
             INTERNAL_DEBUG("injectIntoSelfDoubleDispatch() svc {} adding dependency {}", serviceId(), dependentService->serviceId());
-            auto dep = _registry._registrations.find(keyOfInterfaceToInject);
+            auto const *dep = _registry.find(keyOfInterfaceToInject);
 
 #ifdef ICHOR_USE_HARDENING
-            if(dep == end(_registry._registrations)) [[unlikely]] {
+            if(dep == nullptr) [[unlikely]] {
                 std::terminate();
             }
 #endif
 
-            dependentService->insertSelfInto(keyOfInterfaceToInject, serviceId(), std::get<1>(dep->second));
+            dependentService->insertSelfInto(keyOfInterfaceToInject, serviceId(), _registry.adder(*dep));
         }
 
         /// Someone is interested in us, inject ourself into them
         /// \param keyOfInterfaceToInject
         /// \param serviceIdOfOther
         /// \param fn
-        void insertSelfInto(uint64_t keyOfInterfaceToInject, uint64_t serviceIdOfOther, std::function<void(NeverNull<void*>, IService&)> &fn) final {
+        void insertSelfInto(uint64_t keyOfInterfaceToInject, uint64_t serviceIdOfOther, Detail::DependencyInjector const &fn) final {
             INTERNAL_DEBUG("insertSelfInto() svc {} telling svc {} to add us", serviceId(), serviceIdOfOther);
             if constexpr (sizeof...(IFaces) > 0) {
                 insertSelfInto2<sizeof...(IFaces), IFaces...>(keyOfInterfaceToInject, fn);
@@ -218,7 +275,7 @@ namespace Ichor::Detail {
         /// \param keyOfInterfaceToInject
         /// \param fn
         template <int i, typename Iface1, typename... otherIfaces>
-        void insertSelfInto2(uint64_t keyOfInterfaceToInject, std::function<void(NeverNull<void*>, IService&)> &fn) {
+        void insertSelfInto2(uint64_t keyOfInterfaceToInject, Detail::DependencyInjector const &fn) {
             if(typeNameHash<Iface1>() == keyOfInterfaceToInject) {
                 fn(static_cast<Iface1*>(_service.getImplementation()), static_cast<IService&>(_service));
             } else {
@@ -230,22 +287,22 @@ namespace Ichor::Detail {
 
         void removeSelfIntoDoubleDispatch(uint64_t keyOfInterfaceToInject, NeverNull<ILifecycleManager*> dependentService) {
             INTERNAL_DEBUG("removeSelfIntoDoubleDispatch() svc {} removing dependency {}", serviceId(), dependentService->serviceId());
-            auto dep = _registry._registrations.find(keyOfInterfaceToInject);
+            auto const *dep = _registry.find(keyOfInterfaceToInject);
 
 #ifdef ICHOR_USE_HARDENING
-            if(dep == end(_registry._registrations)) [[unlikely]] {
+            if(dep == nullptr) [[unlikely]] {
                 std::terminate();
             }
 #endif
 
-            dependentService->removeSelfInto(keyOfInterfaceToInject, serviceId(), std::get<2>(dep->second));
+            dependentService->removeSelfInto(keyOfInterfaceToInject, serviceId(), _registry.remover(*dep));
         }
 
         /// The underlying service got stopped and someone else is asking us to remove ourselves from them.
         /// \param keyOfInterfaceToInject
         /// \param serviceIdOfOther
         /// \param fn
-        void removeSelfInto(uint64_t keyOfInterfaceToInject, uint64_t serviceIdOfOther, std::function<void(NeverNull<void*>, IService&)> &fn) final {
+        void removeSelfInto(uint64_t keyOfInterfaceToInject, uint64_t serviceIdOfOther, Detail::DependencyInjector const &fn) final {
             INTERNAL_DEBUG("removeSelfInto() svc {} telling svc {} to remove us", serviceId(), serviceIdOfOther);
             if constexpr (sizeof...(IFaces) > 0) {
                 insertSelfInto2<sizeof...(IFaces), IFaces...>(keyOfInterfaceToInject, fn);
@@ -284,6 +341,14 @@ namespace Ichor::Detail {
             return _service.internalSetUninjected();
         }
 
+        void setDormant(bool dormant) noexcept final {
+            _dormant = dormant;
+        }
+
+        void setStateMirror(ServiceState *mirror) noexcept final {
+            _service._serviceState.setMirror(mirror);
+        }
+
         [[nodiscard]] std::string_view implementationName() const noexcept final {
             return _service.getServiceName();
         }
@@ -335,5 +400,6 @@ namespace Ichor::Detail {
         ServiceType _service;
         unordered_set<uint64_t> _serviceIdsOfInjectedDependencies; // Services that this service depends on.
         unordered_set<uint64_t> _serviceIdsOfDependees; // services that depend on this service
+        bool _dormant{};
     };
 }
@@ -11,7 +11,9 @@ namespace Ichor::Detail {
             _interfaces.emplace_back(typeNameHash<DependencyManager>(), false, false);
         }
 
-        ~DependencyManagerLifecycleManager() final = default;
+        ~DependencyManagerLifecycleManager() final {
+            releaseServiceId(_service.getServiceId());
+        }
 
         std::vector<decltype(std::declval<DependencyInfo>().begin())> interestedInDependency(ILifecycleManager *dependentService, bool online) noexcept final {
             return {};
@@ -29,6 +31,16 @@ namespace Ichor::Detail {
             co_return StartBehaviour::DONE;
         }
 
+        bool dependencyOnlineSync(NeverNull<ILifecycleManager*> dependentService, std::vector<decltype(std::declval<DependencyInfo>().begin())> &iterators) final {
+            // this function should never be called
+            std::terminate();
+        }
+
+        bool dependencyOfflineSync(NeverNull<ILifecycleManager*> dependentService, std::vector<decltype(std::declval<DependencyInfo>().begin())> &iterators) final {
+            // this function should never be called
+            std::terminate();
+        }
+
         [[nodiscard]]
         unordered_set<uint64_t> &getDependencies() noexcept final {
             return emptyDependencies;
@@ -61,6 +73,14 @@ namespace Ichor::Detail {
             return true;
         }
 
+        void setDormant(bool) noexcept final {
+            // services without dependencies are started explicitly, nothing to defer
+        }
+
+        void setStateMirror(ServiceState *mirror) noexcept final {
+            _state.setMirror(mirror);
+        }
+
         [[nodiscard]] std::string_view implementationName() const noexcept final {
             return "DependencyManager";
         }
@@ -105,7 +125,7 @@ namespace Ichor::Detail {
         /// \param keyOfInterfaceToInject
         /// \param serviceIdOfOther
         /// \param fn
-        void insertSelfInto(uint64_t keyOfInterfaceToInject, uint64_t serviceIdOfOther, std::function<void(NeverNull<void*>, IService&)> &fn) final {
+        void insertSelfInto(uint64_t keyOfInterfaceToInject, uint64_t serviceIdOfOther, Detail::DependencyInjector const &fn) final {
             if(keyOfInterfaceToInject != typeNameHash<DependencyManager>()) {
                 return;
             }
@@ -119,7 +139,7 @@ namespace Ichor::Detail {
         /// \param keyOfInterfaceToInject
         /// \param serviceIdOfOther
         /// \param fn
-        void removeSelfInto(uint64_t keyOfInterfaceToInject, uint64_t serviceIdOfOther, std::function<void(NeverNull<void*>, IService&)> &fn) final {
+        void removeSelfInto(uint64_t keyOfInterfaceToInject, uint64_t serviceIdOfOther, Detail::DependencyInjector const &fn) final {
             if(keyOfInterfaceToInject != typeNameHash<DependencyManager>()) {
                 return;
             }
@@ -131,7 +151,7 @@ namespace Ichor::Detail {
 
     private:
         DependencyManager *_dm;
-        ServiceState _state{ServiceState::ACTIVE};
+        MirroredServiceState _state{ServiceState::ACTIVE};
         unordered_set<uint64_t> _serviceIdsOfDependees; // services that depend on this service
         std::vector<Dependency> _interfaces;
         InternalService _service;
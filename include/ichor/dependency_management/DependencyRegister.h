@@ -5,8 +5,35 @@
 #include <ichor/stl/NeverAlwaysNull.h>
 #include <optional>
 #include <stdexcept>
+#include <vector>
 
 namespace Ichor {
+    namespace Detail {
+        using DependencyInjectFnPtr = void(*)(void *ctx, NeverNull<void*> dep, IService &isvc);
+
+        /// Non-allocating callback used to inject a service into another one: calls fn with ctx as first argument.
+        struct DependencyInjector final {
+            void operator()(NeverNull<void*> dep, IService &isvc) const {
+                fn(ctx, dep, isvc);
+            }
+
+            DependencyInjectFnPtr fn;
+            void *ctx;
+        };
+
+        /// The add and remove functions only depend on the (Impl, Interface) pair, so there is one constexpr instance per pair, shared by all services of that type.
+        struct DependencyThunks final {
+            DependencyInjectFnPtr add;
+            DependencyInjectFnPtr remove;
+        };
+    }
+
+    struct DependencyRegistration final {
+        Dependency dependency;
+        Detail::DependencyThunks const *thunks;
+        std::optional<Properties> props;
+    };
+
     struct DependencyRegister final {
         template<typename Interface, DerivedTemplated<AdvancedService> Impl>
         void registerDependency(Impl *svc, bool required, std::optional<Properties> props = {}) {
@@ -17,16 +44,16 @@ namespace Ichor {
             static_assert(ImplementsDependencyInjection<Impl, Interface>, "Impl needs to implement the ImplementsDependencyInjection concept");
 #endif
             if constexpr (DO_INTERNAL_DEBUG || DO_HARDENING) {
-                if (_registrations.contains(typeNameHash<Interface>())) [[unlikely]] {
+                if (contains(typeNameHash<Interface>())) [[unlikely]] {
                     throw std::runtime_error("Already registered interface");
                 }
+                if (_svc != nullptr && _svc != svc) [[unlikely]] {
+                    throw std::runtime_error("All dependencies of a register have to be registered for the same service");
+                }
             }
 
-            _registrations.emplace(typeNameHash<Interface>(), std::make_tuple(
-                    Dependency{typeNameHash<Interface>(), required, 0},
-                    std::function<void(NeverNull<void*>, IService&)>{[svc](NeverNull<void*> dep, IService& isvc){ svc->addDependencyInstance(*reinterpret_cast<Interface*>(dep.get()), isvc); }},
-                    std::function<void(NeverNull<void*>, IService&)>{[svc](NeverNull<void*> dep, IService& isvc){ svc->removeDependencyInstance(*reinterpret_cast<Interface*>(dep.get()), isvc); }},
-                    std::move(props)));
+            _svc = svc;
+            _registrations.push_back(DependencyRegistration{Dependency{typeNameHash<Interface>(), required, 0}, &advancedThunks<Impl, Interface>, std::move(props)});
         }
 
         template<typename Interface, Derived<IService> Impl>
@@ -35,18 +62,71 @@ namespace Ichor {
             static_assert(!DerivedTemplated<Interface, AdvancedService>, "Interface needs to be a non-service class.");
 
             if constexpr (DO_INTERNAL_DEBUG || DO_HARDENING) {
-                if (_registrations.contains(typeNameHash<Interface>())) [[unlikely]] {
+                if (contains(typeNameHash<Interface>())) [[unlikely]] {
                     throw std::runtime_error("Already registered interface");
                 }
+                if (_svc != nullptr && _svc != svc) [[unlikely]] {
+                    throw std::runtime_error("All dependencies of a register have to be registered for the same service");
+                }
             }
 
-            _registrations.emplace(typeNameHash<Interface>(), std::make_tuple(
-                    Dependency{typeNameHash<Interface>(), true, 0},
-                    std::function<void(NeverNull<void*>, IService&)>{[svc](NeverNull<void*> dep, IService& isvc){ svc->template addDependencyInstance<Interface>(reinterpret_cast<Interface*>(dep.get()), &isvc); }},
-                    std::function<void(NeverNull<void*>, IService&)>{[svc](NeverNull<void*> dep, IService& isvc){ svc->template removeDependencyInstance<Interface>(reinterpret_cast<Interface*>(dep.get()), &isvc); }},
-                    std::optional<Properties>{}));
+            _svc = svc;
+            _registrations.push_back(DependencyRegistration{Dependency{typeNameHash<Interface>(), true, 0}, &constructorThunks<Impl, Interface>, std::optional<Properties>{}});
+        }
+
+        /// \param interfaceHash
+        /// \return registration for given interface or nullptr
+        [[nodiscard]] DependencyRegistration const * find(uint64_t interfaceHash) const noexcept {
+            for(auto const &reg : _registrations) {
+                if(reg.dependency.interfaceNameHash == interfaceHash) {
+                    return &reg;
+                }
+            }
+            return nullptr;
+        }
+
+        [[nodiscard]] bool contains(uint64_t interfaceHash) const noexcept {
+            return find(interfaceHash) != nullptr;
         }
 
-        unordered_map<uint64_t, std::tuple<Dependency, std::function<void(NeverNull<void*>, IService&)>, std::function<void(NeverNull<void*>, IService&)>, std::optional<Properties>>> _registrations;
+        [[nodiscard]] Detail::DependencyInjector adder(DependencyRegistration const &reg) const noexcept {
+            return Detail::DependencyInjector{reg.thunks->add, _svc};
+        }
+
+        [[nodiscard]] Detail::DependencyInjector remover(DependencyRegistration const &reg) const noexcept {
+            return Detail::DependencyInjector{reg.thunks->remove, _svc};
+        }
+
+        // Services usually only have a handful of dependencies, a linear search is faster than a map for those.
+        std::vector<DependencyRegistration> _registrations;
+
+    private:
+        template <typename Impl, typename Interface>
+        static void addAdvanced(void *svc, NeverNull<void*> dep, IService &isvc) {
+            static_cast<Impl*>(svc)->addDependencyInstance(*reinterpret_cast<Interface*>(dep.get()), isvc);
+        }
+
+        template <typename Impl, typename Interface>
+        static void removeAdvanced(void *svc, NeverNull<void*> dep, IService &isvc) {
+            static_cast<Impl*>(svc)->removeDependencyInstance(*reinterpret_cast<Interface*>(dep.get()), isvc);
+        }
+
+        template <typename Impl, typename Interface>
+        static void addConstructor(void *svc, NeverNull<void*> dep, IService &isvc) {
+            static_cast<Impl*>(svc)->template addDependencyInstance<Interface>(reinterpret_cast<Interface*>(dep.get()), &isvc);
+        }
+
+        template <typename Impl, typename Interface>
+        static void removeConstructor(void *svc, NeverNull<void*> dep, IService &isvc) {
+            static_cast<Impl*>(svc)->template removeDependencyInstance<Interface>(reinterpret_cast<Interface*>(dep.get()), &isvc);
+        }
+
+        template <typename Impl, typename Interface>
+        static constexpr Detail::DependencyThunks advancedThunks{&addAdvanced<Impl, Interface>, &removeAdvanced<Impl, Interface>};
+
+        template <typename Impl, typename Interface>
+        static constexpr Detail::DependencyThunks constructorThunks{&addConstructor<Impl, Interface>, &removeConstructor<Impl, Interface>};
+
+        void *_svc{};
     };
 }
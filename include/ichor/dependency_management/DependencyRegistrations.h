@@ -29,18 +29,19 @@ namespace Ichor {
 
     class [[nodiscard]] EventHandlerRegistration final {
     public:
-        EventHandlerRegistration(CallbackKey key, uint64_t priority) noexcept : _key(key), _priority(priority) {}
+        EventHandlerRegistration(CallbackKey key, uint64_t priority, std::optional<uint64_t> targetServiceId = {}) noexcept : _key(key), _priority(priority), _targetServiceId(targetServiceId) {}
         EventHandlerRegistration() noexcept = default;
         ~EventHandlerRegistration();
 
         EventHandlerRegistration(const EventHandlerRegistration&) = delete;
-        EventHandlerRegistration(EventHandlerRegistration&& o) noexcept : _key(o._key), _priority(o._priority) {
+        EventHandlerRegistration(EventHandlerRegistration&& o) noexcept : _key(o._key), _priority(o._priority), _targetServiceId(o._targetServiceId) {
             o._key.type = 0;
         }
         EventHandlerRegistration& operator=(const EventHandlerRegistration&) = delete;
         EventHandlerRegistration& operator=(EventHandlerRegistration&& o) noexcept {
             _key = o._key;
             _priority = o._priority;
+            _targetServiceId = o._targetServiceId;
             o._key.type = 0;
             return *this;
         }
@@ -49,6 +50,7 @@ namespace Ichor {
     private:
         CallbackKey _key{0, 0};
         uint64_t _priority{0};
+        std::optional<uint64_t> _targetServiceId{};
     };
 
     class [[nodiscard]] EventInterceptorRegistration final {
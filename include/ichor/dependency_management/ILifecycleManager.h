@@ -16,12 +16,22 @@ namespace Ichor {
         // iterators come from interestedInDependency() and have to be moved as using coroutines might end up clearing it.
         virtual AsyncGenerator<StartBehaviour> dependencyOnline(NeverNull<ILifecycleManager*> dependentService, std::vector<decltype(std::declval<DependencyInfo>().begin())> iterators) = 0;
         virtual AsyncGenerator<StartBehaviour> dependencyOffline(NeverNull<ILifecycleManager*> dependentService, std::vector<decltype(std::declval<DependencyInfo>().begin())> iterators) = 0;
+        /// Fast paths of dependencyOnline()/dependencyOffline() that do not create a coroutine frame. Only handle the change if doing so cannot suspend,
+        /// f.e. because the injection cannot lead to this service starting or stopping.
+        /// \return true if handled, equivalent to dependencyOnline()/dependencyOffline() finishing with StartBehaviour::DONE. False if iterators are untouched and the caller has to use the coroutine variant.
+        [[nodiscard]] virtual bool dependencyOnlineSync(NeverNull<ILifecycleManager*> dependentService, std::vector<decltype(std::declval<DependencyInfo>().begin())> &iterators) = 0;
+        [[nodiscard]] virtual bool dependencyOfflineSync(NeverNull<ILifecycleManager*> dependentService, std::vector<decltype(std::declval<DependencyInfo>().begin())> &iterators) = 0;
         [[nodiscard]] virtual unordered_set<uint64_t> &getDependencies() noexcept = 0;
         [[nodiscard]] virtual unordered_set<uint64_t> &getDependees() noexcept = 0;
         [[nodiscard]] virtual AsyncGenerator<StartBehaviour> start() = 0;
         [[nodiscard]] virtual AsyncGenerator<StartBehaviour> stop() = 0;
         [[nodiscard]] virtual bool setInjected() = 0;
         [[nodiscard]] virtual bool setUninjected() = 0;
+        /// A dormant service is not started automatically when its dependencies are satisfied, used for lazy services.
+        virtual void setDormant(bool dormant) noexcept = 0;
+        /// Keep a copy of the service state up to date in mirror, used by the DependencyManager to scan states without going through the manager.
+        /// \param mirror location to copy the state to, nullptr to stop doing so
+        virtual void setStateMirror(ServiceState *mirror) noexcept = 0;
         [[nodiscard]] virtual std::string_view implementationName() const noexcept = 0;
         [[nodiscard]] virtual uint64_t type() const noexcept = 0;
         [[nodiscard]] virtual uint64_t serviceId() const noexcept = 0;
@@ -32,8 +42,8 @@ namespace Ichor {
         [[nodiscard]] virtual const std::vector<Dependency>& getInterfaces() const noexcept = 0;
         [[nodiscard]] virtual Properties const & getProperties() const noexcept = 0;
         [[nodiscard]] virtual DependencyRegister const * getDependencyRegistry() const noexcept = 0;
-        virtual void insertSelfInto(uint64_t keyOfInterfaceToInject, uint64_t serviceIdOfOther, std::function<void(NeverNull<void*>, IService&)>&) = 0;
-        virtual void removeSelfInto(uint64_t keyOfInterfaceToInject, uint64_t serviceIdOfOther, std::function<void(NeverNull<void*>, IService&)>&) = 0;
+        virtual void insertSelfInto(uint64_t keyOfInterfaceToInject, uint64_t serviceIdOfOther, Detail::DependencyInjector const &) = 0;
+        virtual void removeSelfInto(uint64_t keyOfInterfaceToInject, uint64_t serviceIdOfOther, Detail::DependencyInjector const &) = 0;
 
     protected:
         static Ichor::AsyncGenerator<void> waitForService(uint64_t serviceId, uint64_t eventType) noexcept;
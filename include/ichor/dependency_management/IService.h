@@ -7,6 +7,56 @@
 #include <ichor/Enums.h>
 
 namespace Ichor {
+    namespace Detail {
+        /// Service ids consist of a slot in the lower 32 bits and the generation of that slot in the upper 32 bits.
+        /// The slot of a destroyed service is reused with the next generation, ids themselves are never reused.
+        /// \return id for a new service, never 0
+        [[nodiscard]] uint64_t reserveServiceId() noexcept;
+        /// Makes the slot of id available again, called when the service with that id is destroyed
+        void releaseServiceId(uint64_t id) noexcept;
+
+        [[nodiscard]] constexpr uint32_t serviceIdSlot(uint64_t id) noexcept {
+            return static_cast<uint32_t>(id);
+        }
+
+        [[nodiscard]] constexpr uint32_t serviceIdGeneration(uint64_t id) noexcept {
+            return static_cast<uint32_t>(id >> 32u);
+        }
+
+        /// State of a service. Every change is copied to the mirror, if set, which is where the DependencyManager keeps the states of all its services contiguously.
+        class MirroredServiceState final {
+        public:
+            explicit MirroredServiceState(ServiceState state) noexcept : _state(state) {}
+            MirroredServiceState(MirroredServiceState const &other) noexcept : _state(other._state) {}
+            MirroredServiceState& operator=(MirroredServiceState const &other) noexcept {
+                return *this = other._state;
+            }
+            MirroredServiceState& operator=(ServiceState state) noexcept {
+                _state = state;
+                if(_mirror != nullptr) {
+                    *_mirror = state;
+                }
+                return *this;
+            }
+
+            operator ServiceState() const noexcept {
+                return _state;
+            }
+
+            /// \param mirror copy to keep up to date from now on, nullptr to stop doing so
+            void setMirror(ServiceState *mirror) noexcept {
+                _mirror = mirror;
+                if(_mirror != nullptr) {
+                    *_mirror = _state;
+                }
+            }
+
+        private:
+            ServiceState _state;
+            ServiceState *_mirror{};
+        };
+    }
+
     class IService {
     public:
         virtual ~IService() = default;
@@ -26,6 +26,16 @@ namespace Ichor::Detail {
             std::terminate();
         }
 
+        bool dependencyOnlineSync(NeverNull<ILifecycleManager*> dependentService, std::vector<decltype(std::declval<DependencyInfo>().begin())> &iterators) final {
+            // this function should never be called
+            std::terminate();
+        }
+
+        bool dependencyOfflineSync(NeverNull<ILifecycleManager*> dependentService, std::vector<decltype(std::declval<DependencyInfo>().begin())> &iterators) final {
+            // this function should never be called
+            std::terminate();
+        }
+
         [[nodiscard]]
         unordered_set<uint64_t> &getDependencies() noexcept final {
             // this function should never be called
@@ -62,6 +72,15 @@ namespace Ichor::Detail {
             std::terminate();
         }
 
+        void setDormant(bool) noexcept final {
+            // services without dependencies are started explicitly, nothing to defer
+        }
+
+        void setStateMirror(ServiceState *) noexcept final {
+            // this function should never be called
+            std::terminate();
+        }
+
         [[nodiscard]] std::string_view implementationName() const noexcept final {
             return typeName<IService>();
         }
@@ -112,7 +131,7 @@ namespace Ichor::Detail {
         /// \param keyOfInterfaceToInject
         /// \param serviceIdOfOther
         /// \param fn
-        void insertSelfInto(uint64_t keyOfInterfaceToInject, uint64_t serviceIdOfOther, std::function<void(NeverNull<void*>, IService&)> &fn) final {
+        void insertSelfInto(uint64_t keyOfInterfaceToInject, uint64_t serviceIdOfOther, Detail::DependencyInjector const &fn) final {
             if(keyOfInterfaceToInject != typeNameHash<IService>()) {
                 return;
             }
@@ -125,7 +144,7 @@ namespace Ichor::Detail {
         /// \param keyOfInterfaceToInject
         /// \param serviceIdOfOther
         /// \param fn
-        void removeSelfInto(uint64_t keyOfInterfaceToInject, uint64_t serviceIdOfOther, std::function<void(NeverNull<void*>, IService&)> &fn) final {
+        void removeSelfInto(uint64_t keyOfInterfaceToInject, uint64_t serviceIdOfOther, Detail::DependencyInjector const &fn) final {
             if(keyOfInterfaceToInject != typeNameHash<IService>()) {
                 return;
             }
@@ -6,7 +6,7 @@ namespace Ichor::Detail {
 
     class InternalService : public IService {
     public:
-        InternalService() noexcept : IService(), _properties(), _serviceId(Detail::_serviceIdCounter.fetch_add(1, std::memory_order_relaxed)), _servicePriority(INTERNAL_EVENT_PRIORITY), _serviceGid(sole::uuid4()), _serviceState(ServiceState::INSTALLED) {
+        InternalService() noexcept : IService(), _properties(), _serviceId(Detail::reserveServiceId()), _servicePriority(INTERNAL_EVENT_PRIORITY), _serviceGid(sole::uuid4()), _serviceState(ServiceState::INSTALLED) {
         }
 
         ~InternalService() noexcept override {
@@ -22,7 +22,9 @@ namespace Ichor::Detail {
             _service.setProperties(std::forward<Properties>(properties));
         }
 
-        ~LifecycleManager() final = default;
+        ~LifecycleManager() final {
+            releaseServiceId(_service.getServiceId());
+        }
 
         template<typename... Interfaces>
         [[nodiscard]]
@@ -50,6 +52,16 @@ namespace Ichor::Detail {
             co_return StartBehaviour::DONE;
         }
 
+        bool dependencyOnlineSync(NeverNull<ILifecycleManager*> dependentService, std::vector<decltype(std::declval<DependencyInfo>().begin())> &iterators) final {
+            // this function should never be called
+            std::terminate();
+        }
+
+        bool dependencyOfflineSync(NeverNull<ILifecycleManager*> dependentService, std::vector<decltype(std::declval<DependencyInfo>().begin())> &iterators) final {
+            // this function should never be called
+            std::terminate();
+        }
+
         [[nodiscard]]
         unordered_set<uint64_t> &getDependencies() noexcept final {
             return emptyDependencies;
@@ -80,6 +92,14 @@ namespace Ichor::Detail {
             return _service.internalSetUninjected();
         }
 
+        void setDormant(bool) noexcept final {
+            // services without dependencies are started explicitly, nothing to defer
+        }
+
+        void setStateMirror(ServiceState *mirror) noexcept final {
+            _service._serviceState.setMirror(mirror);
+        }
+
         [[nodiscard]] std::string_view implementationName() const noexcept final {
             return _service.getServiceName();
         }
@@ -128,7 +148,7 @@ namespace Ichor::Detail {
         /// \param keyOfInterfaceToInject
         /// \param serviceIdOfOther
         /// \param fn
-        void insertSelfInto(uint64_t keyOfInterfaceToInject, uint64_t serviceIdOfOther, std::function<void(NeverNull<void*>, IService&)> &fn) final {
+        void insertSelfInto(uint64_t keyOfInterfaceToInject, uint64_t serviceIdOfOther, Detail::DependencyInjector const &fn) final {
             if constexpr (sizeof...(IFaces) > 0) {
                 insertSelfInto2<sizeof...(IFaces), IFaces...>(keyOfInterfaceToInject, fn);
                 _serviceIdsOfDependees.insert(serviceIdOfOther);
@@ -140,7 +160,7 @@ namespace Ichor::Detail {
         /// \param serviceIdOfOther
         /// \param fn
         template <int i, typename Iface1, typename... otherIfaces>
-        void insertSelfInto2(uint64_t keyOfInterfaceToInject, std::function<void(NeverNull<void*>, IService&)> &fn) {
+        void insertSelfInto2(uint64_t keyOfInterfaceToInject, Detail::DependencyInjector const &fn) {
             if(typeNameHash<Iface1>() == keyOfInterfaceToInject) {
                 fn(static_cast<Iface1*>(_service.getImplementation()), static_cast<IService&>(_service));
             } else {
@@ -154,7 +174,7 @@ namespace Ichor::Detail {
         /// \param keyOfInterfaceToInject
         /// \param serviceIdOfOther
         /// \param fn
-        void removeSelfInto(uint64_t keyOfInterfaceToInject, uint64_t serviceIdOfOther, std::function<void(NeverNull<void*>, IService&)> &fn) final {
+        void removeSelfInto(uint64_t keyOfInterfaceToInject, uint64_t serviceIdOfOther, Detail::DependencyInjector const &fn) final {
             INTERNAL_DEBUG("removeSelfInto2() svc {} removing svc {}", serviceId(), serviceIdOfOther);
             if constexpr (sizeof...(IFaces) > 0) {
                 insertSelfInto2<sizeof...(IFaces), IFaces...>(keyOfInterfaceToInject, fn);
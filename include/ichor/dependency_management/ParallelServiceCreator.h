@@ -0,0 +1,139 @@
+#pragma once
+
+#include <ichor/DependencyManager.h>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <thread>
+
+namespace Ichor {
+    /// Opt-in way of creating many services at once, with their constructors running on a pool of worker threads.
+    /// The constructed services are handed to the DependencyManager afterwards, injection and start() happen on the DependencyManager thread as usual.
+    ///
+    /// Only use this for services whose constructors are independent of each other and do not use the thread local DependencyManager or event queue
+    /// (GetThreadLocalManager(), GetThreadLocalEventQueue()), as those are not available on the worker threads.
+    /// For constructor injection services only the registration of dependencies runs on the workers, the service itself is constructed once its dependencies are available.
+    /// Services are handed over in the order they were added, a framework logger added first logs the creation of the others.
+    ///
+    /// Usage:
+    ///     ParallelServiceCreator creator{dm};
+    ///     creator.add<SomeService, ISomeService>(Properties{...});
+    ///     creator.add<OtherService>();
+    ///     auto ids = creator.create();
+    class ParallelServiceCreator final {
+    public:
+        explicit ParallelServiceCreator(DependencyManager &dm) noexcept : _dm(dm) {}
+
+        /// Queue a service to be created, mirrors DependencyManager::createServiceManager
+        /// \tparam Impl AdvancedService or constructor injection service
+        /// \tparam Interfaces interfaces provided by Impl
+        /// \param properties properties of the service
+        /// \param priority priority of the service
+        template<typename Impl, typename... Interfaces>
+#if (!defined(WIN32) && !defined(_WIN32) && !defined(__WIN32)) || defined(__CYGWIN__)
+        requires ImplementsAll<Impl, Interfaces...>
+#endif
+        void add(Properties&& properties = {}, uint64_t priority = INTERNAL_EVENT_PRIORITY) {
+            if constexpr (DerivedTemplated<Impl, AdvancedService>) {
+                _jobs.push_back(Job{[properties = std::move(properties)]() mutable -> std::unique_ptr<ILifecycleManager> {
+                    return createManager<Impl, Interfaces...>(std::move(properties));
+                }, &insertManager<Impl, Interfaces...>, priority, {}, {}});
+            } else {
+                _jobs.push_back(Job{[properties = std::move(properties)]() mutable -> std::unique_ptr<ILifecycleManager> {
+                    return createManager<ConstructorInjectionService<Impl>, Interfaces...>(std::move(properties));
+                }, &insertManager<ConstructorInjectionService<Impl>, Interfaces...>, priority, {}, {}});
+            }
+        }
+
+        /// Runs all queued constructors on up to threads worker threads and hands the constructed services to the DependencyManager, in the order they were added.
+        /// Has to be called either before the DependencyManager is started or on its thread. If a constructor throws, the other services are still created
+        /// and the first exception is rethrown afterwards.
+        /// \param threads maximum amount of worker threads, 0 means std::thread::hardware_concurrency()
+        /// \return service ids, in the order the services were added
+        std::vector<uint64_t> create(uint32_t threads = 0) {
+            if(threads == 0) {
+                threads = std::max(1u, std::thread::hardware_concurrency());
+            }
+            threads = std::min(threads, static_cast<uint32_t>(_jobs.size()));
+
+            std::atomic<size_t> next{};
+            auto work = [this, &next]() {
+                for(size_t i = next.fetch_add(1, std::memory_order_relaxed); i < _jobs.size(); i = next.fetch_add(1, std::memory_order_relaxed)) {
+                    auto &job = _jobs[i];
+                    try {
+                        job.mgr = job.construct();
+                    } catch (...) {
+                        job.error = std::current_exception();
+                    }
+                }
+            };
+
+            std::vector<std::thread> workers{};
+            if(threads > 1) {
+                workers.reserve(threads - 1);
+                for(uint32_t i = 1; i < threads; i++) {
+                    workers.emplace_back(work);
+                }
+            }
+            work();
+            for(auto &worker : workers) {
+                worker.join();
+            }
+
+            std::vector<uint64_t> ids{};
+            ids.reserve(_jobs.size());
+            std::exception_ptr firstError{};
+            for(auto &job : _jobs) {
+                if(job.error) {
+                    if(!firstError) {
+                        firstError = job.error;
+                    }
+                    continue;
+                }
+
+                ids.push_back(job.mgr->serviceId());
+                job.insert(_dm, std::move(job.mgr), job.priority);
+            }
+            _jobs.clear();
+
+            if(firstError) {
+                std::rethrow_exception(firstError);
+            }
+
+            return ids;
+        }
+
+    private:
+        template<typename ServiceT, typename... Interfaces>
+        static std::unique_ptr<ILifecycleManager> createManager(Properties&& properties) {
+            if constexpr (RequestsDependencies<ServiceT>) {
+                return Detail::DependencyLifecycleManager<ServiceT>::template create<>(std::move(properties), InterfacesList<Interfaces...>);
+            } else {
+                return Detail::LifecycleManager<ServiceT, Interfaces...>::template create<>(std::move(properties), InterfacesList<Interfaces...>);
+            }
+        }
+
+        // Hands the manager to the DependencyManager with its concrete type, so it gets the same bookkeeping as services created there directly
+        template<typename ServiceT, typename... Interfaces>
+        static void insertManager(DependencyManager &dm, std::unique_ptr<ILifecycleManager> mgr, uint64_t priority) {
+            if constexpr (RequestsDependencies<ServiceT>) {
+                using ManagerT = Detail::DependencyLifecycleManager<ServiceT>;
+                dm.registerServiceManager<ServiceT, Interfaces...>(std::unique_ptr<ManagerT>(static_cast<ManagerT *>(mgr.release())), priority);
+            } else {
+                using ManagerT = Detail::LifecycleManager<ServiceT, Interfaces...>;
+                dm.registerServiceManager<ServiceT, Interfaces...>(std::unique_ptr<ManagerT>(static_cast<ManagerT *>(mgr.release())), priority);
+            }
+        }
+
+        struct Job final {
+            std::function<std::unique_ptr<ILifecycleManager>()> construct;
+            void (*insert)(DependencyManager &, std::unique_ptr<ILifecycleManager>, uint64_t);
+            uint64_t priority;
+            std::unique_ptr<ILifecycleManager> mgr;
+            std::exception_ptr error;
+        };
+
+        DependencyManager &_dm;
+        std::vector<Job> _jobs{};
+    };
+}
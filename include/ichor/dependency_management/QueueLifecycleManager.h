@@ -12,7 +12,9 @@ namespace Ichor::Detail {
             _interfaces.emplace_back(typeNameHash<IEventQueue>(), false, false);
         }
 
-        ~QueueLifecycleManager() final = default;
+        ~QueueLifecycleManager() final {
+            releaseServiceId(_service.getServiceId());
+        }
 
         std::vector<decltype(std::declval<DependencyInfo>().begin())> interestedInDependency(ILifecycleManager *dependentService, bool online) noexcept final {
             return {};
@@ -30,6 +32,16 @@ namespace Ichor::Detail {
             co_return StartBehaviour::DONE;
         }
 
+        bool dependencyOnlineSync(NeverNull<ILifecycleManager*> dependentService, std::vector<decltype(std::declval<DependencyInfo>().begin())> &iterators) final {
+            // this function should never be called
+            std::terminate();
+        }
+
+        bool dependencyOfflineSync(NeverNull<ILifecycleManager*> dependentService, std::vector<decltype(std::declval<DependencyInfo>().begin())> &iterators) final {
+            // this function should never be called
+            std::terminate();
+        }
+
         [[nodiscard]]
         unordered_set<uint64_t> &getDependencies() noexcept final {
             return emptyDependencies;
@@ -62,6 +74,14 @@ namespace Ichor::Detail {
             return true;
         }
 
+        void setDormant(bool) noexcept final {
+            // services without dependencies are started explicitly, nothing to defer
+        }
+
+        void setStateMirror(ServiceState *mirror) noexcept final {
+            _state.setMirror(mirror);
+        }
+
         [[nodiscard]] std::string_view implementationName() const noexcept final {
             return "IEventQueue";
         }
@@ -106,7 +126,7 @@ namespace Ichor::Detail {
         /// \param keyOfInterfaceToInject
         /// \param serviceIdOfOther
         /// \param fn
-        void insertSelfInto(uint64_t keyOfInterfaceToInject, uint64_t serviceIdOfOther, std::function<void(NeverNull<void*>, IService&)> &fn) final {
+        void insertSelfInto(uint64_t keyOfInterfaceToInject, uint64_t serviceIdOfOther, Detail::DependencyInjector const &fn) final {
             if(keyOfInterfaceToInject != typeNameHash<IEventQueue>()) {
                 return;
             }
@@ -120,7 +140,7 @@ namespace Ichor::Detail {
         /// \param keyOfInterfaceToInject
         /// \param serviceIdOfOther
         /// \param fn
-        void removeSelfInto(uint64_t keyOfInterfaceToInject, uint64_t serviceIdOfOther, std::function<void(NeverNull<void*>, IService&)> &fn) final {
+        void removeSelfInto(uint64_t keyOfInterfaceToInject, uint64_t serviceIdOfOther, Detail::DependencyInjector const &fn) final {
             if(keyOfInterfaceToInject != typeNameHash<IEventQueue>()) {
                 return;
             }
@@ -132,7 +152,7 @@ namespace Ichor::Detail {
 
     private:
         IEventQueue *_q;
-        ServiceState _state{ServiceState::ACTIVE};
+        MirroredServiceState _state{ServiceState::ACTIVE};
         unordered_set<uint64_t> _serviceIdsOfDependees; // services that depend on this service
         std::vector<Dependency> _interfaces;
         InternalService _service;
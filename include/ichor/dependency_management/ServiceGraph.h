@@ -0,0 +1,153 @@
+#pragma once
+
+#include <ichor/Common.h>
+#include <array>
+#include <cstdint>
+
+namespace Ichor {
+    /// Node of a ServiceGraph: Impl is created as a service providing Interfaces and gets the graph services providing Required injected statically.
+    /// Required has to list the interfaces Impl registers as required dependencies, hardened builds check this when the service is created.
+    /// Impl can still request other (optional) dependencies, those are resolved dynamically, like any other service.
+    /// \tparam Impl either an AdvancedService or a constructor injection service
+    /// \tparam Interfaces InterfacesList_t of provided interfaces
+    /// \tparam Required RequiredList_t of interfaces that have to be provided by exactly one other service in the graph
+    template <typename Impl, typename Interfaces = InterfacesList_t<>, typename Required = RequiredList_t<>>
+    struct GraphService;
+
+    template <typename Impl, typename... Interfaces, typename... Required>
+    struct GraphService<Impl, InterfacesList_t<Interfaces...>, RequiredList_t<Required...>> final {
+        static constexpr std::array<uint64_t, sizeof...(Interfaces)> provides{typeNameHash<Interfaces>()...};
+        static constexpr std::array<uint64_t, sizeof...(Required)> required{typeNameHash<Required>()...};
+    };
+
+    enum class ServiceGraphError : uint_fast16_t {
+        NONE,
+        MISSING_PROVIDER,
+        AMBIGUOUS_PROVIDER,
+        CYCLE
+    };
+
+    namespace Detail {
+        struct ServiceGraphEdge final {
+            size_t provider;
+            size_t dependent;
+        };
+
+        template <size_t N>
+        struct ServiceGraphOrder final {
+            std::array<size_t, N> order{};
+            size_t amount{};
+        };
+
+        template <typename Array>
+        constexpr bool graphArrayContains(Array const &arr, uint64_t hash) noexcept {
+            for(auto val : arr) {
+                if(val == hash) {
+                    return true;
+                }
+            }
+            return false;
+        }
+    }
+
+    /// Service graph known at compile time. Every required interface of every node needs exactly one provider in the graph and the graph has to be acyclic,
+    /// DependencyManager::createServiceGraph rejects graphs violating that at compile time. All wiring and the start order are computed at compile time.
+    /// \tparam Nodes GraphService types
+    template <typename... Nodes>
+    struct ServiceGraph final {
+        using NodeList = typeList<Nodes...>;
+        static constexpr size_t size = sizeof...(Nodes);
+        static constexpr size_t edgeCount = (Nodes::required.size() + ... + 0);
+
+        [[nodiscard]] static constexpr size_t providerCount(uint64_t interfaceHash) noexcept {
+            size_t count{};
+            ((count += Detail::graphArrayContains(Nodes::provides, interfaceHash) ? 1 : 0), ...);
+            return count;
+        }
+
+        /// \return index of the first node providing interfaceHash, or size if none
+        [[nodiscard]] static constexpr size_t providerIndex(uint64_t interfaceHash) noexcept {
+            size_t idx{size};
+            size_t i{};
+            ([&]() {
+                if(idx == size && Detail::graphArrayContains(Nodes::provides, interfaceHash)) {
+                    idx = i;
+                }
+                i++;
+            }(), ...);
+            return idx;
+        }
+
+    private:
+        static constexpr std::array<Detail::ServiceGraphEdge, edgeCount> computeEdges() noexcept {
+            std::array<Detail::ServiceGraphEdge, edgeCount> ret{};
+            size_t e{};
+            size_t dependent{};
+            ([&]() {
+                for(auto hash : Nodes::required) {
+                    ret[e++] = Detail::ServiceGraphEdge{providerIndex(hash), dependent};
+                }
+                dependent++;
+            }(), ...);
+            return ret;
+        }
+
+        static constexpr ServiceGraphError computeProviderError() noexcept {
+            ServiceGraphError ret{ServiceGraphError::NONE};
+            ([&]() {
+                for(auto hash : Nodes::required) {
+                    auto count = providerCount(hash);
+                    if(count == 0) {
+                        ret = ServiceGraphError::MISSING_PROVIDER;
+                    } else if(count > 1 && ret == ServiceGraphError::NONE) {
+                        ret = ServiceGraphError::AMBIGUOUS_PROVIDER;
+                    }
+                }
+            }(), ...);
+            return ret;
+        }
+
+        // Kahn's algorithm, providers are started before their dependents. Ties are broken by declaration order.
+        static constexpr Detail::ServiceGraphOrder<size> computeOrder() noexcept {
+            Detail::ServiceGraphOrder<size> ret{};
+            std::array<size_t, size> inDegree{};
+            std::array<bool, size> done{};
+
+            for(auto const &edge : edges) {
+                if(edge.provider < size) {
+                    inDegree[edge.dependent]++;
+                }
+            }
+
+            bool progress = true;
+            while(progress) {
+                progress = false;
+                for(size_t i = 0; i < size; i++) {
+                    if(done[i] || inDegree[i] != 0) {
+                        continue;
+                    }
+
+                    done[i] = true;
+                    progress = true;
+                    ret.order[ret.amount++] = i;
+
+                    for(auto const &edge : edges) {
+                        if(edge.provider == i) {
+                            inDegree[edge.dependent]--;
+                        }
+                    }
+                }
+            }
+
+            return ret;
+        }
+
+    public:
+        /// (provider, dependent) node indices for every required interface of every node
+        static constexpr std::array<Detail::ServiceGraphEdge, edgeCount> edges = computeEdges();
+        static constexpr Detail::ServiceGraphOrder<size> order = computeOrder();
+        static constexpr ServiceGraphError error = computeProviderError() != ServiceGraphError::NONE ? computeProviderError() : (order.amount != size ? ServiceGraphError::CYCLE : ServiceGraphError::NONE);
+        /// node indices in the order in which they are started
+        static constexpr std::array<size_t, size> startOrder = order.order;
+    };
+}
@@ -0,0 +1,245 @@
+#pragma once
+
+#include <ichor/dependency_management/ILifecycleManager.h>
+#include <ichor/dependency_management/ServicesView.h>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace Ichor::Detail {
+    /// The services of a DependencyManager, keyed by service id and stored contiguously.
+    /// The slot part of an id (see reserveServiceId()) indexes a table holding the position of the service, lookups then compare the full id.
+    /// Ids of removed services therefore never find the service that reuses their slot. The state of every service is mirrored in a second array
+    /// in the same order, so that scans filtering on state do not have to go through the lifecycle managers.
+    /// Ids do not reflect creation order as slots are reused, the order of insertion is tracked separately.
+    /// Interface pointers of a service are cached alongside it once resolved through resolveInterface().
+    ///
+    /// emplace invalidates iterators, erase moves the last element into the erased position.
+    class ServiceMap final {
+    public:
+        using value_type = std::pair<uint64_t, std::unique_ptr<ILifecycleManager>>;
+        using iterator = std::vector<value_type>::iterator;
+        using const_iterator = std::vector<value_type>::const_iterator;
+
+        ServiceMap() noexcept = default;
+        ServiceMap(ServiceMap const &) = delete;
+        ServiceMap(ServiceMap &&) = delete;
+        ServiceMap& operator=(ServiceMap const &) = delete;
+        ServiceMap& operator=(ServiceMap &&) = delete;
+
+        ~ServiceMap() noexcept {
+            clear();
+        }
+
+        [[nodiscard]] iterator begin() noexcept {
+            return _services.begin();
+        }
+
+        [[nodiscard]] iterator end() noexcept {
+            return _services.end();
+        }
+
+        [[nodiscard]] const_iterator begin() const noexcept {
+            return _services.begin();
+        }
+
+        [[nodiscard]] const_iterator end() const noexcept {
+            return _services.end();
+        }
+
+        [[nodiscard]] size_t size() const noexcept {
+            return _services.size();
+        }
+
+        [[nodiscard]] bool empty() const noexcept {
+            return _services.empty();
+        }
+
+        [[nodiscard]] iterator find(uint64_t id) noexcept {
+            auto const index = indexOf(id);
+            if(index == npos) {
+                return end();
+            }
+            return begin() + static_cast<std::ptrdiff_t>(index);
+        }
+
+        [[nodiscard]] const_iterator find(uint64_t id) const noexcept {
+            auto const index = indexOf(id);
+            if(index == npos) {
+                return end();
+            }
+            return begin() + static_cast<std::ptrdiff_t>(index);
+        }
+
+        [[nodiscard]] bool contains(uint64_t id) const noexcept {
+            return indexOf(id) != npos;
+        }
+
+        /// \param pos valid, dereferenceable iterator
+        /// \return state of the service at pos, equal to pos->second->getServiceState()
+        [[nodiscard]] ServiceState state(const_iterator pos) const noexcept {
+            return _states[static_cast<size_t>(pos - begin())];
+        }
+
+        /// \param pos valid, dereferenceable iterator
+        /// \param interfaceHash
+        /// \return nullopt if the service at pos does not provide interfaceHash, otherwise a pointer to its interfaceHash part, which is nullptr if it cannot be resolved yet
+        [[nodiscard]] std::optional<void*> resolveInterface(const_iterator pos, uint64_t interfaceHash) const {
+            auto const &interfaces = pos->second->getInterfaces();
+            auto intf = std::find_if(interfaces.begin(), interfaces.end(), [interfaceHash](Dependency const &dep) { return dep.interfaceNameHash == interfaceHash; });
+            if(intf == interfaces.end()) {
+                return {};
+            }
+
+            auto &impls = _interfaceImpls[static_cast<size_t>(pos - begin())];
+            if(impls.empty()) {
+                impls.resize(interfaces.size(), nullptr);
+            }
+
+            auto &impl = impls[static_cast<size_t>(intf - interfaces.begin())];
+            if(impl == nullptr) {
+                InterfaceProvider provider{pos->second.get(), nullptr};
+                impl = resolveInterfaceProvider(provider, interfaceHash);
+            }
+            return impl;
+        }
+
+        /// \return all services in the order they were inserted
+        [[nodiscard]] std::vector<ILifecycleManager *> inInsertionOrder() const {
+            std::vector<std::pair<uint64_t, ILifecycleManager *>> ordered{};
+            ordered.reserve(_services.size());
+            for(size_t i = 0; i < _services.size(); i++) {
+                ordered.emplace_back(_insertionSequences[i], _services[i].second.get());
+            }
+            std::sort(ordered.begin(), ordered.end(), [](auto const &a, auto const &b) {
+                return a.first < b.first;
+            });
+
+            std::vector<ILifecycleManager *> managers{};
+            managers.reserve(ordered.size());
+            for(auto const &[sequence, mgr] : ordered) {
+                managers.push_back(mgr);
+            }
+            return managers;
+        }
+
+        /// Inserts the manager constructed from args if no service with id is present yet
+        /// \param id service id of the manager
+        /// \param args arguments to construct a std::unique_ptr<ILifecycleManager> from, only used if inserted
+        /// \return iterator to the service with id and true if inserted
+        template <typename... Args>
+        std::pair<iterator, bool> emplace(uint64_t id, Args&&... args) {
+            auto const slot = serviceIdSlot(id);
+
+            if(slot < _indexBySlot.size() && _indexBySlot[slot] != npos) {
+                auto const index = _indexBySlot[slot];
+                // another generation of the slot still being present means its id was released before the service was destroyed
+                if(_services[index].first != id) [[unlikely]] {
+                    std::terminate();
+                }
+                return {begin() + static_cast<std::ptrdiff_t>(index), false};
+            }
+
+            if(slot >= _indexBySlot.size()) {
+                _indexBySlot.resize(static_cast<size_t>(slot) + 1, npos);
+            }
+
+            auto const *oldStates = _states.data();
+            _services.emplace_back(std::piecewise_construct, std::forward_as_tuple(id), std::forward_as_tuple(std::forward<Args>(args)...));
+            _states.push_back(ServiceState::UNINSTALLED);
+            _insertionSequences.push_back(_nextInsertionSequence++);
+            _interfaceImpls.emplace_back();
+            _indexBySlot[slot] = static_cast<uint32_t>(_services.size() - 1);
+
+            if(_states.data() != oldStates) {
+                for(size_t i = 0; i < _services.size(); i++) {
+                    _services[i].second->setStateMirror(&_states[i]);
+                }
+            } else {
+                _services.back().second->setStateMirror(&_states.back());
+            }
+
+            return {end() - 1, true};
+        }
+
+        /// Erases the service at pos, moving the last service into its place. The erased service is destroyed after the map is updated.
+        void erase(const_iterator pos) {
+            auto const index = static_cast<size_t>(pos - begin());
+            auto const last = _services.size() - 1;
+
+            std::unique_ptr<ILifecycleManager> erased = std::move(_services[index].second);
+            erased->setStateMirror(nullptr);
+            _indexBySlot[serviceIdSlot(_services[index].first)] = npos;
+
+            if(index != last) {
+                _services[index] = std::move(_services[last]);
+                _states[index] = _states[last];
+                _insertionSequences[index] = _insertionSequences[last];
+                _interfaceImpls[index] = std::move(_interfaceImpls[last]);
+                _indexBySlot[serviceIdSlot(_services[index].first)] = static_cast<uint32_t>(index);
+                _services[index].second->setStateMirror(&_states[index]);
+            }
+
+            _services.pop_back();
+            _states.pop_back();
+            _insertionSequences.pop_back();
+            _interfaceImpls.pop_back();
+        }
+
+        void clear() noexcept {
+            for(auto &[id, mgr] : _services) {
+                mgr->setStateMirror(nullptr);
+            }
+            _services.clear();
+            _states.clear();
+            _insertionSequences.clear();
+            _interfaceImpls.clear();
+            _indexBySlot.clear();
+        }
+
+    private:
+        static constexpr uint32_t npos = std::numeric_limits<uint32_t>::max();
+
+        [[nodiscard]] uint32_t indexOf(uint64_t id) const noexcept {
+            auto const slot = serviceIdSlot(id);
+            if(slot >= _indexBySlot.size()) {
+                return npos;
+            }
+
+            auto const index = _indexBySlot[slot];
+            if(index == npos || _services[index].first != id) {
+                return npos;
+            }
+
+            return index;
+        }
+
+        std::vector<value_type> _services{};
+        std::vector<ServiceState> _states{}; // same order as _services
+        std::vector<uint64_t> _insertionSequences{}; // same order as _services
+        mutable std::vector<std::vector<void*>> _interfaceImpls{}; // same order as _services, per interface in getInterfaces() order, empty until first resolved
+        std::vector<uint32_t> _indexBySlot{}; // index into _services, npos for slots without a service
+        uint64_t _nextInsertionSequence{};
+    };
+
+    inline ServiceMap::iterator begin(ServiceMap &map) noexcept {
+        return map.begin();
+    }
+
+    inline ServiceMap::iterator end(ServiceMap &map) noexcept {
+        return map.end();
+    }
+
+    inline ServiceMap::const_iterator begin(ServiceMap const &map) noexcept {
+        return map.begin();
+    }
+
+    inline ServiceMap::const_iterator end(ServiceMap const &map) noexcept {
+        return map.end();
+    }
+}
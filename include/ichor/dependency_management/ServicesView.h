@@ -0,0 +1,116 @@
+#pragma once
+
+#include <ichor/dependency_management/ILifecycleManager.h>
+#include <ichor/stl/NeverAlwaysNull.h>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Ichor {
+    namespace Detail {
+        /// Entry in the per-interface indices of the DependencyManager
+        struct InterfaceProvider final {
+            ILifecycleManager *mgr;
+            void *impl; // the Interface part of the service, nullptr until first resolved. Stays valid as long as mgr exists.
+        };
+
+        inline void* resolveInterfaceProvider(InterfaceProvider &provider, uint64_t interfaceHash) {
+            if(provider.impl == nullptr) {
+                DependencyInjector f{[](void *ctx, NeverNull<void*> svc, IService&) { *static_cast<void**>(ctx) = svc.get(); }, &provider.impl};
+                provider.mgr->insertSelfInto(interfaceHash, 0, f);
+                provider.mgr->getDependees().erase(0);
+            }
+            return provider.impl;
+        }
+    }
+
+    /// Non-owning view over the services providing Interface, as returned by DependencyManager::getStartedServices() and DependencyManager::getAllServicesOfType().
+    /// Refers directly to the index the DependencyManager maintains, so creating one does not allocate.
+    /// Services being started, stopped, inserted or removed invalidate the view: copy the elements if they need to survive that, e.g. across a co_await.
+    /// \tparam Interface interface provided by the services
+    /// \tparam StartedOnly true: elements are NeverNull<Interface*>, false: elements are std::pair<Interface&, IService&>
+    template <typename Interface, bool StartedOnly>
+    class ServicesView final {
+    public:
+        using value_type = std::conditional_t<StartedOnly, NeverNull<Interface*>, std::pair<Interface&, IService&>>;
+        using size_type = size_t;
+
+        class iterator final {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = ServicesView::value_type;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = value_type;
+
+            iterator() noexcept = default;
+            iterator(std::vector<Detail::InterfaceProvider> *providers, size_t idx) noexcept : _providers(providers), _idx(idx) {}
+
+            reference operator*() const {
+                return get((*_providers)[_idx]);
+            }
+
+            iterator& operator++() noexcept {
+                ++_idx;
+                return *this;
+            }
+
+            iterator operator++(int) noexcept {
+                auto ret = *this;
+                ++_idx;
+                return ret;
+            }
+
+            friend bool operator==(iterator const &a, iterator const &b) noexcept {
+                return a._idx == b._idx;
+            }
+
+        private:
+            std::vector<Detail::InterfaceProvider> *_providers{};
+            size_t _idx{};
+        };
+
+        ServicesView() noexcept = default;
+        explicit ServicesView(std::vector<Detail::InterfaceProvider> *providers) noexcept : _providers(providers) {}
+
+        [[nodiscard]] size_type size() const noexcept {
+            return _providers == nullptr ? 0 : _providers->size();
+        }
+
+        [[nodiscard]] bool empty() const noexcept {
+            return size() == 0;
+        }
+
+        [[nodiscard]] value_type operator[](size_type idx) const {
+            return get((*_providers)[idx]);
+        }
+
+        [[nodiscard]] iterator begin() const noexcept {
+            return iterator{_providers, 0};
+        }
+
+        [[nodiscard]] iterator end() const noexcept {
+            return iterator{_providers, size()};
+        }
+
+    private:
+        static value_type get(Detail::InterfaceProvider &provider) {
+            auto *impl = static_cast<Interface*>(Detail::resolveInterfaceProvider(provider, typeNameHash<Interface>()));
+            if constexpr (StartedOnly) {
+                return NeverNull<Interface*>(impl);
+            } else {
+                return {*impl, *provider.mgr->getIService()};
+            }
+        }
+
+        std::vector<Detail::InterfaceProvider> *_providers{};
+    };
+
+    template <typename Interface>
+    using StartedServicesView = ServicesView<Interface, true>;
+
+    template <typename Interface>
+    using AllServicesView = ServicesView<Interface, false>;
+}
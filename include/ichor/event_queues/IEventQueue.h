@@ -3,6 +3,8 @@
 #include <cstdint>
 #include <memory>
 #include <atomic>
+#include <chrono>
+#include <optional>
 #include <ichor/events/Event.h>
 #include <ichor/Concepts.h>
 
@@ -78,6 +80,10 @@ namespace Ichor {
         void startDm();
         void processEvent(std::unique_ptr<Event> &&evt);
         void stopDm();
+        /// \return moment at which expireTimers() has to be called, which may be in the past, or nothing if no timer is scheduled
+        [[nodiscard]] std::optional<std::chrono::steady_clock::time_point> nextTimerExpiry() const noexcept;
+        /// Pushes the events of all expired timers of the manager. Has to be called from the manager's thread.
+        void expireTimers();
 
         std::unique_ptr<DependencyManager> _dm;
         std::atomic<uint64_t> _eventIdCounter{0};
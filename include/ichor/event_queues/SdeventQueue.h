@@ -37,6 +37,8 @@ namespace Ichor {
     private:
         void registerEventFd();
         void registerTimer();
+        /// Points the timer wheel source at the manager's next timer expiry, has to be called whenever the manager may have scheduled a timer
+        void armTimerWheel();
 
         mutable Ichor::RealtimeReadWriteMutex _eventQueueMutex{};
 #ifdef ICHOR_USE_ABSEIL
@@ -51,6 +53,7 @@ namespace Ichor {
         std::thread::id _threadId{};
         sd_event_source *_eventfdSource{nullptr};
         sd_event_source *_timerSource{nullptr};
+        sd_event_source *_timerWheelSource{nullptr};
     };
 }
 
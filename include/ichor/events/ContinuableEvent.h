@@ -5,13 +5,14 @@
 #include <optional>
 
 namespace Ichor {
-    struct ContinuableEvent final : public Event {
-        ContinuableEvent(uint64_t _id, uint64_t _originatingService, uint64_t _priority, uint64_t _promiseId) noexcept : Event(TYPE, NAME, _id, _originatingService, _priority), promiseId(_promiseId) {}
-        ~ContinuableEvent() final = default;
+    /// Continues the coroutines in the DependencyManager's ready queue with a priority equal to or more urgent than this event's priority.
+    /// One of these is in the queue for any number of ready coroutines, instead of one event per coroutine.
+    struct ResumeCoroutinesEvent final : public Event {
+        ResumeCoroutinesEvent(uint64_t _id, uint64_t _originatingService, uint64_t _priority) noexcept : Event(TYPE, NAME, _id, _originatingService, _priority) {}
+        ~ResumeCoroutinesEvent() final = default;
 
-        uint64_t promiseId;
-        static constexpr uint64_t TYPE = typeNameHash<ContinuableEvent>();
-        static constexpr std::string_view NAME = typeName<ContinuableEvent>();
+        static constexpr uint64_t TYPE = typeNameHash<ResumeCoroutinesEvent>();
+        static constexpr std::string_view NAME = typeName<ResumeCoroutinesEvent>();
     };
 
     struct ContinuableStartEvent final : public Event {
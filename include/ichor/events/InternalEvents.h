@@ -3,8 +3,10 @@
 #include <ichor/events/Event.h>
 #include <ichor/ConstevalHash.h>
 #include <ichor/dependency_management/Dependency.h>
+#include <ichor/dependency_management/DependencyGraphSnapshot.h>
 #include <ichor/Callbacks.h>
 #include <optional>
+#include <vector>
 
 namespace Ichor {
     /// When a service has succesfully started, this event gets added to inject it into other services
@@ -78,6 +80,31 @@ namespace Ichor {
         static constexpr std::string_view NAME = typeName<StartServiceEvent>();
     };
 
+    /// Starts the services of a ServiceGraph in a precomputed order, injecting the statically known providers directly instead of through DependencyOnlineEvents
+    struct StartServiceGraphEvent final : public Event {
+        struct Node final {
+            uint64_t serviceId;
+            std::vector<uint64_t> providers;
+        };
+
+        StartServiceGraphEvent(uint64_t _id, uint64_t _originatingService, uint64_t _priority, std::vector<Node> _nodes) noexcept : Event(TYPE, NAME, _id, _originatingService, _priority), nodes(std::move(_nodes)) {}
+        ~StartServiceGraphEvent() final = default;
+
+        std::vector<Node> nodes; // in start order
+        static constexpr uint64_t TYPE = typeNameHash<StartServiceGraphEvent>();
+        static constexpr std::string_view NAME = typeName<StartServiceGraphEvent>();
+    };
+
+    /// Validates a snapshot of a previous run against the currently created services and starts them with the recorded wiring if it matches
+    struct ReplayDependencyGraphEvent final : public Event {
+        ReplayDependencyGraphEvent(uint64_t _id, uint64_t _originatingService, uint64_t _priority, DependencyGraphSnapshot _snapshot) noexcept : Event(TYPE, NAME, _id, _originatingService, _priority), snapshot(std::move(_snapshot)) {}
+        ~ReplayDependencyGraphEvent() final = default;
+
+        DependencyGraphSnapshot snapshot;
+        static constexpr uint64_t TYPE = typeNameHash<ReplayDependencyGraphEvent>();
+        static constexpr std::string_view NAME = typeName<ReplayDependencyGraphEvent>();
+    };
+
     struct RemoveServiceEvent final : public Event {
         RemoveServiceEvent(uint64_t _id, uint64_t _originatingService, uint64_t _priority, uint64_t _serviceId) noexcept : Event(TYPE, NAME, _id, _originatingService, _priority), serviceId(_serviceId) {}
         ~RemoveServiceEvent() final = default;
@@ -95,6 +122,25 @@ namespace Ichor {
         static constexpr std::string_view NAME = typeName<DoWorkEvent>();
     };
 
+    /// Pushed from the manager's timer wheel while lazy services with an idle timeout are active, stops the ones that have been without dependees for longer than their timeout
+    struct LazyIdleCheckEvent final : public Event {
+        LazyIdleCheckEvent(uint64_t _id, uint64_t _originatingService, uint64_t _priority) noexcept : Event(TYPE, NAME, _id, _originatingService, _priority) {}
+        ~LazyIdleCheckEvent() final = default;
+
+        static constexpr uint64_t TYPE = typeNameHash<LazyIdleCheckEvent>();
+        static constexpr std::string_view NAME = typeName<LazyIdleCheckEvent>();
+    };
+
+    /// Pushed by an expired Timer with a sync callback, runs the callback unless the timer got stopped or destroyed in the meantime
+    struct TimerEvent final : public Event {
+        TimerEvent(uint64_t _id, uint64_t _originatingService, uint64_t _priority, uint64_t _timerId) noexcept : Event(TYPE, NAME, _id, _originatingService, _priority), timerId(_timerId) {}
+        ~TimerEvent() final = default;
+
+        uint64_t timerId;
+        static constexpr uint64_t TYPE = typeNameHash<TimerEvent>();
+        static constexpr std::string_view NAME = typeName<TimerEvent>();
+    };
+
     struct RemoveCompletionCallbacksEvent final : public Event {
         RemoveCompletionCallbacksEvent(uint64_t _id, uint64_t _originatingService, uint64_t _priority, CallbackKey _key) noexcept : Event(TYPE, NAME, _id, _originatingService, _priority), key(_key) {}
         ~RemoveCompletionCallbacksEvent() final = default;
@@ -105,10 +151,11 @@ namespace Ichor {
     };
 
     struct RemoveEventHandlerEvent final : public Event {
-        RemoveEventHandlerEvent(uint64_t _id, uint64_t _originatingService, uint64_t _priority, CallbackKey _key) noexcept : Event(TYPE, NAME, _id, _originatingService, _priority), key(_key) {}
+        RemoveEventHandlerEvent(uint64_t _id, uint64_t _originatingService, uint64_t _priority, CallbackKey _key, std::optional<uint64_t> _targetServiceId) noexcept : Event(TYPE, NAME, _id, _originatingService, _priority), key(_key), targetServiceId(_targetServiceId) {}
         ~RemoveEventHandlerEvent() final = default;
 
         CallbackKey key;
+        std::optional<uint64_t> targetServiceId;
         static constexpr uint64_t TYPE = typeNameHash<RemoveEventHandlerEvent>();
         static constexpr std::string_view NAME = typeName<RemoveEventHandlerEvent>();
     };
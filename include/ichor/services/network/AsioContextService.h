@@ -5,7 +5,7 @@
 #include <ichor/services/network/http/IHttpService.h>
 #include <ichor/services/logging/Logger.h>
 #include <ichor/services/timer/ITimerFactory.h>
-#include <ichor/coroutines/AsyncManualResetEvent.h>
+#include <ichor/coroutines/AsyncCrossThreadEvent.h>
 #include <boost/beast.hpp>
 #include <boost/asio/spawn.hpp>
 #include <thread>
@@ -54,7 +54,7 @@ namespace Ichor {
         std::atomic<bool> _quit{};
         uint64_t _threads{1};
         ILogger *_logger{nullptr};
-        AsyncManualResetEvent _startStopEvent{};
+        AsyncCrossThreadEvent _startStopEvent{};
     };
 }
 
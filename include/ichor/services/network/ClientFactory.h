@@ -40,8 +40,8 @@ namespace Ichor {
             }
 
             if(!_connections.contains(evt.originatingService)) {
-                auto newProps = *evt.properties.value();
-                newProps.emplace("Filter", Ichor::make_any<Filter>(ServiceIdFilterEntry{evt.originatingService}));
+                // shares the requesting service's properties instead of copying them
+                auto newProps = evt.properties.value()->with(Detail::filterPropertyKey, Ichor::make_any<Filter>(ServiceIdFilterEntry{evt.originatingService}));
 
                 _connections.emplace(evt.originatingService, GetThreadLocalManager().template createServiceManager<NetworkType, NetworkInterfaceType>(std::move(newProps)));
             }
@@ -24,13 +24,13 @@ namespace Ichor {
                 return true;
             }
 
-            auto regIt = reg->_registrations.find(Ichor::typeNameHash<Ichor::IConnectionService>());
+            auto const *registration = reg->find(Ichor::typeNameHash<Ichor::IConnectionService>());
 
-            if(regIt == reg->_registrations.end()) {
+            if(registration == nullptr) {
                 return true;
             }
 
-            auto props = std::get<3>(regIt->second);
+            auto const &props = registration->props;
 
             return !props.has_value() || !props->contains("Address");
         }
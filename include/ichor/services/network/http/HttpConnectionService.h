@@ -4,7 +4,7 @@
 
 #include <ichor/services/network/http/IHttpConnectionService.h>
 #include <ichor/services/network/AsioContextService.h>
-#include <ichor/coroutines/AsyncManualResetEvent.h>
+#include <ichor/coroutines/AsyncCrossThreadEvent.h>
 #include <ichor/services/logging/Logger.h>
 #include <ichor/stl/RealtimeMutex.h>
 #include <boost/beast.hpp>
@@ -21,10 +21,12 @@ namespace Ichor {
         struct ConnectionOutboxMessage {
             Ichor::HttpMethod method;
             std::string_view route;
-            AsyncManualResetEvent* event;
+            AsyncCrossThreadEvent* event;
             HttpResponse* response;
             std::vector<HttpHeader>* headers;
             std::vector<uint8_t>* body;
+            std::atomic<bool>* cancelled;
+            uint64_t requestId;
         };
     }
 
@@ -33,7 +35,8 @@ namespace Ichor {
         HttpConnectionService(DependencyRegister &reg, Properties props);
         ~HttpConnectionService() final = default;
 
-        Task<HttpResponse> sendAsync(HttpMethod method, std::string_view route, std::vector<HttpHeader> &&headers, std::vector<uint8_t>&& msg) final;
+        using IHttpConnectionService::sendAsync;
+        Task<HttpResponse> sendAsync(HttpMethod method, std::string_view route, std::vector<HttpHeader> &&headers, std::vector<uint8_t>&& msg, CancellationToken token) final;
 
         Task<void> close() final;
 
@@ -61,11 +64,14 @@ namespace Ichor {
         std::atomic<bool> _connected{};
         std::atomic<bool> _tcpNoDelay{};
         std::atomic<int64_t> _finishedListenAndRead{};
+        std::atomic<uint64_t> _inFlightRequestId{}; // request currently being sent or received, 0 if none
+        uint64_t _requestIdCounter{};
+        CancellationToken _stopToken{};
         std::atomic<ILogger*> _logger{nullptr};
         IAsioContextService *_asioContextService{nullptr};
         boost::circular_buffer<Detail::ConnectionOutboxMessage> _outbox{10};
         RealtimeMutex _outboxMutex{};
-        AsyncManualResetEvent _startStopEvent{};
+        AsyncCrossThreadEvent _startStopEvent{INTERNAL_EVENT_PRIORITY};
         IEventQueue *_queue;
     };
 }
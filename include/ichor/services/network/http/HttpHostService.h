@@ -5,7 +5,7 @@
 #include <ichor/services/network/http/IHttpService.h>
 #include <ichor/services/network/AsioContextService.h>
 #include <ichor/services/logging/Logger.h>
-#include <ichor/coroutines/AsyncManualResetEvent.h>
+#include <ichor/coroutines/AsyncCrossThreadEvent.h>
 #include <ichor/stl/RealtimeMutex.h>
 #include <boost/beast.hpp>
 #include <boost/asio/spawn.hpp>
@@ -67,7 +67,7 @@ namespace Ichor {
         std::atomic<ILogger*> _logger{nullptr};
         IAsioContextService *_asioContextService{nullptr};
         unordered_map<HttpMethod, unordered_map<std::string, std::function<AsyncGenerator<HttpResponse>(HttpRequest&)>, string_hash, std::equal_to<>>> _handlers{};
-        AsyncManualResetEvent _startStopEvent{};
+        AsyncCrossThreadEvent _startStopEvent{INTERNAL_EVENT_PRIORITY};
         IEventQueue *_queue;
     };
 }
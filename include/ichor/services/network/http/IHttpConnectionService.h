@@ -1,6 +1,7 @@
 #pragma once
 
 #include <ichor/coroutines/Task.h>
+#include <ichor/coroutines/CancellationToken.h>
 #include "HttpCommon.h"
 
 namespace Ichor {
@@ -12,9 +13,21 @@ namespace Ichor {
          * @param method method type (GET, POST, etc)
          * @param route The route, or path, of this request. Has to be pointing to valid memory until an HttpResponseEvent is received.
          * @param msg Usually json, ignored for GET requests
+         * @param token Cancels the request. A request that is already being sent or received is aborted, which fails the connection.
+         * @return response, with error set if cancelled
+         */
+        virtual Task<HttpResponse> sendAsync(HttpMethod method, std::string_view route, std::vector<HttpHeader> &&headers, std::vector<uint8_t>&& msg, CancellationToken token) = 0;
+
+        /**
+         * Send message asynchronously to the connected http server, without a way to cancel it. Use co_await to get the response.
+         * @param method method type (GET, POST, etc)
+         * @param route The route, or path, of this request. Has to be pointing to valid memory until an HttpResponseEvent is received.
+         * @param msg Usually json, ignored for GET requests
          * @return response
          */
-        virtual Task<HttpResponse> sendAsync(HttpMethod method, std::string_view route, std::vector<HttpHeader> &&headers, std::vector<uint8_t>&& msg) = 0;
+        Task<HttpResponse> sendAsync(HttpMethod method, std::string_view route, std::vector<HttpHeader> &&headers, std::vector<uint8_t>&& msg) {
+            return sendAsync(method, route, std::move(headers), std::move(msg), CancellationToken{});
+        }
 
         /**
          * Close the connection
@@ -6,7 +6,7 @@
 #include <ichor/services/network/IHostService.h>
 #include <ichor/services/network/AsioContextService.h>
 #include <ichor/services/logging/Logger.h>
-#include <ichor/coroutines/AsyncManualResetEvent.h>
+#include <ichor/coroutines/AsyncCrossThreadEvent.h>
 #include <ichor/stl/RealtimeMutex.h>
 #include <queue>
 #include <boost/beast.hpp>
@@ -66,7 +66,7 @@ namespace Ichor {
         IAsioContextService *_asioContextService{nullptr};
         std::unique_ptr<net::strand<net::io_context::executor_type>> _strand{};
         std::atomic<int64_t> _finishedListenAndRead{};
-        AsyncManualResetEvent _startStopEvent{};
+        AsyncCrossThreadEvent _startStopEvent{};
         boost::circular_buffer<Detail::WsConnectionOutboxMessage> _outbox{10};
         IEventQueue *_queue;
     };
@@ -7,7 +7,7 @@
 #include <ichor/services/network/ws/WsConnectionService.h>
 #include <ichor/services/network/ws/WsEvents.h>
 #include <ichor/services/network/AsioContextService.h>
-#include <ichor/coroutines/AsyncManualResetEvent.h>
+#include <ichor/coroutines/AsyncCrossThreadEvent.h>
 #include <boost/beast.hpp>
 #include <boost/asio/spawn.hpp>
 
@@ -53,7 +53,7 @@ namespace Ichor {
         IAsioContextService *_asioContextService{nullptr};
         std::vector<WsConnectionService*> _connections{};
         EventHandlerRegistration _eventRegistration{};
-        AsyncManualResetEvent _startStopEvent{};
+        AsyncCrossThreadEvent _startStopEvent{INTERNAL_EVENT_PRIORITY};
         IEventQueue *_queue;
     };
 }
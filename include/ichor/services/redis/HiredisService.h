@@ -20,12 +20,15 @@ namespace Ichor {
         uint64_t getPriority() final;
 
         // see IRedis for function descriptions
-        AsyncGenerator<RedisAuthReply> auth(std::string_view user, std::string_view password) final;
-        AsyncGenerator<RedisSetReply> set(std::string_view key, std::string_view value) final;
-        AsyncGenerator<RedisSetReply> set(std::string_view key, std::string_view value, RedisSetOptions const &opts) final;
+        using IRedis::auth;
+        using IRedis::set;
+        using IRedis::get;
+        AsyncGenerator<RedisAuthReply> auth(std::string_view user, std::string_view password, CancellationToken token) final;
+        AsyncGenerator<RedisSetReply> set(std::string_view key, std::string_view value, CancellationToken token) final;
+        AsyncGenerator<RedisSetReply> set(std::string_view key, std::string_view value, RedisSetOptions const &opts, CancellationToken token) final;
         void setAndForget(std::string_view key, std::string_view value) final;
         void setAndForget(std::string_view key, std::string_view value, RedisSetOptions const &opts) final;
-        AsyncGenerator<RedisGetReply> get(std::string_view key) final;
+        AsyncGenerator<RedisGetReply> get(std::string_view key, CancellationToken token) final;
 
     private:
         Task<tl::expected<void, Ichor::StartError>> start() final;
@@ -46,6 +49,7 @@ namespace Ichor {
         redisAsyncContext *_redisContext{};
         AsyncManualResetEvent _disconnectEvt{};
         ITimerFactory *_timerFactory{};
+        CancellationToken _stopToken{};
     };
 }
 
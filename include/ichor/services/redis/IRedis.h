@@ -1,6 +1,7 @@
 #pragma once
 
 #include <ichor/coroutines/AsyncGenerator.h>
+#include <ichor/coroutines/CancellationToken.h>
 #include <string_view>
 #include <optional>
 
@@ -38,21 +39,24 @@ namespace Ichor {
         /// Authenticate as user
         /// \param key
         /// \param value
+        /// \param token cancels waiting for the reply, the command itself may still be executed by Redis
         /// \return
-        virtual AsyncGenerator<RedisAuthReply> auth(std::string_view user, std::string_view password) = 0;
+        virtual AsyncGenerator<RedisAuthReply> auth(std::string_view user, std::string_view password, CancellationToken token) = 0;
 
         /// Set key, value in Redis
         /// \param key
         /// \param value
+        /// \param token cancels waiting for the reply, the command itself may still be executed by Redis
         /// \return coroutine with the reply from Redis
-        virtual AsyncGenerator<RedisSetReply> set(std::string_view key, std::string_view value) = 0;
+        virtual AsyncGenerator<RedisSetReply> set(std::string_view key, std::string_view value, CancellationToken token) = 0;
 
         /// Set key, value in Redis
         /// \param key
         /// \param value
         /// \param opts
+        /// \param token cancels waiting for the reply, the command itself may still be executed by Redis
         /// \return coroutine with the reply from Redis
-        virtual AsyncGenerator<RedisSetReply> set(std::string_view key, std::string_view value, RedisSetOptions const &opts) = 0;
+        virtual AsyncGenerator<RedisSetReply> set(std::string_view key, std::string_view value, RedisSetOptions const &opts, CancellationToken token) = 0;
 
         /// Set key, value in Redis without waiting for reply
         /// \param key
@@ -65,7 +69,27 @@ namespace Ichor {
         /// \param opts
         virtual void setAndForget(std::string_view key, std::string_view value, RedisSetOptions const &opts) = 0;
 
-        virtual AsyncGenerator<RedisGetReply> get(std::string_view key) = 0;
+        /// Get value of key from Redis
+        /// \param key
+        /// \param token cancels waiting for the reply
+        /// \return coroutine with the reply from Redis, without value if cancelled
+        virtual AsyncGenerator<RedisGetReply> get(std::string_view key, CancellationToken token) = 0;
+
+        AsyncGenerator<RedisAuthReply> auth(std::string_view user, std::string_view password) {
+            return auth(user, password, CancellationToken{});
+        }
+
+        AsyncGenerator<RedisSetReply> set(std::string_view key, std::string_view value) {
+            return set(key, value, CancellationToken{});
+        }
+
+        AsyncGenerator<RedisSetReply> set(std::string_view key, std::string_view value, RedisSetOptions const &opts) {
+            return set(key, value, opts, CancellationToken{});
+        }
+
+        AsyncGenerator<RedisGetReply> get(std::string_view key) {
+            return get(key, CancellationToken{});
+        }
 
     protected:
         ~IRedis() = default;
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <ichor/coroutines/AsyncSemaphore.h>
+#include <ichor/services/timer/ITimerFactory.h>
+#include <chrono>
+#include <memory>
+
+namespace Ichor {
+    template <typename Lock>
+    class BasicAsyncRateLimiterOperation;
+
+    /// Token bucket that suspends awaiting coroutines until enough tokens are available, e.g. to throttle requests to
+    /// an external service without sleeping on the event loop.
+    ///
+    /// The bucket starts full and is refilled by a timer of the given factory, which only runs while the bucket is not full.
+    /// Tokens are handed to waiters in the order they started waiting, so a large request is not starved by smaller ones.
+    /// Waiters are resumed from the ready queue of the manager they suspended on.
+    ///
+    /// Use AsyncRateLimiter within a single DependencyManager and AsyncCrossThreadRateLimiter to share it between threads.
+    /// Either way, the rate limiter has to be created and destroyed on the thread of the manager the timer factory belongs to.
+    template <typename Lock>
+    class BasicAsyncRateLimiter final {
+    public:
+        /// \param timerFactory timer factory of the owning service
+        /// \param tokensPerInterval amount of tokens added every interval
+        /// \param interval
+        /// \param burst maximum amount of tokens in the bucket, i.e. the amount that can be acquired at once after being idle
+        /// \param priority priority with which waiters are resumed, see Event::priority
+        BasicAsyncRateLimiter(ITimerFactory &timerFactory, uint64_t tokensPerInterval, std::chrono::nanoseconds interval, uint64_t burst, uint64_t priority = INTERNAL_COROUTINE_EVENT_PRIORITY);
+        ~BasicAsyncRateLimiter();
+
+        BasicAsyncRateLimiter(const BasicAsyncRateLimiter&) = delete;
+        BasicAsyncRateLimiter(BasicAsyncRateLimiter&&) = delete;
+        BasicAsyncRateLimiter& operator=(const BasicAsyncRateLimiter&) = delete;
+        BasicAsyncRateLimiter& operator=(BasicAsyncRateLimiter&&) = delete;
+
+        /// Usage: co_await _limiter.acquire();
+        /// \param count amount of tokens, terminates the program if larger than burst, as it would never be satisfied
+        /// \return operation that continues without suspending if enough tokens are available and nobody is waiting for any
+        [[nodiscard]] BasicAsyncRateLimiterOperation<Lock> acquire(uint64_t count = 1) noexcept;
+
+        /// \param count amount of tokens
+        /// \return true if the tokens were taken
+        [[nodiscard]] bool tryAcquire(uint64_t count = 1) noexcept;
+
+        /// \return amount of tokens that can be acquired without suspending
+        [[nodiscard]] uint64_t available() const noexcept;
+
+    private:
+        friend class BasicAsyncRateLimiterOperation<Lock>;
+
+        /// Called with _lock held
+        void startRefilling();
+        void refill();
+
+        mutable Lock _lock{};
+        ITimerFactory &_timerFactory;
+        ITimer *_timer{};
+        uint64_t _tokens;
+        uint64_t _tokensPerInterval;
+        uint64_t _burst;
+        uint64_t _priority;
+        Detail::AsyncWaiterQueue _waiters{};
+        std::shared_ptr<bool> _destroyed{std::make_shared<bool>(false)}; // timer callbacks may already be queued when the rate limiter is destroyed
+    };
+
+    template <typename Lock>
+    class BasicAsyncRateLimiterOperation final {
+    public:
+        BasicAsyncRateLimiterOperation(BasicAsyncRateLimiter<Lock> &limiter, uint64_t count) noexcept : _limiter(limiter), _count(count) {}
+
+        bool await_ready() const noexcept {
+            return false;
+        }
+
+        bool await_suspend(std::coroutine_handle<> awaiter) noexcept;
+
+        void await_resume() const noexcept {}
+
+    private:
+        BasicAsyncRateLimiter<Lock> &_limiter;
+        uint64_t _count;
+        Detail::AsyncWaiter _waiter{};
+    };
+
+    extern template class BasicAsyncRateLimiter<Detail::SingleThreadLock>;
+    extern template class BasicAsyncRateLimiter<RealtimeMutex>;
+    extern template class BasicAsyncRateLimiterOperation<Detail::SingleThreadLock>;
+    extern template class BasicAsyncRateLimiterOperation<RealtimeMutex>;
+
+    using AsyncRateLimiter = BasicAsyncRateLimiter<Detail::SingleThreadLock>;
+    using AsyncCrossThreadRateLimiter = BasicAsyncRateLimiter<RealtimeMutex>;
+}
@@ -3,6 +3,13 @@
 #include <ichor/coroutines/AsyncGenerator.h>
 
 namespace Ichor {
+    /// What a timer does with expiries that passed while the event loop was too busy to handle them
+    enum class TimerMissedTickPolicy : uint8_t {
+        SKIP, // missed expiries and the late one do not run the callback, the timer waits for the next expiry on its schedule. That one runs it even if late as well
+        CATCH_UP, // the callback runs once for every missed expiry
+        FIRE_ONCE, // the callback runs once for all missed expiries together
+    };
+
     struct ITimer {
         /// Thread-safe.
         virtual void startTimer() = 0;
@@ -15,6 +22,13 @@ namespace Ichor {
         /// Thread-safe.
         /// \param nanoseconds
         virtual void setInterval(uint64_t nanoseconds) noexcept = 0;
+        /// Thread-safe. How much later than its deadline the timer may expire, which lets timers with deadlines close together expire together.
+        /// Limited to half the interval. Defaults to 0.
+        /// \param nanoseconds
+        virtual void setSlack(uint64_t nanoseconds) noexcept = 0;
+        /// Thread-safe. Defaults to FIRE_ONCE.
+        /// \param policy
+        virtual void setMissedTickPolicy(TimerMissedTickPolicy policy) noexcept = 0;
         /// Thread-safe.
         virtual void setPriority(uint64_t priority) noexcept = 0;
         /// Thread-safe.
@@ -47,6 +61,22 @@ namespace Ichor {
             setInterval(static_cast<uint64_t>(val));
         }
 
+        /// Thread-safe.
+        /// \tparam Dur std::chrono type
+        /// \param duration
+        template <typename Dur>
+        void setChronoSlack(Dur duration) noexcept {
+            int64_t val = std::chrono::nanoseconds(duration).count();
+
+#ifdef ICHOR_USE_HARDENING
+            if(val < 0) [[unlikely]] {
+                std::terminate();
+            }
+#endif
+
+            setSlack(static_cast<uint64_t>(val));
+        }
+
     protected:
         ~ITimer() = default;
     };
@@ -1,14 +1,26 @@
 #pragma once
 
-#include <thread>
+#include <chrono>
 #include <ichor/services/timer/ITimer.h>
 #include <ichor/event_queues/IEventQueue.h>
+#include <ichor/stl/TimingWheel.h>
 
 namespace Ichor {
     class TimerFactory;
+    class DependencyManager;
 
-    // Rather shoddy implementation, setting the interval does not reset the insertEventLoop function and the sleep_for is sketchy at best.
-    class Timer final : public ITimer {
+    /// Timer on the timing wheel of the DependencyManager it was created by. The wheel is serviced by the manager's event loop,
+    /// so timers do not need a thread of their own and starting or stopping one is O(1) regardless of the amount of timers.
+    /// On expiry an event with the timer's priority is pushed, which runs the callback on the manager's thread.
+    ///
+    /// Deadlines are absolute points on the steady clock, each one interval after the previous deadline rather than after the moment
+    /// the timer actually expired, so a timer does not drift. With slack a timer may expire up to that much later, which is used
+    /// to let it expire in the same go as timers with nearby deadlines.
+    ///
+    /// Calls from other threads are handed over to the manager's thread and take effect once it gets to them.
+    /// Setting the interval takes effect from the next expiry on. Expiries missed because the event loop was busy are handled according
+    /// to the missed tick policy, as are expiries of a timer with a sync callback while the event of its previous expiry is still queued.
+    class Timer final : public ITimer, public Detail::TimingWheelEntry {
     public:
         ~Timer() noexcept;
 
@@ -31,6 +43,10 @@ namespace Ichor {
         void setCallback(std::function<void()> fn) final;
         /// Thread-safe.
         void setInterval(uint64_t nanoseconds) noexcept final;
+        /// Thread-safe.
+        void setSlack(uint64_t nanoseconds) noexcept final;
+        /// Thread-safe.
+        void setMissedTickPolicy(TimerMissedTickPolicy policy) noexcept final;
 
         /// Thread-safe.
         void setPriority(uint64_t priority) noexcept final;
@@ -41,21 +57,37 @@ namespace Ichor {
 
     private:
         ///
+        /// \param dm manager whose event loop services the timer, has to be the one of the current thread
         /// \param timerId unique identifier for timer
         /// \param svcId unique identifier for svc using this timer
-        Timer(IEventQueue *queue, uint64_t timerId, uint64_t svcId) noexcept;
+        Timer(DependencyManager &dm, uint64_t timerId, uint64_t svcId);
 
-        void insertEventLoop(bool fireImmediately);
+        void schedule(bool fireImmediately) noexcept;
+        /// Puts the timer on the wheel for _next
+        void scheduleNext() noexcept;
+        /// Called from the manager's thread, brings the wheel in line with a start or stop that was called from another thread
+        void reconcile() noexcept;
+        void pushReconcile();
+        /// Called by the wheel, pushes the event for this expiry and schedules the next one
+        /// \param now moment the wheel was advanced to
+        void expire(std::chrono::steady_clock::time_point now);
 
         friend class TimerFactory;
+        friend class DependencyManager;
 
-        IEventQueue *_queue{};
+        DependencyManager *_dm;
+        IEventQueue *_queue;
         uint64_t _timerId{};
         std::atomic<uint64_t> _intervalNanosec{1'000'000'000};
-        std::unique_ptr<std::thread> _eventInsertionThread{};
+        std::atomic<uint64_t> _slackNanosec{};
+        std::atomic<TimerMissedTickPolicy> _missedTickPolicy{TimerMissedTickPolicy::FIRE_ONCE};
         std::function<AsyncGenerator<IchorBehaviour>()> _fnAsync{};
         std::function<void()> _fn{};
-        std::atomic<bool> _quit{true};
+        std::chrono::steady_clock::time_point _next{}; // deadline without slack, only used on the manager's thread
+        uint64_t _queuedExpiries{}; // times the queued TimerEvent of this timer runs the callback, 0 if there is none. Only used on the manager's thread
+        bool _skippedLast{}; // the last expiry was late and skipped by TimerMissedTickPolicy::SKIP. Only used on the manager's thread
+        std::atomic<bool> _running{};
+        std::atomic<bool> _fireImmediately{}; // argument of the last startTimer() from another thread
         std::atomic<uint64_t> _priority{INTERNAL_EVENT_PRIORITY};
         uint64_t _requestingServiceId{};
     };
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <ichor/services/timer/ITimerFactory.h>
+#include <ichor/coroutines/CancellationToken.h>
+#include <ichor/coroutines/Task.h>
+#include <ichor/Enums.h>
+#include <tl/expected.h>
+#include <chrono>
+#include <optional>
+#include <type_traits>
+
+namespace Ichor {
+    namespace Detail {
+        /// Stops and destroys the timer of withTimeout, also when the awaited task throws
+        class TimeoutTimerGuard final {
+        public:
+            TimeoutTimerGuard(ITimerFactory &factory, ITimer &timer) noexcept : _factory(factory), _timer(timer) {}
+            ~TimeoutTimerGuard() {
+                _timer.stopTimer();
+                _factory.destroyTimer(_timer.getTimerId());
+            }
+
+            TimeoutTimerGuard(const TimeoutTimerGuard&) = delete;
+            TimeoutTimerGuard(TimeoutTimerGuard&&) = delete;
+            TimeoutTimerGuard& operator=(const TimeoutTimerGuard&) = delete;
+            TimeoutTimerGuard& operator=(TimeoutTimerGuard&&) = delete;
+
+        private:
+            ITimerFactory &_factory;
+            ITimer &_timer;
+        };
+
+        /// Results which can report that the task ended without producing a value
+        template <typename T>
+        struct IsEmptiableResult : std::false_type {};
+        template <typename T>
+        struct IsEmptiableResult<std::optional<T>> : std::true_type {};
+        template <typename T, typename E>
+        struct IsEmptiableResult<tl::expected<T, E>> : std::true_type {};
+    }
+
+    /// Runs the task created by fn with a token that gets cancelled when timeout expires, using a timer of timerFactory.
+    /// Cancellation is cooperative: withTimeout completes when the task does, so the task has to pass the token to the operations it awaits,
+    /// e.g. IHttpConnectionService::sendAsync, for the timeout to bound its latency.
+    /// A task reports that it ended because of the cancellation by returning an empty std::optional or an unexpected tl::expected.
+    /// Any other result is returned as is, also when the task ignored the token and completed after the timeout expired.
+    ///
+    /// Usage:
+    /// auto response = co_await withTimeout(*_timerFactory, 500ms, [&](CancellationToken token) -> Task<std::optional<HttpResponse>> {
+    ///     auto resp = co_await _connection->sendAsync(HttpMethod::get, "/", {}, {}, token);
+    ///     if(resp.error && token.isCancellationRequested()) {
+    ///         co_return std::nullopt;
+    ///     }
+    ///     co_return resp;
+    /// });
+    /// \tparam Fn callable taking a CancellationToken and returning a Task<T>
+    /// \param timerFactory timer factory of the calling service
+    /// \param timeout
+    /// \param fn
+    /// \return the result of the task, or TimeoutError::TIMED_OUT if the timeout expired and the task returned an empty result
+    template <typename Fn, typename Rep, typename Period>
+    requires std::is_invocable_v<Fn, CancellationToken>
+    Task<tl::expected<typename std::invoke_result_t<Fn, CancellationToken>::value_type, TimeoutError>> withTimeout(ITimerFactory &timerFactory, std::chrono::duration<Rep, Period> timeout, Fn fn) {
+        using T = typename std::invoke_result_t<Fn, CancellationToken>::value_type;
+
+        CancellationSource source{};
+        auto &timer = timerFactory.createTimer();
+        timer.setChronoInterval(timeout);
+        timer.setCallback([source]() mutable {
+            source.requestCancellation();
+        });
+        timer.startTimer();
+        Detail::TimeoutTimerGuard const guard{timerFactory, timer};
+
+        if constexpr (std::is_void_v<T>) {
+            co_await fn(source.getToken());
+
+            co_return {};
+        } else {
+            auto ret = co_await fn(source.getToken());
+
+            if constexpr (Detail::IsEmptiableResult<T>::value) {
+                if(!ret.has_value() && source.isCancellationRequested()) {
+                    co_return tl::unexpected(TimeoutError::TIMED_OUT);
+                }
+            }
+
+            // in_place, as T may itself be a tl::expected which would otherwise be converted
+            co_return tl::expected<T, TimeoutError>{tl::in_place, std::move(ret)};
+        }
+    }
+}
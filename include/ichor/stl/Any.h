@@ -4,6 +4,9 @@
 #include <typeinfo>
 #include <string>
 #include <string_view>
+#include <cstring>
+#include <new>
+#include <type_traits>
 
 // Differs from std::any by not needing RTTI (no typeid())
 // Probably doesn't work in some situations where std::any would, as compiler support is missing.
@@ -23,21 +26,58 @@ namespace Ichor {
         std::string _error;
     };
 
-    using createValueFnPtr = void*(*)(void*);
-    using deleteValueFnPtr = void(*)(void*);
+    namespace Detail {
+        /// Small, trivially copyable values (integers, bools, enums, pointers, ...) are stored inside the any itself.
+        union any_storage {
+            void *ptr;
+            alignas(void*) unsigned char buf[2 * sizeof(void*)];
+        };
+
+        template <typename T>
+        inline constexpr bool any_stores_inline = std::is_trivially_copyable_v<T> && sizeof(T) <= sizeof(any_storage) && alignof(T) <= alignof(any_storage);
+
+        /// One static instance per stored type, so that each any only needs a single pointer to describe its contents.
+        struct any_vtable final {
+            void (*copy)(any_storage const &src, any_storage &dst);
+            void (*destroy)(any_storage &storage) noexcept;
+            uint64_t typeHash;
+            std::size_t size;
+            std::string_view typeName;
+            bool storedInline;
+        };
+
+        template <typename T>
+        inline constexpr any_vtable any_vtable_for{
+            [](any_storage const &src, any_storage &dst) {
+                if constexpr (any_stores_inline<T>) {
+                    std::memcpy(dst.buf, src.buf, sizeof(T));
+                } else {
+                    dst.ptr = new T(*static_cast<T const *>(src.ptr));
+                }
+            },
+            [](any_storage &storage) noexcept {
+                if constexpr (!any_stores_inline<T>) {
+                    delete static_cast<T*>(storage.ptr);
+                }
+            },
+            typeNameHash<T>(),
+            sizeof(T),
+            typeName<T>(),
+            any_stores_inline<T>
+        };
+    }
 
     struct any final {
         any() noexcept {
 
         }
 
-        any(const any& o) : _size(o._size), _ptr(o._createFn(o._ptr)), _typeHash(o._typeHash), _hasValue(o._hasValue), _createFn(o._createFn), _deleteFn(o._deleteFn), _typeName(o._typeName) {
-
+        any(const any& o) : _vtable(o._vtable) {
+            copyStorageFrom(o);
         }
 
-        any(any&& o) noexcept : _size(o._size), _ptr(o._ptr), _typeHash(o._typeHash), _hasValue(o._hasValue), _createFn(o._createFn), _deleteFn(o._deleteFn), _typeName(o._typeName) {
-            o._hasValue = false;
-            o._ptr = nullptr;
+        any(any&& o) noexcept : _storage(o._storage), _vtable(o._vtable) {
+            o._vtable = nullptr;
         }
 
         any& operator=(const any& o) {
@@ -47,30 +87,23 @@ namespace Ichor {
 
             reset();
 
-            _size = o._size;
-            _ptr = o._createFn(o._ptr);
-            _typeHash = o._typeHash;
-            _hasValue = o._hasValue;
-            _createFn = o._createFn;
-            _deleteFn = o._deleteFn;
-            _typeName = o._typeName;
+            copyStorageFrom(o);
+            _vtable = o._vtable;
 
             return *this;
         }
 
         any& operator=(any&& o) noexcept {
+            if(this == &o) {
+                return *this;
+            }
+
             reset();
 
-            _size = o._size;
-            _ptr = o._ptr;
-            _typeHash = o._typeHash;
-            _hasValue = o._hasValue;
-            _createFn = o._createFn;
-            _deleteFn = o._deleteFn;
-            _typeName = o._typeName;
+            _storage = o._storage;
+            _vtable = o._vtable;
 
-            o._hasValue = false;
-            o._ptr = nullptr;
+            o._vtable = nullptr;
 
             return *this;
         }
@@ -80,41 +113,47 @@ namespace Ichor {
         }
 
         template <typename T, typename... Args>
-        std::decay<T>& emplace(Args&&... args)
+        std::decay_t<T>& emplace(Args&&... args)
         {
             static_assert(std::is_copy_constructible_v<T>, "Template argument must be copy constructible.");
             static_assert(!std::is_pointer_v<T>, "Template argument must not be a pointer");
+            using StoredT = std::remove_cvref_t<T>;
 
             reset();
 
-            _size = sizeof(T);
-            _ptr = new T(std::forward<Args>(args)...);
-            _typeHash = typeNameHash<std::remove_cvref_t<T>>();
-            _hasValue = true;
-            _createFn = [](void *value) -> void* {
-                return new T(*reinterpret_cast<T*>(value));
-            };
-            _deleteFn = [](void *value) {
-                delete static_cast<T*>(value);
-            };
-            _typeName = typeName<std::remove_cvref_t<T>>();
-
-            return *reinterpret_cast<std::decay<T>*>(_ptr);
-        }
-
-        void reset() {
-            if(_hasValue) {
-                _deleteFn(_ptr);
-                _hasValue = false;
+            StoredT *value;
+            if constexpr (Detail::any_stores_inline<StoredT>) {
+                value = new (_storage.buf) StoredT(std::forward<Args>(args)...);
+            } else {
+                value = new StoredT(std::forward<Args>(args)...);
+                _storage.ptr = value;
+            }
+            _vtable = &Detail::any_vtable_for<StoredT>;
+
+            return *value;
+        }
+
+        void reset() noexcept {
+            if(_vtable != nullptr) {
+                _vtable->destroy(_storage);
+                _vtable = nullptr;
             }
         }
 
         [[nodiscard]] bool has_value() const noexcept {
-            return _hasValue;
+            return _vtable != nullptr;
         }
 
         [[nodiscard]] uint64_t type_hash() const noexcept {
-            return _typeHash;
+            return _vtable != nullptr ? _vtable->typeHash : 0;
+        }
+
+        [[nodiscard]] std::string_view type_name() const noexcept {
+            return _vtable != nullptr ? _vtable->typeName : std::string_view{};
+        }
+
+        [[nodiscard]] std::size_t get_size() const noexcept {
+            return _vtable != nullptr ? _vtable->size : 0;
         }
 
         template<typename ValueType>
@@ -123,10 +162,10 @@ namespace Ichor {
             using Up = typename std::remove_pointer_t<std::remove_cvref_t<ValueType>>;
             static_assert((std::is_reference_v<ValueType> || std::is_copy_constructible_v<ValueType>), "Template argument must be a reference or CopyConstructible type");
             static_assert(std::is_constructible_v<ValueType, Up&>, "Template argument must be constructible from an lvalue.");
-            if(_hasValue && _typeHash == typeNameHash<Up>()) {
-                return static_cast<ValueType>(*reinterpret_cast<Up*>(_ptr));
+            if(_vtable != nullptr && _vtable->typeHash == typeNameHash<Up>()) {
+                return static_cast<ValueType>(*data<Up>());
             }
-            throw bad_any_cast{_typeName, typeName<Up>()};
+            throw bad_any_cast{type_name(), typeName<Up>()};
         }
 
         template<typename ValueType>
@@ -135,10 +174,10 @@ namespace Ichor {
             using Up = typename std::remove_pointer_t<std::remove_cvref_t<ValueType>>;
             static_assert((std::is_reference_v<ValueType> || std::is_copy_constructible_v<ValueType>), "Template argument must be a reference or CopyConstructible type");
             static_assert(std::is_constructible_v<ValueType, const Up&>, "Template argument must be constructible from a const lvalue.");
-            if(_hasValue && _typeHash == typeNameHash<Up>()) {
-                return static_cast<ValueType>(*reinterpret_cast<Up*>(_ptr));
+            if(_vtable != nullptr && _vtable->typeHash == typeNameHash<Up>()) {
+                return static_cast<ValueType>(*data<Up>());
             }
-            throw bad_any_cast{_typeName, typeName<Up>()};
+            throw bad_any_cast{type_name(), typeName<Up>()};
         }
 
         template<typename ValueType>
@@ -147,20 +186,46 @@ namespace Ichor {
             using Up = typename std::remove_pointer_t<std::remove_cvref_t<ValueType>>;
             static_assert((std::is_pointer_v<ValueType> ), "Template argument must be a pointer type");
             auto comparison = typeNameHash<Up>();
-            if(_hasValue && _typeHash == comparison) {
-                return reinterpret_cast<ValueType>(_ptr);
+            if(_vtable != nullptr && _vtable->typeHash == comparison) {
+                return const_cast<Up*>(data<Up>());
             }
-            throw bad_any_cast{_typeName, typeName<Up>()};
+            throw bad_any_cast{type_name(), typeName<Up>()};
         }
 
     private:
-        std::size_t _size{};
-        void* _ptr{};
-        uint64_t _typeHash{};
-        bool _hasValue{};
-        createValueFnPtr _createFn{};
-        deleteValueFnPtr _deleteFn{};
-        std::string_view _typeName{};
+        void copyStorageFrom(const any& o) {
+            if(o._vtable == nullptr) {
+                return;
+            }
+
+            if(o._vtable->storedInline) {
+                _storage = o._storage;
+            } else {
+                o._vtable->copy(o._storage, _storage);
+            }
+        }
+
+        // only valid after checking the type hash
+        template <typename Up>
+        Up* data() noexcept {
+            if constexpr (Detail::any_stores_inline<Up>) {
+                return std::launder(reinterpret_cast<Up*>(_storage.buf));
+            } else {
+                return static_cast<Up*>(_storage.ptr);
+            }
+        }
+
+        template <typename Up>
+        Up const * data() const noexcept {
+            if constexpr (Detail::any_stores_inline<Up>) {
+                return std::launder(reinterpret_cast<Up const*>(_storage.buf));
+            } else {
+                return static_cast<Up const*>(_storage.ptr);
+            }
+        }
+
+        Detail::any_storage _storage{};
+        Detail::any_vtable const *_vtable{};
     };
 
     template<typename ValueType>
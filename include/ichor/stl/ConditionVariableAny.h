@@ -65,6 +65,14 @@ namespace Ichor {
             return cv_status::timeout;
         }
 
+        template<typename LockT, typename DurationT, typename PredicateT>
+        bool wait_until(LockT& lock, const std::chrono::time_point<std::chrono::steady_clock, DurationT>& atime, PredicateT pred) {
+            while (!pred())
+                if (wait_until(lock, atime) == cv_status::timeout)
+                    return pred();
+            return true;
+        }
+
         template<typename LockT, typename RepT, typename PeriodT, typename PredicateT>
         bool wait_for(LockT& lock, const std::chrono::duration<RepT, PeriodT>& rtime, PredicateT pred) {
             using durT = typename std::chrono::steady_clock::duration;
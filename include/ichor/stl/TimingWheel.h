@@ -0,0 +1,309 @@
+#pragma once
+
+#include <bit>
+#include <array>
+#include <cstdint>
+#include <exception>
+#include <optional>
+
+namespace Ichor::Detail {
+    /// Intrusive hook for entries of a TimingWheel. The wheel does not own entries, an entry has to be removed before it is destroyed.
+    struct TimingWheelEntry {
+        static constexpr uint8_t unscheduled = 0xFF;
+
+        [[nodiscard]] bool isScheduled() const noexcept {
+            return level != unscheduled;
+        }
+
+        TimingWheelEntry *prev{};
+        TimingWheelEntry *next{};
+        uint64_t deadline{}; // in ticks
+        uint8_t level{unscheduled}; // wheel level, or one of the TimingWheel's expired lists
+        uint8_t slot{};
+    };
+
+    /// Intrusive FIFO of TimingWheelEntries
+    class TimingWheelList final {
+    public:
+        [[nodiscard]] bool empty() const noexcept {
+            return _head == nullptr;
+        }
+
+        [[nodiscard]] TimingWheelEntry* front() const noexcept {
+            return _head;
+        }
+
+        void push(TimingWheelEntry &entry) noexcept {
+            entry.prev = _tail;
+            entry.next = nullptr;
+            if(_tail == nullptr) {
+                _head = &entry;
+            } else {
+                _tail->next = &entry;
+            }
+            _tail = &entry;
+        }
+
+        void remove(TimingWheelEntry &entry) noexcept {
+            if(entry.prev == nullptr) {
+                _head = entry.next;
+            } else {
+                entry.prev->next = entry.next;
+            }
+            if(entry.next == nullptr) {
+                _tail = entry.prev;
+            } else {
+                entry.next->prev = entry.prev;
+            }
+            entry.prev = nullptr;
+            entry.next = nullptr;
+        }
+
+        [[nodiscard]] TimingWheelEntry* pop() noexcept {
+            auto *entry = _head;
+            if(entry != nullptr) {
+                remove(*entry);
+            }
+            return entry;
+        }
+
+        /// Moves all entries of other to the back of this list
+        void append(TimingWheelList &other) noexcept {
+            if(other._head == nullptr) {
+                return;
+            }
+            if(_tail == nullptr) {
+                _head = other._head;
+            } else {
+                _tail->next = other._head;
+                other._head->prev = _tail;
+            }
+            _tail = other._tail;
+            other._head = nullptr;
+            other._tail = nullptr;
+        }
+
+    private:
+        TimingWheelEntry *_head{};
+        TimingWheelEntry *_tail{};
+    };
+
+    /// Hierarchical timing wheel: 6 levels of 64 slots, where a slot on level n spans 64^n ticks.
+    /// Inserting and removing an entry is O(1) regardless of the amount of entries, an entry is moved to a lower level at most once per level
+    /// before it expires and finding the next expiration is a bit scan per level. Deadlines further away than 64^6 ticks are parked
+    /// on the top level and re-placed whenever their slot comes around.
+    ///
+    /// The wheel has no notion of time besides the ticks it is advanced to, the owner decides what a tick is.
+    /// Not thread-safe.
+    class TimingWheel final {
+    public:
+        static constexpr uint32_t slotBits = 6;
+        static constexpr uint32_t slotCount = 1u << slotBits;
+        static constexpr uint32_t levelCount = 6;
+        static constexpr uint64_t maxDuration = uint64_t{1} << (slotBits * levelCount);
+
+        TimingWheel() = default;
+        TimingWheel(const TimingWheel&) = delete;
+        TimingWheel(TimingWheel&&) = delete;
+        TimingWheel& operator=(const TimingWheel&) = delete;
+        TimingWheel& operator=(TimingWheel&&) = delete;
+
+        /// \param entry has to be unscheduled and outlive its stay in the wheel
+        /// \param deadline tick at which the entry expires, a deadline that already passed expires on the next advance()
+        void insert(TimingWheelEntry &entry, uint64_t deadline) noexcept {
+#ifdef ICHOR_USE_HARDENING
+            if(entry.isScheduled()) [[unlikely]] {
+                std::terminate();
+            }
+#endif
+            entry.deadline = deadline;
+            _size++;
+
+            if(deadline <= _elapsed) {
+                entry.level = expiredLevel;
+                _expired.push(entry);
+                return;
+            }
+
+            place(entry);
+        }
+
+        /// Removes the entry if it is scheduled, also when it is waiting to be handed to an ongoing advance()'s callback
+        /// \param entry
+        void remove(TimingWheelEntry &entry) noexcept {
+            if(!entry.isScheduled()) {
+                return;
+            }
+
+            if(entry.level == expiredLevel) {
+                _expired.remove(entry);
+            } else if(entry.level == firingLevel) {
+                _firing.remove(entry);
+            } else {
+                auto &level = _levels[entry.level];
+                level.slots[entry.slot].remove(entry);
+                if(level.slots[entry.slot].empty()) {
+                    level.occupied &= ~(uint64_t{1} << entry.slot);
+                }
+            }
+
+            entry.level = TimingWheelEntry::unscheduled;
+            _size--;
+        }
+
+        /// Moves the wheel forward to now and calls onExpired for every entry with a deadline at or before now, in order of deadline
+        /// as far as the tick granularity goes. Entries are removed from the wheel before onExpired is called, so onExpired may
+        /// re-insert the entry or insert and remove others. Entries inserted with a deadline that already passed expire on the next advance().
+        /// \param now has no effect if earlier than a previous now
+        /// \param onExpired void(TimingWheelEntry&)
+        template <typename F>
+        void advance(uint64_t now, F &&onExpired) {
+            while(true) {
+                auto expiration = nextExpiration();
+                if(!expiration || expiration->deadline > now) {
+                    break;
+                }
+
+                auto &level = _levels[expiration->level];
+                TimingWheelList entries{};
+                entries.append(level.slots[expiration->slot]);
+                level.occupied &= ~(uint64_t{1} << expiration->slot);
+                _elapsed = expiration->deadline;
+
+                while(auto *entry = entries.pop()) {
+                    if(entry->deadline <= _elapsed) {
+                        entry->level = expiredLevel;
+                        _expired.push(*entry);
+                    } else {
+                        place(*entry);
+                    }
+                }
+            }
+
+            if(now > _elapsed) {
+                _elapsed = now;
+            }
+
+            for(auto *entry = _expired.front(); entry != nullptr; entry = entry->next) {
+                entry->level = firingLevel;
+            }
+            _firing.append(_expired);
+
+            while(auto *entry = _firing.pop()) {
+                entry->level = TimingWheelEntry::unscheduled;
+                _size--;
+                onExpired(*entry);
+            }
+        }
+
+        /// \return the earliest tick at which advance() has work to do, which may be in the past, or nothing if the wheel is empty.
+        /// For entries on a higher level this is the start of their slot, so the deadline may be earlier than the deadline of any entry.
+        [[nodiscard]] std::optional<uint64_t> nextDeadline() const noexcept {
+            if(!_expired.empty() || !_firing.empty()) {
+                return _elapsed;
+            }
+
+            auto expiration = nextExpiration();
+            if(!expiration) {
+                return {};
+            }
+            return expiration->deadline;
+        }
+
+        /// Timers with deadlines close together end up on the same tick when they are allowed to be late, so that they expire in one advance().
+        /// \param deadline
+        /// \param slack how many ticks later than deadline is acceptable
+        /// \return the tick in [deadline, deadline + slack] with the most trailing zero bits
+        [[nodiscard]] static uint64_t coalesce(uint64_t deadline, uint64_t slack) noexcept {
+            if(slack == 0 || deadline == 0 || deadline > UINT64_MAX - slack) {
+                return deadline;
+            }
+
+            // the highest bit in which latest differs from anything before deadline is set in latest, clearing the bits below it stays within range
+            auto const latest = deadline + slack;
+            auto const bit = 63 - std::countl_zero((deadline - 1) ^ latest);
+            return latest & ~((uint64_t{1} << bit) - 1);
+        }
+
+        /// \return tick the wheel was last advanced to
+        [[nodiscard]] uint64_t elapsed() const noexcept {
+            return _elapsed;
+        }
+
+        [[nodiscard]] bool empty() const noexcept {
+            return _size == 0;
+        }
+
+        /// \return amount of scheduled entries
+        [[nodiscard]] uint64_t size() const noexcept {
+            return _size;
+        }
+
+    private:
+        static constexpr uint8_t expiredLevel = levelCount;
+        static constexpr uint8_t firingLevel = levelCount + 1;
+
+        struct Level final {
+            uint64_t occupied{}; // bit n set = slots[n] is non-empty
+            std::array<TimingWheelList, slotCount> slots{};
+        };
+
+        struct Expiration final {
+            uint8_t level;
+            uint8_t slot;
+            uint64_t deadline;
+        };
+
+        /// \return level on which the highest bit in which deadline and elapsed differ lives, deadlines past the wheel's range go on the top level
+        [[nodiscard]] static uint8_t levelFor(uint64_t elapsed, uint64_t deadline) noexcept {
+            uint64_t masked = (elapsed ^ deadline) | (slotCount - 1);
+            if(masked >= maxDuration) {
+                masked = maxDuration - 1;
+            }
+            auto const significantBit = 63 - std::countl_zero(masked);
+            return static_cast<uint8_t>(static_cast<uint32_t>(significantBit) / slotBits);
+        }
+
+        void place(TimingWheelEntry &entry) noexcept {
+            auto const level = levelFor(_elapsed, entry.deadline);
+            auto const slot = static_cast<uint8_t>((entry.deadline >> (level * slotBits)) & (slotCount - 1));
+            entry.level = level;
+            entry.slot = slot;
+            _levels[level].slots[slot].push(entry);
+            _levels[level].occupied |= uint64_t{1} << slot;
+        }
+
+        /// Entries on a lower level always expire before those on a higher level, so the first occupied slot after elapsed on the
+        /// lowest occupied level is the next one to process.
+        [[nodiscard]] std::optional<Expiration> nextExpiration() const noexcept {
+            for(uint8_t level = 0; level < levelCount; level++) {
+                auto const occupied = _levels[level].occupied;
+                if(occupied == 0) {
+                    continue;
+                }
+
+                auto const shift = level * slotBits;
+                uint64_t const slotRange = uint64_t{1} << shift;
+                uint64_t const levelRange = slotRange << slotBits;
+                // search starts after the current slot, which can only be occupied on the top level by deadlines a full rotation or more away
+                auto const firstSlot = static_cast<uint32_t>((_elapsed >> shift) + 1) & (slotCount - 1);
+                auto const slot = static_cast<uint8_t>((static_cast<uint32_t>(std::countr_zero(std::rotr(occupied, static_cast<int>(firstSlot)))) + firstSlot) & (slotCount - 1));
+
+                uint64_t deadline = (_elapsed & ~(levelRange - 1)) + slot * slotRange;
+                if(deadline <= _elapsed) {
+                    // only possible on the top level, for a slot that wrapped around
+                    deadline += levelRange;
+                }
+                return Expiration{level, slot, deadline};
+            }
+
+            return {};
+        }
+
+        std::array<Level, levelCount> _levels{};
+        TimingWheelList _expired{}; // deadline passed, handed to onExpired on the next advance()
+        TimingWheelList _firing{}; // being handed to onExpired by the ongoing advance()
+        uint64_t _elapsed{};
+        uint64_t _size{};
+    };
+}
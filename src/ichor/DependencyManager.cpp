@@ -3,6 +3,7 @@
 #include <ichor/CommunicationChannel.h>
 #include <ichor/stl/Any.h>
 #include <ichor/events/RunFunctionEvent.h>
+#include <ichor/services/timer/Timer.h>
 #include <ichor/dependency_management/QueueLifecycleManager.h>
 #include <ichor/dependency_management/DependencyManagerLifecycleManager.h>
 #include <ichor/dependency_management/IServiceInterestedLifecycleManager.h>
@@ -32,8 +33,12 @@ namespace backward {
 
 Ichor::DependencyManager::DependencyManager(IEventQueue *eventQueue) : _eventQueue(eventQueue) {
     auto qlm = std::make_unique<Detail::QueueLifecycleManager>(_eventQueue);
+    indexService(*qlm);
+    indexStartedService(*qlm);
     _services.emplace(qlm->serviceId(), std::move(qlm));
     auto dmlm = std::make_unique<Detail::DependencyManagerLifecycleManager>(this);
+    indexService(*dmlm);
+    indexStartedService(*dmlm);
     _services.emplace(dmlm->serviceId(), std::move(dmlm));
 }
 
@@ -113,43 +118,11 @@ void Ichor::DependencyManager::processEvent(std::unique_ptr<Event> &&uniqueEvt)
                     break;
                 }
 
-                finishWaitingService(depOnlineEvt->originatingService, DependencyOnlineEvent::TYPE, DependencyOnlineEvent::NAME);
-
-                auto const filterProp = manager->getProperties().find("Filter");
-                const Filter *filter = nullptr;
-                if (filterProp != cend(manager->getProperties())) {
-                    filter = Ichor::any_cast<Filter *const>(&filterProp->second);
-                }
-
-                for (auto const &[serviceId, possibleDependentLifecycleManager] : _services) {
-                    auto depIts = possibleDependentLifecycleManager->interestedInDependency(manager.get(), true);
-
-                    if(depIts.empty()) {
-                        continue;
-                    }
+                indexStartedService(*manager);
 
-                    if (serviceId == depOnlineEvt->originatingService || (filter != nullptr && !filter->compareTo(*possibleDependentLifecycleManager))) {
-                        continue;
-                    }
-
-                    auto gen = possibleDependentLifecycleManager->dependencyOnline(manager.get(), std::move(depIts));
-                    auto it = gen.begin();
-
-                    INTERNAL_DEBUG("DependencyOnlineEvent {} interested service is {} {} {}", evt->id, serviceId, it.get_promise_id(), it.get_finished());
+                finishWaitingService(depOnlineEvt->originatingService, DependencyOnlineEvent::TYPE, DependencyOnlineEvent::NAME);
 
-                    if(!it.get_finished()) {
-                        if constexpr (DO_INTERNAL_DEBUG) {
-                            if (!it.get_has_suspended()) [[unlikely]] {
-                                std::terminate();
-                            }
-                        }
-                        _scopedGenerators.emplace(it.get_promise_id(), std::make_unique<AsyncGenerator<StartBehaviour>>(std::move(gen)));
-                        // create new event that will be inserted upon finish of coroutine in ContinuableStartEvent
-                        _scopedEvents.emplace(it.get_promise_id(), std::make_shared<DependencyOnlineEvent>(_eventQueue->getNextEventId(), serviceId, INTERNAL_DEPENDENCY_EVENT_PRIORITY));
-                    } else if(it.get_value() == StartBehaviour::STARTED) {
-                        _eventQueue->pushPrioritisedEvent<DependencyOnlineEvent>(serviceId, INTERNAL_DEPENDENCY_EVENT_PRIORITY);
-                    }
-                }
+                notifyDependentsOnline(manager, evt->id, {});
                 handleEventCompletion(*depOnlineEvt);
             }
                 break;
@@ -172,6 +145,8 @@ void Ichor::DependencyManager::processEvent(std::unique_ptr<Event> &&uniqueEvt)
                     break;
                 }
 
+                unindexStartedService(*manager);
+
                 // copy dependees as it will be modified during this loop
                 auto dependees = manager->getDependees();
                 bool allDependeesFinished{true};
@@ -186,7 +161,7 @@ void Ichor::DependencyManager::processEvent(std::unique_ptr<Event> &&uniqueEvt)
 
                     auto depIts = depIt->second->interestedInDependency(manager.get(), false);
 
-                    if(depIts.empty()) {
+                    if(depIts.empty() || depIt->second->dependencyOfflineSync(manager.get(), depIts)) {
                         continue;
                     }
 
@@ -201,9 +176,8 @@ void Ichor::DependencyManager::processEvent(std::unique_ptr<Event> &&uniqueEvt)
                             }
                         }
                         allDependeesFinished = false;
-                        _scopedGenerators.emplace(it.get_promise_id(), std::make_unique<AsyncGenerator<StartBehaviour>>(std::move(gen)));
                         // create new event that will be inserted upon finish of coroutine in ContinuableStartEvent
-                        _scopedEvents.emplace(it.get_promise_id(), std::make_shared<ContinuableDependencyOfflineEvent>(_eventQueue->getNextEventId(), serviceId, INTERNAL_DEPENDENCY_EVENT_PRIORITY, depOfflineEvt->originatingService));
+                        addScopedCoroutine(it.get_promise_id(), std::make_unique<AsyncGenerator<StartBehaviour>>(std::move(gen)), std::make_shared<ContinuableDependencyOfflineEvent>(_eventQueue->getNextEventId(), serviceId, INTERNAL_DEPENDENCY_EVENT_PRIORITY, depOfflineEvt->originatingService));
                         continue;
                     }
 
@@ -230,6 +204,10 @@ void Ichor::DependencyManager::processEvent(std::unique_ptr<Event> &&uniqueEvt)
                 auto *depReqEvt = static_cast<DependencyRequestEvent *>(evt.get());
                 INTERNAL_DEBUG("DependencyRequestEvent {} {} {}", evt->id, evt->priority, evt->originatingService);
 
+                if(!_lazyServices.empty()) {
+                    activateLazyProviders(depReqEvt->dependency.interfaceNameHash, depReqEvt->originatingService);
+                }
+
                 auto trackers = _dependencyRequestTrackers.find(depReqEvt->dependency.interfaceNameHash);
                 if (trackers == end(_dependencyRequestTrackers)) {
                     handleEventCompletion(*depReqEvt);
@@ -264,8 +242,11 @@ void Ichor::DependencyManager::processEvent(std::unique_ptr<Event> &&uniqueEvt)
 
                 bool allServicesStopped{true};
 
-                for (auto const &[key, possibleManager]: _services) {
-                    if (possibleManager->getServiceState() == ServiceState::ACTIVE) {
+                for (auto it = _services.begin(); it != _services.end(); ++it) {
+                    auto const &[key, possibleManager] = *it;
+                    auto const state = _services.state(it);
+
+                    if (state == ServiceState::ACTIVE) {
                         auto &dependees = possibleManager->getDependees();
 
                         for(auto &serviceId : dependees) {
@@ -277,7 +258,7 @@ void Ichor::DependencyManager::processEvent(std::unique_ptr<Event> &&uniqueEvt)
                                                             possibleManager->serviceId());
                     }
 
-                    if(possibleManager->getServiceState() != ServiceState::INSTALLED) {
+                    if(state != ServiceState::INSTALLED) {
                         allServicesStopped = false;
 
                         if constexpr (DO_INTERNAL_DEBUG) {
@@ -310,40 +291,47 @@ void Ichor::DependencyManager::processEvent(std::unique_ptr<Event> &&uniqueEvt)
                 INTERNAL_DEBUG("InsertServiceEvent {} {} {} {}", evt->id, evt->priority, evt->originatingService, insertServiceEvt->mgr->implementationName());
                 auto svcIt = _services.emplace(insertServiceEvt->originatingService, std::move(insertServiceEvt->mgr));
                 auto &cmpMgr = svcIt.first->second;
+                indexService(*cmpMgr);
+
+                auto lazyIt = _lazyServices.end();
+                if(Detail::isLazy(cmpMgr->getProperties())) {
+                    lazyIt = _lazyServices.emplace(cmpMgr->serviceId(), Detail::LazyService{Detail::lazyIdleTimeout(cmpMgr->getProperties())}).first;
+                    cmpMgr->setDormant(true);
+                }
 
                 // If a service requests IService, we interpret it to mean a reference to itself, not just all services in existence.
                 Detail::IServiceInterestedLifecycleManager selfMgr{cmpMgr->getIService()};
                 auto selfDepIts = cmpMgr->interestedInDependency(&selfMgr, true);
 
-                if(!selfDepIts.empty()) {
+                if(!selfDepIts.empty() && !cmpMgr->dependencyOnlineSync(&selfMgr, selfDepIts)) {
                     auto gen = cmpMgr->dependencyOnline(&selfMgr, std::move(selfDepIts));
                     auto it = gen.begin();
 
                     if(!it.get_finished()) {
-                        _scopedGenerators.emplace(it.get_promise_id(), std::make_unique<AsyncGenerator<StartBehaviour>>(std::move(gen)));
                         // create new event that will be inserted upon finish of coroutine in ContinuableStartEvent
-                        _scopedEvents.emplace(it.get_promise_id(), std::make_shared<DependencyOnlineEvent>(_eventQueue->getNextEventId(), cmpMgr->serviceId(), INTERNAL_DEPENDENCY_EVENT_PRIORITY));
+                        addScopedCoroutine(it.get_promise_id(), std::make_unique<AsyncGenerator<StartBehaviour>>(std::move(gen)), std::make_shared<DependencyOnlineEvent>(_eventQueue->getNextEventId(), cmpMgr->serviceId(), INTERNAL_DEPENDENCY_EVENT_PRIORITY));
                     } else if(it.get_value() == StartBehaviour::STARTED) {
                         _eventQueue->pushPrioritisedEvent<DependencyOnlineEvent>(cmpMgr->serviceId(), INTERNAL_DEPENDENCY_EVENT_PRIORITY);
                     }
                 }
 
                 // loop over all services, check if cmpMgr is interested in the active ones and inject them if so
-                for (auto &[key, mgr] : _services) {
-                    if (mgr->getServiceState() == ServiceState::ACTIVE) {
+                for (auto otherIt = _services.begin(); otherIt != _services.end(); ++otherIt) {
+                    if (_services.state(otherIt) == ServiceState::ACTIVE) {
+                        auto &mgr = otherIt->second;
                         auto depIts = cmpMgr->interestedInDependency(mgr.get(), true);
 
                         if(depIts.empty()) {
                             continue;
                         }
 
-                        auto const filterProp = mgr->getProperties().find("Filter");
+                        auto const filterProp = mgr->getProperties().find(Detail::filterPropertyKey);
                         const Filter *filter = nullptr;
                         if (filterProp != cend(mgr->getProperties())) {
                             filter = Ichor::any_cast<Filter * const>(&filterProp->second);
                         }
 
-                        if (filter != nullptr && !filter->compareTo(*cmpMgr.get())) {
+                        if ((filter != nullptr && !filter->compareTo(*cmpMgr.get())) || cmpMgr->dependencyOnlineSync(mgr.get(), depIts)) {
                             continue;
                         }
 
@@ -351,14 +339,23 @@ void Ichor::DependencyManager::processEvent(std::unique_ptr<Event> &&uniqueEvt)
                         auto it = gen.begin();
 
                         if(!it.get_finished()) {
-                            _scopedGenerators.emplace(it.get_promise_id(), std::make_unique<AsyncGenerator<StartBehaviour>>(std::move(gen)));
                             // create new event that will be inserted upon finish of coroutine in ContinuableStartEvent
-                            _scopedEvents.emplace(it.get_promise_id(), std::make_shared<DependencyOnlineEvent>(_eventQueue->getNextEventId(), cmpMgr->serviceId(), INTERNAL_DEPENDENCY_EVENT_PRIORITY));
+                            addScopedCoroutine(it.get_promise_id(), std::make_unique<AsyncGenerator<StartBehaviour>>(std::move(gen)), std::make_shared<DependencyOnlineEvent>(_eventQueue->getNextEventId(), cmpMgr->serviceId(), INTERNAL_DEPENDENCY_EVENT_PRIORITY));
                         } else if(it.get_value() == StartBehaviour::STARTED) {
                             _eventQueue->pushPrioritisedEvent<DependencyOnlineEvent>(cmpMgr->serviceId(), INTERNAL_DEPENDENCY_EVENT_PRIORITY);
                         }
                     }
                 }
+
+                // a lazy service is activated right away if an existing service is already waiting for it
+                if(lazyIt != _lazyServices.end()) {
+                    for (auto &[key, mgr] : _services) {
+                        if(key != cmpMgr->serviceId() && !mgr->interestedInDependency(cmpMgr.get(), true).empty()) {
+                            activateLazyService(lazyIt, *cmpMgr);
+                            break;
+                        }
+                    }
+                }
             }
                 break;
             case StopServiceEvent::TYPE: {
@@ -388,6 +385,14 @@ void Ichor::DependencyManager::processEvent(std::unique_ptr<Event> &&uniqueEvt)
                     break;
                 }
 
+                // cancel in-flight work first, the checks below may have to wait for it
+                auto stopSourceIt = _serviceStopSources.find(stopServiceEvt->serviceId);
+                if(stopSourceIt != _serviceStopSources.end()) {
+                    INTERNAL_DEBUG("cancelling in-flight work of {}", stopServiceEvt->serviceId);
+                    auto source = stopSourceIt->second;
+                    source.requestCancellation();
+                }
+
                 auto &dependencies = toStopService->getDependencies();
                 auto &dependees = toStopService->getDependees();
 
@@ -437,10 +442,9 @@ void Ichor::DependencyManager::processEvent(std::unique_ptr<Event> &&uniqueEvt)
                                 std::terminate();
                             }
                         }
-                        INTERNAL_DEBUG("StopServiceEvent contains {} {} {}", it.get_promise_id(), _scopedGenerators.contains(it.get_promise_id()),
-                                       _scopedGenerators.size() + 1);
-                        _scopedGenerators.emplace(it.get_promise_id(), std::make_unique<AsyncGenerator<StartBehaviour>>(std::move(gen)));
-                        _scopedEvents.emplace(it.get_promise_id(), evt);
+                        INTERNAL_DEBUG("StopServiceEvent contains {} {} {}", it.get_promise_id(), _scopedCoroutines.contains(it.get_promise_id()),
+                                       _scopedCoroutines.size() + 1);
+                        addScopedCoroutine(it.get_promise_id(), std::make_unique<AsyncGenerator<StartBehaviour>>(std::move(gen)), evt);
                         break;
                     }
 
@@ -489,6 +493,14 @@ void Ichor::DependencyManager::processEvent(std::unique_ptr<Event> &&uniqueEvt)
                 }
 
                 auto *toStartService = toStartServiceIt->second.get();
+
+                // explicitly starting a dormant lazy service activates it
+                auto lazyIt = _lazyServices.find(startServiceEvt->serviceId);
+                if(lazyIt != _lazyServices.end() && lazyIt->second.dormant) {
+                    lazyIt->second.dormant = false;
+                    toStartService->setDormant(false);
+                }
+
                 if (toStartService->getServiceState() == ServiceState::ACTIVE) {
                     INTERNAL_DEBUG("StartServiceEvent service {}:{} already started", toStartService->serviceId(), toStartService->implementationName());
                     handleEventCompletion(*startServiceEvt);
@@ -510,10 +522,9 @@ void Ichor::DependencyManager::processEvent(std::unique_ptr<Event> &&uniqueEvt)
                             std::terminate();
                         }
                     }
-                    INTERNAL_DEBUG("StartServiceEvent contains {}:{} {} {} {}", toStartService->serviceId(), toStartService->implementationName(), it.get_promise_id(), _scopedGenerators.contains(it.get_promise_id()),
-                                   _scopedGenerators.size() + 1);
-                    _scopedGenerators.emplace(it.get_promise_id(), std::make_unique<AsyncGenerator<StartBehaviour>>(std::move(gen)));
-                    _scopedEvents.emplace(it.get_promise_id(), evt);
+                    INTERNAL_DEBUG("StartServiceEvent contains {}:{} {} {} {}", toStartService->serviceId(), toStartService->implementationName(), it.get_promise_id(), _scopedCoroutines.contains(it.get_promise_id()),
+                                   _scopedCoroutines.size() + 1);
+                    addScopedCoroutine(it.get_promise_id(), std::make_unique<AsyncGenerator<StartBehaviour>>(std::move(gen)), evt);
                     break;
                 }
 
@@ -536,6 +547,109 @@ void Ichor::DependencyManager::processEvent(std::unique_ptr<Event> &&uniqueEvt)
                 handleEventCompletion(*startServiceEvt);
             }
                 break;
+            case StartServiceGraphEvent::TYPE: {
+                auto *graphEvt = static_cast<StartServiceGraphEvent *>(evt.get());
+                INTERNAL_DEBUG("StartServiceGraphEvent {} {} {}", evt->id, evt->priority, graphEvt->nodes.size());
+
+                // graph services that will get a provider injected statically, they don't have to be notified when that provider comes online
+                unordered_map<uint64_t, std::vector<uint64_t>> staticDependents{};
+                for(auto const &node : graphEvt->nodes) {
+                    for(auto providerId : node.providers) {
+                        staticDependents[providerId].push_back(node.serviceId);
+                    }
+                }
+
+                for(auto const &node : graphEvt->nodes) {
+                    auto managerIt = _services.find(node.serviceId);
+
+                    if(managerIt == end(_services)) [[unlikely]] {
+                        INTERNAL_DEBUG("StartServiceGraphEvent service {} missing from known services", node.serviceId);
+                        continue;
+                    }
+
+                    auto &manager = managerIt->second;
+                    bool startedHere{};
+                    bool pending{};
+
+                    for(auto providerId : node.providers) {
+                        auto providerIt = _services.find(providerId);
+
+                        // A provider that is still starting asynchronously injects itself through its DependencyOnlineEvent once it has started.
+                        if(providerIt == end(_services) || providerIt->second->getServiceState() != ServiceState::ACTIVE) {
+                            continue;
+                        }
+
+                        auto const filterProp = providerIt->second->getProperties().find(Detail::filterPropertyKey);
+                        if (filterProp != cend(providerIt->second->getProperties()) && !Ichor::any_cast<Filter const &>(filterProp->second).compareTo(*manager)) {
+                            continue;
+                        }
+
+                        auto depIts = manager->interestedInDependency(providerIt->second.get(), true);
+
+                        if(depIts.empty() || manager->dependencyOnlineSync(providerIt->second.get(), depIts)) {
+                            continue;
+                        }
+
+                        auto gen = manager->dependencyOnline(providerIt->second.get(), std::move(depIts));
+                        auto it = gen.begin();
+
+                        if(!it.get_finished()) {
+                            // create new event that will be inserted upon finish of coroutine in ContinuableStartEvent
+                            addScopedCoroutine(it.get_promise_id(), std::make_unique<AsyncGenerator<StartBehaviour>>(std::move(gen)), std::make_shared<DependencyOnlineEvent>(_eventQueue->getNextEventId(), node.serviceId, INTERNAL_DEPENDENCY_EVENT_PRIORITY));
+                            pending = true;
+                        } else if(it.get_value() == StartBehaviour::STARTED) {
+                            startedHere = true;
+                        }
+                    }
+
+                    if(!pending && !startedHere && manager->getServiceState() == ServiceState::INSTALLED) {
+                        auto gen = manager->start();
+                        auto it = gen.begin();
+
+                        if(!it.get_finished()) {
+                            addScopedCoroutine(it.get_promise_id(), std::make_unique<AsyncGenerator<StartBehaviour>>(std::move(gen)), std::make_shared<StartServiceEvent>(_eventQueue->getNextEventId(), node.serviceId, INTERNAL_DEPENDENCY_EVENT_PRIORITY, node.serviceId));
+                            continue;
+                        }
+
+                        startedHere = manager->getServiceState() == ServiceState::INJECTING;
+                    }
+
+                    if(!startedHere) {
+                        continue;
+                    }
+
+                    if (!manager->setInjected()) [[unlikely]] {
+                        INTERNAL_DEBUG("Couldn't set injected for {} {} {}", manager->serviceId(), manager->implementationName(), manager->getServiceState());
+                        continue;
+                    }
+
+                    indexStartedService(*manager);
+
+                    finishWaitingService(node.serviceId, DependencyOnlineEvent::TYPE, DependencyOnlineEvent::NAME);
+
+                    auto dependentsIt = staticDependents.find(node.serviceId);
+                    notifyDependentsOnline(manager, evt->id, dependentsIt != staticDependents.end() ? dependentsIt->second : std::vector<uint64_t>{});
+                }
+
+                handleEventCompletion(*graphEvt);
+            }
+                break;
+            case ReplayDependencyGraphEvent::TYPE: {
+                auto *replayEvt = static_cast<ReplayDependencyGraphEvent *>(evt.get());
+                INTERNAL_DEBUG("ReplayDependencyGraphEvent {} {} {}", evt->id, evt->priority, replayEvt->snapshot.services.size());
+
+                auto nodes = matchDependencyGraphSnapshot(replayEvt->snapshot);
+
+                if(!nodes) {
+                    handleEventError(*replayEvt);
+                    break;
+                }
+
+                // same priority, so that the services are started before their regular StartServiceEvents are handled
+                _eventQueue->pushPrioritisedEvent<StartServiceGraphEvent>(replayEvt->originatingService, evt->priority, std::move(*nodes));
+                handleEventCompletion(*replayEvt);
+            }
+                break;
             case RemoveServiceEvent::TYPE: {
                 auto *removeServiceEvt = static_cast<RemoveServiceEvent *>(evt.get());
 
@@ -557,6 +671,9 @@ void Ichor::DependencyManager::processEvent(std::unique_ptr<Event> &&uniqueEvt)
                     break;
                 }
 
+                _lazyServices.erase(removeServiceEvt->serviceId);
+                _serviceStopSources.erase(removeServiceEvt->serviceId);
+                unindexService(*toRemoveService);
                 _services.erase(toRemoveServiceIt);
                 handleEventCompletion(*removeServiceEvt);
             }
@@ -566,6 +683,40 @@ void Ichor::DependencyManager::processEvent(std::unique_ptr<Event> &&uniqueEvt)
                 handleEventCompletion(*evt);
             }
                 break;
+            case LazyIdleCheckEvent::TYPE: {
+                INTERNAL_DEBUG("LazyIdleCheckEvent {} {}", evt->id, evt->priority);
+                auto now = std::chrono::steady_clock::now();
+
+                for(auto &[serviceId, lazy] : _lazyServices) {
+                    if(lazy.dormant || lazy.idleTimeout.count() == 0) {
+                        continue;
+                    }
+
+                    auto svcIt = _services.find(serviceId);
+                    if(svcIt == _services.end() || svcIt->second->getServiceState() != ServiceState::ACTIVE || !svcIt->second->getDependees().empty()) {
+                        lazy.idle = false;
+                        continue;
+                    }
+
+                    if(!lazy.idle) {
+                        lazy.idle = true;
+                        lazy.idleSince = now;
+                        continue;
+                    }
+
+                    if(now - lazy.idleSince >= lazy.idleTimeout) {
+                        INTERNAL_DEBUG("LazyIdleCheckEvent stopping idle service {}:{}", serviceId, svcIt->second->implementationName());
+                        lazy.idle = false;
+                        lazy.dormant = true;
+                        svcIt->second->setDormant(true);
+                        _eventQueue->pushPrioritisedEvent<StopServiceEvent>(0, INTERNAL_DEPENDENCY_EVENT_PRIORITY, serviceId);
+                    }
+                }
+
+                scheduleLazyIdleCheck();
+                handleEventCompletion(*evt);
+            }
+                break;
             case RemoveCompletionCallbacksEvent::TYPE: {
                 INTERNAL_DEBUG("RemoveCompletionCallbacksEvent {} {}", evt->id, evt->priority);
                 auto *removeCallbacksEvt = static_cast<RemoveCompletionCallbacksEvent *>(evt.get());
@@ -579,11 +730,24 @@ void Ichor::DependencyManager::processEvent(std::unique_ptr<Event> &&uniqueEvt)
                 auto *removeEventHandlerEvt = static_cast<RemoveEventHandlerEvent *>(evt.get());
 
                 // key.id = service id, key.type == event id
-                auto existingHandlers = _eventCallbacks.find(removeEventHandlerEvt->key.type);
-                if (existingHandlers != end(_eventCallbacks)) [[likely]] {
-                    std::erase_if(existingHandlers->second, [removeEventHandlerEvt](const EventCallbackInfo &info) noexcept {
-                        return info.listeningServiceId == removeEventHandlerEvt->key.id;
-                    });
+                if(removeEventHandlerEvt->targetServiceId.has_value()) {
+                    auto existingHandlers = _targetedEventCallbacks.find(CallbackKey{*removeEventHandlerEvt->targetServiceId, removeEventHandlerEvt->key.type});
+                    if (existingHandlers != end(_targetedEventCallbacks)) [[likely]] {
+                        std::erase_if(existingHandlers->second, [removeEventHandlerEvt](const EventCallbackInfo &info) noexcept {
+                            return info.listeningServiceId == removeEventHandlerEvt->key.id;
+                        });
+                        // target services come and go, e.g. connections, don't keep their keys around
+                        if(existingHandlers->second.empty()) {
+                            _targetedEventCallbacks.erase(existingHandlers);
+                        }
+                    }
+                } else {
+                    auto existingHandlers = _eventCallbacks.find(removeEventHandlerEvt->key.type);
+                    if (existingHandlers != end(_eventCallbacks)) [[likely]] {
+                        std::erase_if(existingHandlers->second, [removeEventHandlerEvt](const EventCallbackInfo &info) noexcept {
+                            return info.listeningServiceId == removeEventHandlerEvt->key.id;
+                        });
+                    }
                 }
             }
                 break;
@@ -608,71 +772,45 @@ void Ichor::DependencyManager::processEvent(std::unique_ptr<Event> &&uniqueEvt)
                 _dependencyUndoRequestTrackers.erase(removeTrackerEvt->interfaceNameHash);
             }
                 break;
-            case ContinuableEvent::TYPE: {
-                auto *continuableEvt = static_cast<ContinuableEvent *>(evt.get());
-                INTERNAL_DEBUG("ContinuableEventAsync {} {} {}", continuableEvt->promiseId, evt->id, evt->priority);
-                auto genIt = _scopedGenerators.find(continuableEvt->promiseId);
-
-                if (genIt != _scopedGenerators.end()) {
-                    INTERNAL_DEBUG("ContinuableEventAsync2 {}", genIt->second->done());
-
-                    if (!genIt->second->done()) {
-                        auto it = genIt->second->begin_interface();
-                        INTERNAL_DEBUG("ContinuableEventAsync it {} {} {}", it->get_finished(), it->get_op_state(), it->get_promise_state());
-
-                        if (!it->get_finished() && it->get_promise_state() != state::value_not_ready_consumer_active) {
-                            if constexpr (DO_INTERNAL_DEBUG || DO_INTERNAL_COROUTINE_DEBUG) {
-                                if (!it->get_has_suspended()) [[unlikely]] {
-                                    INTERNAL_DEBUG("{}", it->get_promise_id());
-                                    std::terminate();
-                                }
-                            }
-                            INTERNAL_DEBUG("ContinuableEventAsync push event {}", continuableEvt->promiseId);
-                            _eventQueue->pushPrioritisedEvent<ContinuableEvent>(continuableEvt->originatingService, evt->priority, continuableEvt->promiseId);
-                        }
+            case ResumeCoroutinesEvent::TYPE: {
+                INTERNAL_DEBUG("ResumeCoroutinesEvent {} {} {}", evt->id, evt->priority, _readyCoroutines.size());
+                auto const queuedIt = std::find(_resumeCoroutinesPriorities.begin(), _resumeCoroutinesPriorities.end(), evt->priority);
+                if(queuedIt != _resumeCoroutinesPriorities.end()) {
+                    *queuedIt = _resumeCoroutinesPriorities.back();
+                    _resumeCoroutinesPriorities.pop_back();
+                }
 
-                        if (it->get_finished()) {
-                            INTERNAL_DEBUG("removed1 {} {}", continuableEvt->promiseId, _scopedGenerators.size() - 1);
-                            auto origEventIt = _scopedEvents.find(continuableEvt->promiseId);
+                drainRemoteResumptions();
 
-                            if constexpr (DO_INTERNAL_DEBUG || DO_HARDENING) {
-                                if (origEventIt == end(_scopedEvents)) [[unlikely]] {
-                                    std::terminate();
-                                }
-                            }
-
-                            handleEventCompletion(*origEventIt->second);
-                            _scopedGenerators.erase(continuableEvt->promiseId);
-                            _scopedEvents.erase(continuableEvt->promiseId);
-                        }
+                // coroutines scheduled while continuing wait for the next ResumeCoroutinesEvent, so that yielding coroutines cannot starve the queue
+                auto const sequenceLimit = _readyCoroutineSequence;
+                while(!_readyCoroutines.empty() && _readyCoroutines.front().priority <= evt->priority && _readyCoroutines.front().sequence < sequenceLimit) {
+                    std::pop_heap(_readyCoroutines.begin(), _readyCoroutines.end());
+                    auto ready = _readyCoroutines.back();
+                    _readyCoroutines.pop_back();
+                    if(ready.awaiter) {
+                        ready.awaiter.resume();
                     } else {
-                        INTERNAL_DEBUG("removed2 {} {}", continuableEvt->promiseId, _scopedGenerators.size() - 1);
-                        auto origEventIt = _scopedEvents.find(continuableEvt->promiseId);
-
-                        if constexpr (DO_INTERNAL_DEBUG || DO_HARDENING) {
-                            if (origEventIt == end(_scopedEvents)) [[unlikely]] {
-                                std::terminate();
-                            }
-                        }
-
-                        handleEventCompletion(*origEventIt->second);
-                        _scopedGenerators.erase(continuableEvt->promiseId);
-                        _scopedEvents.erase(continuableEvt->promiseId);
+                        continueScopedCoroutine(ready);
                     }
                 }
+
+                if(!_readyCoroutines.empty()) {
+                    armResumeCoroutines(_readyCoroutines.front().priority);
+                }
             }
                 break;
             case ContinuableStartEvent::TYPE: {
                 auto *continuableEvt = static_cast<ContinuableStartEvent *>(evt.get());
                 INTERNAL_DEBUG("ContinuableStartEvent {} {} {}", continuableEvt->promiseId, evt->id, evt->priority);
-                auto genIt = _scopedGenerators.find(continuableEvt->promiseId);
+                auto genIt = _scopedCoroutines.find(continuableEvt->promiseId);
 
-                if (genIt != _scopedGenerators.end()) {
-                    INTERNAL_DEBUG("ContinuableStartEvent {}", genIt->second->done());
+                if (genIt != _scopedCoroutines.end()) {
+                    INTERNAL_DEBUG("ContinuableStartEvent {}", genIt->second.generator->done());
 
                     StartBehaviour it_ret;
-                    if (!genIt->second->done()) {
-                        auto it = genIt->second->begin_interface();
+                    if (!genIt->second.generator->done()) {
+                        auto it = genIt->second.generator->begin_interface();
                         INTERNAL_DEBUG("ContinuableStartEvent it {} {} {}", it->get_finished(), it->get_op_state(), it->get_promise_state());
 
                         if (!it->get_finished()) {
@@ -687,27 +825,27 @@ void Ichor::DependencyManager::processEvent(std::unique_ptr<Event> &&uniqueEvt)
 
                         it_ret = static_cast<Detail::AsyncGeneratorBeginOperation<StartBehaviour>*>(it.get())->get_value();
                     } else {
-                        it_ret = static_cast<AsyncGenerator<StartBehaviour>*>(genIt->second.get())->get_value();
+                        it_ret = static_cast<AsyncGenerator<StartBehaviour>*>(genIt->second.generator.get())->get_value();
                     }
 
-                    INTERNAL_DEBUG("ContinuableStartEvent removed {} {} {}", it_ret, continuableEvt->promiseId, _scopedGenerators.size() - 1);
-                    auto origEvtIt = _scopedEvents.find(continuableEvt->promiseId);
+                    INTERNAL_DEBUG("ContinuableStartEvent removed {} {} {}", it_ret, continuableEvt->promiseId, _scopedCoroutines.size() - 1);
+                    auto origEvtIt = _scopedCoroutines.find(continuableEvt->promiseId);
 
                     if constexpr (DO_INTERNAL_DEBUG || DO_HARDENING) {
-                        if (origEvtIt == end(_scopedEvents)) [[unlikely]] {
+                        if (origEvtIt == end(_scopedCoroutines)) [[unlikely]] {
                             throw std::runtime_error("This should never happen, but it did?");
                         }
                     }
 
-                    if(origEvtIt->second->type == StartServiceEvent::TYPE) {
-                        auto origEvt = static_cast<StartServiceEvent*>(origEvtIt->second.get());
+                    if(origEvtIt->second.event->type == StartServiceEvent::TYPE) {
+                        auto origEvt = static_cast<StartServiceEvent*>(origEvtIt->second.event.get());
 
                         INTERNAL_DEBUG("Finishing handling StartServiceEvent {} {} {} {}", origEvt->id, origEvt->priority, origEvt->originatingService, origEvt->serviceId);
 
                         _eventQueue->pushPrioritisedEvent<DependencyOnlineEvent>(origEvt->serviceId, INTERNAL_COROUTINE_EVENT_PRIORITY);
                         handleEventCompletion(*origEvt);
-                    } else if(origEvtIt->second->type == StopServiceEvent::TYPE) {
-                        auto origEvt = static_cast<StopServiceEvent *>(origEvtIt->second.get());
+                    } else if(origEvtIt->second.event->type == StopServiceEvent::TYPE) {
+                        auto origEvt = static_cast<StopServiceEvent *>(origEvtIt->second.event.get());
 
                         INTERNAL_DEBUG("Finishing handling StopServiceEvent {} {} {} {}", origEvt->id, origEvt->priority, origEvt->originatingService, origEvt->serviceId);
 
@@ -731,8 +869,8 @@ void Ichor::DependencyManager::processEvent(std::unique_ptr<Event> &&uniqueEvt)
                         }
 
                         handleEventCompletion(*origEvt);
-                    } else if(origEvtIt->second->type == DependencyOnlineEvent::TYPE) {
-                        auto origEvt = static_cast<DependencyOnlineEvent *>(origEvtIt->second.get());
+                    } else if(origEvtIt->second.event->type == DependencyOnlineEvent::TYPE) {
+                        auto origEvt = static_cast<DependencyOnlineEvent *>(origEvtIt->second.event.get());
 
                         INTERNAL_DEBUG("Finishing handling DependencyOnlineEvent {} {} {}", origEvt->id, origEvt->priority, origEvt->originatingService);
 
@@ -743,8 +881,8 @@ void Ichor::DependencyManager::processEvent(std::unique_ptr<Event> &&uniqueEvt)
                             _eventQueue->pushPrioritisedEvent<DependencyOnlineEvent>(origEvt->originatingService, INTERNAL_COROUTINE_EVENT_PRIORITY);
                         }
                         handleEventCompletion(*origEvt);
-                    } else if(origEvtIt->second->type == ContinuableDependencyOfflineEvent::TYPE) {
-                        auto origEvt = static_cast<ContinuableDependencyOfflineEvent *>(origEvtIt->second.get());
+                    } else if(origEvtIt->second.event->type == ContinuableDependencyOfflineEvent::TYPE) {
+                        auto origEvt = static_cast<ContinuableDependencyOfflineEvent *>(origEvtIt->second.event.get());
 
                         INTERNAL_DEBUG("Finishing handling ContinuableDependencyOfflineEvent {} {} {} {}", origEvt->id, origEvt->priority, origEvt->originatingService, origEvt->originatingOfflineServiceId);
 
@@ -784,12 +922,11 @@ void Ichor::DependencyManager::processEvent(std::unique_ptr<Event> &&uniqueEvt)
 
                         handleEventCompletion(*origEvt);
                     } else {
-                        fmt::print("{}\n", origEvtIt->second->name);
+                        fmt::print("{}\n", origEvtIt->second.event->name);
                         throw std::runtime_error("Something went wrong, file a bug");
                     }
 
-                    _scopedGenerators.erase(continuableEvt->promiseId);
-                    _scopedEvents.erase(continuableEvt->promiseId);
+                    removeScopedCoroutine(continuableEvt->promiseId);
                 }
             }
                 break;
@@ -812,6 +949,64 @@ void Ichor::DependencyManager::processEvent(std::unique_ptr<Event> &&uniqueEvt)
                 handleEventCompletion(*runFunctionEvt);
             }
                 break;
+            case TimerEvent::TYPE: {
+                INTERNAL_DEBUG("TimerEvent {} {}", evt->id, evt->priority);
+                auto *timerEvt = static_cast<TimerEvent *>(evt.get());
+                auto timerIt = _timers.find(timerEvt->timerId);
+
+                // Destroyed or stopped since it expired
+                if(timerIt == _timers.end()) {
+                    handleEventError(*timerEvt);
+                    break;
+                }
+                auto expiries = std::exchange(timerIt->second->_queuedExpiries, 0);
+                if(!timerIt->second->running()) {
+                    handleEventError(*timerEvt);
+                    break;
+                }
+
+                // Do not handle stale timer events
+                if(timerEvt->originatingService != 0) {
+                    auto requestingServiceIt = _services.find(timerEvt->originatingService);
+                    if(requestingServiceIt != end(_services) && requestingServiceIt->second->getServiceState() == ServiceState::INSTALLED) {
+                        INTERNAL_DEBUG("Service {}:{} not active", timerEvt->originatingService, requestingServiceIt->second->implementationName());
+                        handleEventError(*timerEvt);
+                        break;
+                    }
+                }
+
+                if(timerIt->second->_fnAsync) {
+                    // A single coroutine runs the callback for all expiries in order. Copied, the coroutine may outlive the timer.
+                    _eventQueue->pushPrioritisedEvent<RunFunctionEventAsync>(timerEvt->originatingService, timerEvt->priority,
+                                                                             [this, timerId = timerEvt->timerId, fn = timerIt->second->_fnAsync, expiries]() mutable -> AsyncGenerator<IchorBehaviour> {
+                        while(true) {
+                            co_await fn().begin();
+                            auto it = _timers.find(timerId);
+                            if(it == _timers.end() || !it->second->running() || --expiries == 0) {
+                                break;
+                            }
+                        }
+                        co_return {};
+                    });
+                    handleEventCompletion(*timerEvt);
+                    break;
+                }
+
+                // Moved out while running, the callback may destroy its own timer. Moving does not allocate, unlike the copy a RunFunctionEvent would need.
+                auto fn = std::move(timerIt->second->_fn);
+                while(true) {
+                    fn();
+                    timerIt = _timers.find(timerEvt->timerId);
+                    if(timerIt == _timers.end() || !timerIt->second->running() || --expiries == 0) {
+                        break;
+                    }
+                }
+                if(timerIt != _timers.end() && !timerIt->second->_fn && !timerIt->second->_fnAsync) {
+                    timerIt->second->_fn = std::move(fn);
+                }
+                handleEventCompletion(*timerEvt);
+            }
+                break;
             case RunFunctionEventAsync::TYPE: {
                 INTERNAL_DEBUG("RunFunctionEventAsync {} {}", evt->id, evt->priority);
                 auto *runFunctionEvt = static_cast<RunFunctionEventAsync *>(evt.get());
@@ -831,7 +1026,7 @@ void Ichor::DependencyManager::processEvent(std::unique_ptr<Event> &&uniqueEvt)
                 INTERNAL_DEBUG("state: {} {} {} {} {}", gen.done(), it.get_finished(), it.get_op_state(), it.get_promise_state(), it.get_promise_id());
 
                 if (!it.get_finished() && it.get_promise_state() != state::value_not_ready_consumer_active) {
-                    _eventQueue->pushPrioritisedEvent<ContinuableEvent>(runFunctionEvt->originatingService, evt->priority, it.get_promise_id());
+                    scheduleContinuation(it.get_promise_id(), runFunctionEvt->originatingService, evt->priority);
                 }
 
                 if (!it.get_finished()) {
@@ -840,10 +1035,9 @@ void Ichor::DependencyManager::processEvent(std::unique_ptr<Event> &&uniqueEvt)
                             std::terminate();
                         }
                     }
-                    INTERNAL_DEBUG("contains2 {} {} {}", it.get_promise_id(), _scopedGenerators.contains(it.get_promise_id()),
-                                   _scopedGenerators.size() + 1);
-                    _scopedGenerators.emplace(it.get_promise_id(), std::make_unique<AsyncGenerator<IchorBehaviour>>(std::move(gen)));
-                    _scopedEvents.emplace(it.get_promise_id(), evt);
+                    INTERNAL_DEBUG("contains2 {} {} {}", it.get_promise_id(), _scopedCoroutines.contains(it.get_promise_id()),
+                                   _scopedCoroutines.size() + 1);
+                    addScopedCoroutine(it.get_promise_id(), std::make_unique<AsyncGenerator<IchorBehaviour>>(std::move(gen)), evt);
                 } else {
                     if constexpr (DO_INTERNAL_DEBUG) {
                         if (it.get_has_suspended()) [[unlikely]] {
@@ -877,15 +1071,261 @@ void Ichor::DependencyManager::processEvent(std::unique_ptr<Event> &&uniqueEvt)
 
 }
 
+void Ichor::DependencyManager::notifyDependentsOnline(std::unique_ptr<ILifecycleManager> &manager, [[maybe_unused]] uint64_t eventId, std::vector<uint64_t> const &skip) {
+    auto const filterProp = manager->getProperties().find(Detail::filterPropertyKey);
+    const Filter *filter = nullptr;
+    if (filterProp != cend(manager->getProperties())) {
+        filter = Ichor::any_cast<Filter *const>(&filterProp->second);
+    }
+
+    auto notifyDependent = [this, &manager, filter, eventId, &skip](uint64_t serviceId, ILifecycleManager &possibleDependentLifecycleManager) {
+        auto depIts = possibleDependentLifecycleManager.interestedInDependency(manager.get(), true);
+
+        if(depIts.empty()) {
+            return;
+        }
+
+        if (serviceId == manager->serviceId() || std::find(skip.begin(), skip.end(), serviceId) != skip.end() || (filter != nullptr && !filter->compareTo(possibleDependentLifecycleManager))) {
+            return;
+        }
+
+        if(possibleDependentLifecycleManager.dependencyOnlineSync(manager.get(), depIts)) {
+            INTERNAL_DEBUG("DependencyOnlineEvent {} interested service is {} handled synchronously", eventId, serviceId);
+            return;
+        }
+
+        auto gen = possibleDependentLifecycleManager.dependencyOnline(manager.get(), std::move(depIts));
+        auto it = gen.begin();
+
+        INTERNAL_DEBUG("DependencyOnlineEvent {} interested service is {} {} {}", eventId, serviceId, it.get_promise_id(), it.get_finished());
+
+        if(!it.get_finished()) {
+            if constexpr (DO_INTERNAL_DEBUG) {
+                if (!it.get_has_suspended()) [[unlikely]] {
+                    std::terminate();
+                }
+            }
+            // create new event that will be inserted upon finish of coroutine in ContinuableStartEvent
+            addScopedCoroutine(it.get_promise_id(), std::make_unique<AsyncGenerator<StartBehaviour>>(std::move(gen)), std::make_shared<DependencyOnlineEvent>(_eventQueue->getNextEventId(), serviceId, INTERNAL_DEPENDENCY_EVENT_PRIORITY));
+        } else if(gen.get_value() == StartBehaviour::STARTED) {
+            _eventQueue->pushPrioritisedEvent<DependencyOnlineEvent>(serviceId, INTERNAL_DEPENDENCY_EVENT_PRIORITY);
+        }
+    };
+
+    // A filter selecting a specific service can only ever match that service, no need to check all others.
+    auto const selectedServiceId = filter != nullptr ? filter->selectedServiceId() : std::optional<uint64_t>{};
+    if(selectedServiceId.has_value()) {
+        auto selectedIt = _services.find(*selectedServiceId);
+        if(selectedIt != _services.end()) {
+            notifyDependent(selectedIt->first, *selectedIt->second);
+        }
+    } else {
+        for (auto const &[serviceId, possibleDependentLifecycleManager] : _services) {
+            notifyDependent(serviceId, *possibleDependentLifecycleManager);
+        }
+    }
+}
+
+void Ichor::DependencyManager::indexService(ILifecycleManager &mgr) {
+    for(auto const &intf : mgr.getInterfaces()) {
+        _servicesByInterface[intf.interfaceNameHash].push_back(Detail::InterfaceProvider{&mgr, nullptr});
+    }
+}
+
+void Ichor::DependencyManager::unindexService(ILifecycleManager const &mgr) noexcept {
+    unindexStartedService(mgr);
+    for(auto const &intf : mgr.getInterfaces()) {
+        auto providers = _servicesByInterface.find(intf.interfaceNameHash);
+        if(providers == _servicesByInterface.end()) {
+            continue;
+        }
+        std::erase_if(providers->second, [&mgr](Detail::InterfaceProvider const &provider) { return provider.mgr == &mgr; });
+    }
+}
+
+void Ichor::DependencyManager::indexStartedService(ILifecycleManager &mgr) {
+    for(auto const &intf : mgr.getInterfaces()) {
+        auto &providers = _servicesByInterface[intf.interfaceNameHash];
+        auto provider = std::find_if(providers.begin(), providers.end(), [&mgr](Detail::InterfaceProvider const &p) { return p.mgr == &mgr; });
+        if(provider == providers.end()) {
+            provider = providers.insert(providers.end(), Detail::InterfaceProvider{&mgr, nullptr});
+        }
+
+        // the service is ACTIVE, so resolving its interface pointer is always possible here
+        Detail::resolveInterfaceProvider(*provider, intf.interfaceNameHash);
+        _startedServicesByInterface[intf.interfaceNameHash].push_back(*provider);
+    }
+}
+
+void Ichor::DependencyManager::unindexStartedService(ILifecycleManager const &mgr) noexcept {
+    for(auto const &intf : mgr.getInterfaces()) {
+        auto providers = _startedServicesByInterface.find(intf.interfaceNameHash);
+        if(providers == _startedServicesByInterface.end()) {
+            continue;
+        }
+        std::erase_if(providers->second, [&mgr](Detail::InterfaceProvider const &provider) { return provider.mgr == &mgr; });
+    }
+}
+
+void Ichor::DependencyManager::activateLazyService(unordered_map<uint64_t, Detail::LazyService>::iterator lazyIt, ILifecycleManager &mgr) {
+    INTERNAL_DEBUG("activating lazy service {}:{}", mgr.serviceId(), mgr.implementationName());
+    lazyIt->second.dormant = false;
+    lazyIt->second.idle = false;
+    mgr.setDormant(false);
+    _eventQueue->pushPrioritisedEvent<StartServiceEvent>(mgr.serviceId(), INTERNAL_DEPENDENCY_EVENT_PRIORITY, mgr.serviceId());
+    scheduleLazyIdleCheck();
+}
+
+void Ichor::DependencyManager::activateLazyProviders(uint64_t interfaceHash, uint64_t requestingServiceId) {
+    auto requestingIt = _services.find(requestingServiceId);
+
+    for(auto lazyIt = _lazyServices.begin(); lazyIt != _lazyServices.end(); ++lazyIt) {
+        if(!lazyIt->second.dormant) {
+            continue;
+        }
+
+        auto svcIt = _services.find(lazyIt->first);
+        if(svcIt == _services.end()) {
+            continue;
+        }
+
+        auto &mgr = svcIt->second;
+        auto const &interfaces = mgr->getInterfaces();
+        if(std::find_if(interfaces.begin(), interfaces.end(), [interfaceHash](Dependency const &dep) { return dep.interfaceNameHash == interfaceHash; }) == interfaces.end()) {
+            continue;
+        }
+
+        if(requestingIt != _services.end()) {
+            auto const filterProp = mgr->getProperties().find(Detail::filterPropertyKey);
+            if (filterProp != cend(mgr->getProperties()) && !Ichor::any_cast<Filter * const>(&filterProp->second)->compareTo(*requestingIt->second)) {
+                continue;
+            }
+        }
+
+        activateLazyService(lazyIt, *mgr);
+    }
+}
+
+void Ichor::DependencyManager::scheduleLazyIdleCheck() noexcept {
+    // check a few times per timeout, so that services are stopped reasonably close to their timeout
+    std::chrono::milliseconds interval{};
+    for(auto const &[serviceId, lazy] : _lazyServices) {
+        if(lazy.dormant || lazy.idleTimeout.count() == 0) {
+            continue;
+        }
+
+        auto const serviceInterval = std::max(std::chrono::milliseconds(1), lazy.idleTimeout / 4);
+        if(interval.count() == 0 || serviceInterval < interval) {
+            interval = serviceInterval;
+        }
+    }
+
+    if(interval.count() == 0) {
+        return;
+    }
+
+    auto const deadline = std::chrono::steady_clock::now() + interval;
+    if(_lazyIdleCheckEntry.isScheduled()) {
+        if(_lazyIdleCheckDeadline <= deadline) {
+            return;
+        }
+        cancelTimer(_lazyIdleCheckEntry);
+    }
+
+    _lazyIdleCheckDeadline = deadline;
+    scheduleTimer(_lazyIdleCheckEntry, deadline, {});
+}
+
+void Ichor::DependencyManager::registerTimer(Timer &timer) {
+    _timers.emplace(timer.getTimerId(), &timer);
+}
+
+void Ichor::DependencyManager::unregisterTimer(Timer &timer) noexcept {
+    cancelTimer(timer);
+    _timers.erase(timer.getTimerId());
+}
+
+void Ichor::DependencyManager::scheduleTimer(Detail::TimingWheelEntry &entry, std::chrono::steady_clock::time_point when, std::chrono::nanoseconds slack) noexcept {
+    auto const sinceStart = std::chrono::ceil<std::chrono::microseconds>(when - _timerWheelStart).count();
+    auto const slackTicks = static_cast<uint64_t>(std::chrono::floor<std::chrono::microseconds>(slack).count());
+    auto const deadline = Detail::TimingWheel::coalesce(static_cast<uint64_t>(std::max(int64_t{0}, static_cast<int64_t>(sinceStart))), slackTicks);
+    _timerWheel.insert(entry, deadline);
+
+    auto const expiry = _timerWheelStart + std::chrono::microseconds(deadline);
+    if(expiry < _nextTimerExpiry) {
+        _nextTimerExpiry = expiry;
+    }
+}
+
+void Ichor::DependencyManager::cancelTimer(Detail::TimingWheelEntry &entry) noexcept {
+    _timerWheel.remove(entry);
+
+    // otherwise left as is, an expiry that turns out to be early only costs an extra expireTimers()
+    if(_timerWheel.empty()) {
+        _nextTimerExpiry = std::chrono::steady_clock::time_point::max();
+    }
+}
+
+std::optional<std::chrono::steady_clock::time_point> Ichor::DependencyManager::nextTimerExpiry() const noexcept {
+    if(_nextTimerExpiry == std::chrono::steady_clock::time_point::max()) {
+        return {};
+    }
+
+    return _nextTimerExpiry;
+}
+
+void Ichor::DependencyManager::expireTimers() {
+    if(_timerWheel.empty()) {
+        return;
+    }
+
+    auto const now = std::chrono::steady_clock::now();
+    if(now < _nextTimerExpiry) {
+        return;
+    }
+
+    auto const elapsed = std::chrono::floor<std::chrono::microseconds>(now - _timerWheelStart).count();
+    _timerWheel.advance(static_cast<uint64_t>(elapsed), [this, now](Detail::TimingWheelEntry &entry) {
+        if(&entry == &_lazyIdleCheckEntry) {
+            _eventQueue->pushPrioritisedEvent<LazyIdleCheckEvent>(0, INTERNAL_EVENT_PRIORITY);
+            return;
+        }
+
+        static_cast<Timer&>(entry).expire(now);
+    });
+
+    auto const next = _timerWheel.nextDeadline();
+    _nextTimerExpiry = next ? _timerWheelStart + std::chrono::microseconds(*next) : std::chrono::steady_clock::time_point::max();
+}
+
 void Ichor::DependencyManager::stop() {
-    for(auto &[key, manager] : _services) {
-        if(manager->getServiceState() != ServiceState::ACTIVE) {
+    cancelTimer(_lazyIdleCheckEntry);
+
+    // copied, cancellation callbacks may request new tokens
+    std::vector<CancellationSource> stopSources{};
+    stopSources.reserve(_serviceStopSources.size());
+    for(auto &[serviceId, source] : _serviceStopSources) {
+        stopSources.push_back(source);
+    }
+    for(auto &source : stopSources) {
+        source.requestCancellation();
+    }
+
+    for(auto it = _services.begin(); it != _services.end(); ++it) {
+        if(_services.state(it) != ServiceState::ACTIVE) {
             continue;
         }
 
-        auto _ = manager->stop().begin();
+        auto _ = it->second->stop().begin();
     }
 
+    _readyCoroutines.clear();
+    _resumeCoroutinesPriorities.clear();
+    _serviceStopSources.clear();
+    _remoteResumptions.store(nullptr, std::memory_order_release);
+    _remoteResumptionPriority.store(std::numeric_limits<uint64_t>::max(), std::memory_order_release);
+    _startedServicesByInterface.clear();
+    _servicesByInterface.clear();
     _services.clear();
 
     if(_communicationChannel != nullptr) {
@@ -897,24 +1337,197 @@ void Ichor::DependencyManager::stop() {
 }
 
 bool Ichor::DependencyManager::existingCoroutineFor(uint64_t serviceId) const noexcept {
-    auto existingCoroutineEvent = std::find_if(_scopedEvents.begin(), _scopedEvents.end(), [serviceId](const std::pair<uint64_t, std::shared_ptr<Event>> &t) {
-        if(t.second->type == StartServiceEvent::TYPE) {
-            return t.second->originatingService == serviceId || static_cast<StartServiceEvent*>(t.second.get())->serviceId == serviceId;
+    auto countIt = _scopedCoroutineCounts.find(serviceId);
+
+    if constexpr (DO_INTERNAL_DEBUG) {
+        if(countIt != _scopedCoroutineCounts.end()) {
+            INTERNAL_DEBUG("existingCoroutineEvent {} {}", serviceId, countIt->second);
         }
-        if(t.second->type == ContinuableDependencyOfflineEvent::TYPE) {
-            return static_cast<ContinuableDependencyOfflineEvent*>(t.second.get())->originatingOfflineServiceId == serviceId;
+    }
+
+    return countIt != _scopedCoroutineCounts.end();
+}
+
+void Ichor::DependencyManager::addScopedCoroutine(uint64_t promiseId, std::unique_ptr<IGenerator> generator, std::shared_ptr<Event> evt) {
+    // Determine which services this coroutine belongs to, used by existingCoroutineFor to prevent stopping a service with in-flight coroutines
+    std::array<uint64_t, 2> trackedServiceIds{};
+    if(evt->type == StartServiceEvent::TYPE) {
+        trackedServiceIds[0] = evt->originatingService;
+        auto serviceId = static_cast<StartServiceEvent*>(evt.get())->serviceId;
+        if(serviceId != evt->originatingService) {
+            trackedServiceIds[1] = serviceId;
         }
+    } else if(evt->type == ContinuableDependencyOfflineEvent::TYPE) {
+        trackedServiceIds[0] = static_cast<ContinuableDependencyOfflineEvent*>(evt.get())->originatingOfflineServiceId;
+    } else if(evt->type != DependencyOfflineEvent::TYPE && evt->type != StopServiceEvent::TYPE) {
+        trackedServiceIds[0] = evt->originatingService;
+    }
 
-        return t.second->originatingService == serviceId && t.second->type != DependencyOfflineEvent::TYPE && t.second->type != StopServiceEvent::TYPE;
+    auto [slotIt, inserted] = _scopedCoroutines.try_emplace(promiseId, Detail::ScopedCoroutine{std::move(generator), std::move(evt), trackedServiceIds});
+
+    if(!inserted) [[unlikely]] {
+        INTERNAL_DEBUG("addScopedCoroutine {} already exists", promiseId);
+        return;
+    }
+
+    for(auto serviceId : slotIt->second.trackedServiceIds) {
+        if(serviceId != 0) {
+            _scopedCoroutineCounts[serviceId]++;
+        }
+    }
+}
+
+void Ichor::DependencyManager::scheduleContinuation(uint64_t promiseId, uint64_t originatingService, uint64_t priority) {
+    _readyCoroutines.push_back(Detail::ReadyCoroutine{priority, _readyCoroutineSequence++, promiseId, originatingService});
+    std::push_heap(_readyCoroutines.begin(), _readyCoroutines.end());
+    armResumeCoroutines(priority);
+}
+
+void Ichor::DependencyManager::armResumeCoroutines(uint64_t priority) {
+    // A queued event with a more urgent priority re-arms for whatever is left when it is handled
+    auto const queued = std::any_of(_resumeCoroutinesPriorities.begin(), _resumeCoroutinesPriorities.end(), [priority](uint64_t queuedPriority) {
+        return queuedPriority <= priority;
     });
 
-    if constexpr (DO_INTERNAL_DEBUG) {
-        if(existingCoroutineEvent != _scopedEvents.end()) {
-            INTERNAL_DEBUG("existingCoroutineEvent {} {} {}", serviceId, existingCoroutineEvent->second->name, existingCoroutineEvent->second->originatingService);
+    if(!queued) {
+        _eventQueue->pushPrioritisedEvent<ResumeCoroutinesEvent>(0, priority);
+        _resumeCoroutinesPriorities.push_back(priority);
+    }
+}
+
+void Ichor::DependencyManager::scheduleRemoteResumption(Detail::RemoteResumption &resumption) noexcept {
+    if(this == Detail::_local_dm) {
+        _readyCoroutines.push_back(Detail::ReadyCoroutine{resumption.priority, _readyCoroutineSequence++, 0, 0, resumption.awaiter});
+        std::push_heap(_readyCoroutines.begin(), _readyCoroutines.end());
+        armResumeCoroutines(resumption.priority);
+        return;
+    }
+
+    // resumption lives in the coroutine frame, which may be destroyed on our thread as soon as it is on the stack
+    auto const priority = resumption.priority;
+    resumption.next = _remoteResumptions.load(std::memory_order_relaxed);
+    while(!_remoteResumptions.compare_exchange_weak(resumption.next, &resumption, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+    }
+
+    // Pairs with drainRemoteResumptions resetting the priority before taking the stack: either it sees our resumption or we see the reset.
+    auto pendingPriority = _remoteResumptionPriority.load(std::memory_order_seq_cst);
+    while(priority < pendingPriority) {
+        if(_remoteResumptionPriority.compare_exchange_weak(pendingPriority, priority, std::memory_order_seq_cst, std::memory_order_seq_cst)) {
+            _eventQueue->pushPrioritisedEvent<ResumeCoroutinesEvent>(0, priority);
+            break;
+        }
+    }
+}
+
+void Ichor::Detail::resumeOn(DependencyManager *dm, RemoteResumption &resumption) noexcept {
+    if(dm == nullptr) {
+        resumption.awaiter.resume();
+        return;
+    }
+
+    dm->scheduleRemoteResumption(resumption);
+}
+
+void Ichor::DependencyManager::drainRemoteResumptions() {
+    _remoteResumptionPriority.store(std::numeric_limits<uint64_t>::max(), std::memory_order_seq_cst);
+    auto *resumption = _remoteResumptions.exchange(nullptr, std::memory_order_seq_cst);
+
+    // stack is in reverse order of scheduling
+    Detail::RemoteResumption *reversed{};
+    while(resumption != nullptr) {
+        auto *next = resumption->next;
+        resumption->next = reversed;
+        reversed = resumption;
+        resumption = next;
+    }
+
+    while(reversed != nullptr) {
+        INTERNAL_DEBUG("drainRemoteResumptions {}", reversed->priority);
+        _readyCoroutines.push_back(Detail::ReadyCoroutine{reversed->priority, _readyCoroutineSequence++, 0, 0, reversed->awaiter});
+        std::push_heap(_readyCoroutines.begin(), _readyCoroutines.end());
+        reversed = reversed->next;
+    }
+}
+
+void Ichor::DependencyManager::continueScopedCoroutine(Detail::ReadyCoroutine const &ready) {
+    INTERNAL_DEBUG("continueScopedCoroutine {} {}", ready.promiseId, ready.priority);
+    auto genIt = _scopedCoroutines.find(ready.promiseId);
+
+    if (genIt != _scopedCoroutines.end()) {
+        INTERNAL_DEBUG("continueScopedCoroutine done {}", genIt->second.generator->done());
+
+        if (!genIt->second.generator->done()) {
+            auto it = genIt->second.generator->begin_interface();
+            INTERNAL_DEBUG("continueScopedCoroutine it {} {} {}", it->get_finished(), it->get_op_state(), it->get_promise_state());
+
+            if (!it->get_finished() && it->get_promise_state() != state::value_not_ready_consumer_active) {
+                if constexpr (DO_INTERNAL_DEBUG || DO_INTERNAL_COROUTINE_DEBUG) {
+                    if (!it->get_has_suspended()) [[unlikely]] {
+                        INTERNAL_DEBUG("{}", it->get_promise_id());
+                        std::terminate();
+                    }
+                }
+                INTERNAL_DEBUG("continueScopedCoroutine reschedule {}", ready.promiseId);
+                scheduleContinuation(ready.promiseId, ready.originatingService, ready.priority);
+            }
+
+            if (it->get_finished()) {
+                INTERNAL_DEBUG("removed1 {} {}", ready.promiseId, _scopedCoroutines.size() - 1);
+                auto origEventIt = _scopedCoroutines.find(ready.promiseId);
+
+                if constexpr (DO_INTERNAL_DEBUG || DO_HARDENING) {
+                    if (origEventIt == end(_scopedCoroutines)) [[unlikely]] {
+                        std::terminate();
+                    }
+                }
+
+                handleEventCompletion(*origEventIt->second.event);
+                removeScopedCoroutine(ready.promiseId);
+            }
+        } else {
+            INTERNAL_DEBUG("removed2 {} {}", ready.promiseId, _scopedCoroutines.size() - 1);
+            auto origEventIt = _scopedCoroutines.find(ready.promiseId);
+
+            if constexpr (DO_INTERNAL_DEBUG || DO_HARDENING) {
+                if (origEventIt == end(_scopedCoroutines)) [[unlikely]] {
+                    std::terminate();
+                }
+            }
+
+            handleEventCompletion(*origEventIt->second.event);
+            removeScopedCoroutine(ready.promiseId);
         }
     }
+}
+
+void Ichor::DependencyManager::removeScopedCoroutine(uint64_t promiseId) noexcept {
+    auto slotIt = _scopedCoroutines.find(promiseId);
 
-    return existingCoroutineEvent != _scopedEvents.end();
+    if(slotIt == _scopedCoroutines.end()) {
+        return;
+    }
+
+    for(auto serviceId : slotIt->second.trackedServiceIds) {
+        if(serviceId == 0) {
+            continue;
+        }
+
+        auto countIt = _scopedCoroutineCounts.find(serviceId);
+
+        if constexpr (DO_INTERNAL_DEBUG || DO_HARDENING) {
+            if(countIt == _scopedCoroutineCounts.end()) [[unlikely]] {
+                std::terminate();
+            }
+        }
+
+        if(--countIt->second == 0) {
+            _scopedCoroutineCounts.erase(countIt);
+        }
+    }
+
+    // move out before erasing, destroying the generator may run code that touches _scopedCoroutines
+    auto slot = std::move(slotIt->second);
+    _scopedCoroutines.erase(slotIt);
 }
 
 Ichor::AsyncGenerator<void> Ichor::DependencyManager::waitForService(uint64_t serviceId, uint64_t eventType) noexcept {
@@ -1016,8 +1629,9 @@ void Ichor::DependencyManager::handleEventCompletion(Ichor::Event const &evt) {
 
 uint64_t Ichor::DependencyManager::broadcastEvent(std::shared_ptr<Event> &evt) {
     auto registeredListeners = _eventCallbacks.find(evt->type);
+    auto targetedListeners = _targetedEventCallbacks.find(CallbackKey{evt->originatingService, evt->type});
 
-    if(registeredListeners == end(_eventCallbacks)) {
+    if(registeredListeners == end(_eventCallbacks) && targetedListeners == end(_targetedEventCallbacks)) {
         handleEventCompletion(*evt);
         return 0;
     }
@@ -1025,7 +1639,20 @@ uint64_t Ichor::DependencyManager::broadcastEvent(std::shared_ptr<Event> &evt) {
     auto waitingIt = _eventWaiters.find(evt->id);
 
     // Make copy because the vector can be modified in the callback() call.
-    std::vector<EventCallbackInfo> callbacksCopy = registeredListeners->second;
+    // Handlers targeting the originating service are looked up directly instead of filtering all handlers of this event type.
+    // Both lists are in registration order, merging them keeps handlers in the order they were registered in.
+    std::vector<EventCallbackInfo> callbacksCopy{};
+    if(targetedListeners == end(_targetedEventCallbacks)) {
+        callbacksCopy = registeredListeners->second;
+    } else if(registeredListeners == end(_eventCallbacks)) {
+        callbacksCopy = targetedListeners->second;
+    } else {
+        callbacksCopy.reserve(targetedListeners->second.size() + registeredListeners->second.size());
+        std::merge(targetedListeners->second.begin(), targetedListeners->second.end(), registeredListeners->second.begin(), registeredListeners->second.end(),
+                   std::back_inserter(callbacksCopy), [](EventCallbackInfo const &a, EventCallbackInfo const &b) {
+            return a.registrationSequence < b.registrationSequence;
+        });
+    }
 
     for(auto &callbackInfo : callbacksCopy) {
         auto service = _services.find(callbackInfo.listeningServiceId);
@@ -1033,7 +1660,11 @@ uint64_t Ichor::DependencyManager::broadcastEvent(std::shared_ptr<Event> &evt) {
             continue;
         }
 
-        if(callbackInfo.filterServiceId.has_value() && *callbackInfo.filterServiceId != evt->originatingService) {
+        if(callbackInfo.syncCallback) {
+            if(!callbackInfo.syncCallback(*evt)) {
+                INTERNAL_DEBUG("broadcastEvent {}:{} stopped by handler of service {}", evt->id, evt->name, callbackInfo.listeningServiceId);
+                break;
+            }
             continue;
         }
 
@@ -1050,9 +1681,8 @@ uint64_t Ichor::DependencyManager::broadcastEvent(std::shared_ptr<Event> &evt) {
                         std::terminate();
                     }
                 }
-                INTERNAL_DEBUG("contains3 {} {} {}", it.get_promise_id(), _scopedGenerators.contains(it.get_promise_id()), _scopedGenerators.size() + 1);
-                _scopedGenerators.emplace(it.get_promise_id(), std::make_unique<AsyncGenerator<IchorBehaviour>>(std::move(gen)));
-                _scopedEvents.emplace(it.get_promise_id(), evt);
+                INTERNAL_DEBUG("contains3 {} {} {}", it.get_promise_id(), _scopedCoroutines.contains(it.get_promise_id()), _scopedCoroutines.size() + 1);
+                addScopedCoroutine(it.get_promise_id(), std::make_unique<AsyncGenerator<IchorBehaviour>>(std::move(gen)), evt);
                 if(waitingIt != end(_eventWaiters)) {
                     waitingIt->second.count++;
                     INTERNAL_DEBUG("broadcastEvent {}:{} {} waiting {} {}", evt->id, evt->name, evt->originatingService, waitingIt->second.count, waitingIt->second.events.size());
@@ -1060,7 +1690,7 @@ uint64_t Ichor::DependencyManager::broadcastEvent(std::shared_ptr<Event> &evt) {
             }
 
             if(!it.get_finished() && it.get_promise_state() != state::value_not_ready_consumer_active) {
-                _eventQueue->pushPrioritisedEvent<ContinuableEvent>(evt->originatingService, evt->priority, it.get_promise_id());
+                scheduleContinuation(it.get_promise_id(), evt->originatingService, evt->priority);
             }
 
             if constexpr (DO_INTERNAL_DEBUG) {
@@ -1081,7 +1711,7 @@ void Ichor::DependencyManager::runForOrQueueEmpty(std::chrono::milliseconds ms)
     auto start = now;
     auto end = now + ms;
     while (now < end && !_eventQueue->shouldQuit()) {
-        if(now != start && _started.load(std::memory_order_acquire) && _eventQueue->empty() && _scopedGenerators.empty()) {
+        if(now != start && _started.load(std::memory_order_acquire) && _eventQueue->empty() && _scopedCoroutines.empty()) {
             return;
         }
         // value of 1ms may lead to races depending on processor speed
@@ -1090,6 +1720,152 @@ void Ichor::DependencyManager::runForOrQueueEmpty(std::chrono::milliseconds ms)
     }
 }
 
+Ichor::DependencyGraphSnapshot Ichor::DependencyManager::createDependencyGraphSnapshot() const {
+    if constexpr (DO_INTERNAL_DEBUG || DO_HARDENING) {
+        if (this != Detail::_local_dm) [[unlikely]] { // are we on the right thread?
+            std::terminate();
+        }
+    }
+
+    // in order of insertion, which follows the order of creation
+    auto const managers = _services.inInsertionOrder();
+
+    DependencyGraphSnapshot snapshot{};
+    unordered_map<uint64_t, uint32_t> indices{};
+    snapshot.services.reserve(managers.size());
+    for(auto *mgr : managers) {
+        indices.emplace(mgr->serviceId(), static_cast<uint32_t>(snapshot.services.size()));
+        snapshot.services.push_back(DependencyGraphSnapshot::Service{std::string{mgr->implementationName()}, mgr->getServiceState() == ServiceState::ACTIVE, mgr->getProperties().contains(Detail::filterPropertyKey)});
+    }
+
+    for(auto *dependent : managers) {
+        auto const *registry = dependent->getDependencyRegistry();
+        if(registry == nullptr || dependent->getServiceState() != ServiceState::ACTIVE) {
+            continue;
+        }
+
+        for(auto providerId : dependent->getDependencies()) {
+            auto providerIt = _services.find(providerId);
+            if(providerId == dependent->serviceId() || providerIt == _services.end()) {
+                continue;
+            }
+
+            for(auto const &intf : providerIt->second->getInterfaces()) {
+                if(registry->contains(intf.interfaceNameHash)) {
+                    snapshot.edges.push_back(DependencyGraphSnapshot::Edge{indices[providerId], indices[dependent->serviceId()], intf.interfaceNameHash});
+                }
+            }
+        }
+    }
+
+    // Kahn's algorithm over the active services, ties are broken by creation order
+    std::vector<uint32_t> inDegree(snapshot.services.size(), 0);
+    std::vector<bool> done(snapshot.services.size(), false);
+    for(auto const &edge : snapshot.edges) {
+        if(snapshot.services[edge.provider].active) {
+            inDegree[edge.dependent]++;
+        }
+    }
+
+    bool progress = true;
+    while(progress) {
+        progress = false;
+        for(uint32_t i = 0; i < snapshot.services.size(); i++) {
+            if(done[i] || !snapshot.services[i].active || inDegree[i] != 0) {
+                continue;
+            }
+
+            done[i] = true;
+            progress = true;
+            snapshot.startOrder.push_back(i);
+
+            for(auto const &edge : snapshot.edges) {
+                if(edge.provider == i) {
+                    inDegree[edge.dependent]--;
+                }
+            }
+        }
+    }
+
+    return snapshot;
+}
+
+void Ichor::DependencyManager::replayDependencyGraphSnapshot(DependencyGraphSnapshot snapshot) {
+#ifdef ICHOR_USE_HARDENING
+    if(_started.load(std::memory_order_acquire) && this != Detail::_local_dm) [[unlikely]] { // are we on the right thread?
+        std::terminate();
+    }
+#endif
+
+    // below INTERNAL_DEPENDENCY_EVENT_PRIORITY, so that the replay happens before the regular StartServiceEvents of the services
+    _eventQueue->pushPrioritisedEvent<ReplayDependencyGraphEvent>(0, INTERNAL_DEPENDENCY_EVENT_PRIORITY - 1, std::move(snapshot));
+}
+
+std::optional<std::vector<Ichor::StartServiceGraphEvent::Node>> Ichor::DependencyManager::matchDependencyGraphSnapshot(DependencyGraphSnapshot const &snapshot) const {
+    // ids per name in order of insertion, the same order createDependencyGraphSnapshot() uses
+    unordered_map<std::string_view, std::vector<uint64_t>> idsByName{};
+    for(auto const *mgr : _services.inInsertionOrder()) {
+        idsByName[mgr->implementationName()].push_back(mgr->serviceId());
+    }
+
+    // map every snapshot service onto the current service with the same name and position among services with that name
+    std::vector<uint64_t> ids{};
+    ids.reserve(snapshot.services.size());
+    unordered_map<std::string_view, size_t> seen{};
+    for(auto const &svc : snapshot.services) {
+        auto nameIt = idsByName.find(svc.implementationName);
+        auto &occurrence = seen[svc.implementationName];
+        if(nameIt == idsByName.end() || occurrence >= nameIt->second.size()) {
+            ICHOR_LOG_INFO(_logger, "Dependency graph snapshot mismatch, {} not created, resolving dependencies normally", svc.implementationName);
+            return {};
+        }
+
+        auto const svcId = nameIt->second[occurrence++];
+        if(_services.find(svcId)->second->getProperties().contains(Detail::filterPropertyKey) != svc.hasFilter) {
+            ICHOR_LOG_INFO(_logger, "Dependency graph snapshot mismatch, filter of {} changed, resolving dependencies normally", svc.implementationName);
+            return {};
+        }
+        ids.push_back(svcId);
+    }
+
+    if(ids.size() != _services.size()) {
+        ICHOR_LOG_INFO(_logger, "Dependency graph snapshot mismatch, {} services in snapshot, {} created, resolving dependencies normally", ids.size(), _services.size());
+        return {};
+    }
+
+    for(auto const &edge : snapshot.edges) {
+        auto const &provider = _services.find(ids[edge.provider])->second;
+        auto const &dependent = _services.find(ids[edge.dependent])->second;
+        auto const &interfaces = provider->getInterfaces();
+        auto const *registry = dependent->getDependencyRegistry();
+
+        if(registry == nullptr || !registry->contains(edge.interfaceHash) ||
+           std::find_if(interfaces.begin(), interfaces.end(), [&edge](Dependency const &dep) { return dep.interfaceNameHash == edge.interfaceHash; }) == interfaces.end()) {
+            ICHOR_LOG_INFO(_logger, "Dependency graph snapshot mismatch, interfaces of {} or {} changed, resolving dependencies normally", provider->implementationName(), dependent->implementationName());
+            return {};
+        }
+    }
+
+    std::vector<StartServiceGraphEvent::Node> nodes{};
+    nodes.reserve(snapshot.startOrder.size());
+    for(auto idx : snapshot.startOrder) {
+        auto const svcId = ids[idx];
+        // already running services and lazy services are left to normal resolution, but can still be injected as provider
+        if(_services.find(svcId)->second->getServiceState() != ServiceState::INSTALLED || _lazyServices.contains(svcId)) {
+            continue;
+        }
+
+        auto &node = nodes.emplace_back(StartServiceGraphEvent::Node{svcId, {}});
+        for(auto const &edge : snapshot.edges) {
+            if(edge.dependent == idx) {
+                node.providers.push_back(ids[edge.provider]);
+            }
+        }
+    }
+
+    return nodes;
+}
+
 Ichor::unordered_map<uint64_t, Ichor::IService const *> Ichor::DependencyManager::getServiceInfo() const noexcept {
     if constexpr (DO_INTERNAL_DEBUG || DO_HARDENING) {
         if (this != Detail::_local_dm) [[unlikely]] { // are we on the right thread?
@@ -1124,6 +1900,29 @@ Ichor::IEventQueue& Ichor::DependencyManager::getEventQueue() const noexcept {
     return *_eventQueue;
 }
 
+Ichor::CancellationToken Ichor::DependencyManager::getServiceStopToken(uint64_t serviceId) {
+#ifdef ICHOR_USE_HARDENING
+    if(this != Detail::_local_dm) [[unlikely]] { // are we on the right thread?
+        std::terminate();
+    }
+#endif
+
+    auto [sourceIt, inserted] = _serviceStopSources.try_emplace(serviceId);
+
+    // a cancelled source belongs to a previous stop of a service that has been started again since
+    if(!inserted && sourceIt->second.isCancellationRequested()) {
+        auto svcIt = _services.find(serviceId);
+        if(svcIt != _services.end()) {
+            auto const state = svcIt->second->getServiceState();
+            if(state == ServiceState::INJECTING || state == ServiceState::STARTING || state == ServiceState::ACTIVE) {
+                sourceIt->second = CancellationSource{};
+            }
+        }
+    }
+
+    return sourceIt->second.getToken();
+}
+
 void Ichor::DependencyManager::setCommunicationChannel(Ichor::CommunicationChannel *channel) {
     _communicationChannel = channel;
 }
@@ -0,0 +1,215 @@
+#include <ichor/Properties.h>
+#include <ichor/stl/RealtimeReadWriteMutex.h>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+namespace {
+    struct InternedKeys final {
+        Ichor::RealtimeReadWriteMutex mutex{};
+        // deque never moves its elements, so string_views into the stored names stay valid
+        std::deque<std::string> names{};
+        std::unordered_map<std::string_view, uint32_t> ids{};
+    };
+
+    InternedKeys& internedKeys() {
+        static InternedKeys keys{};
+        return keys;
+    }
+
+    using EntryIt = std::vector<Ichor::Detail::PropertyEntry>::const_iterator;
+
+    EntryIt lowerBound(std::vector<Ichor::Detail::PropertyEntry> const &entries, uint32_t id) noexcept {
+        return std::lower_bound(entries.begin(), entries.end(), id, [](Ichor::Detail::PropertyEntry const &entry, uint32_t val) {
+            return entry.first.id() < val;
+        });
+    }
+
+    EntryIt findById(std::vector<Ichor::Detail::PropertyEntry> const &entries, uint32_t id) noexcept {
+        auto it = lowerBound(entries, id);
+        if(it != entries.end() && it->first.id() == id) {
+            return it;
+        }
+        return entries.end();
+    }
+}
+
+Ichor::PropertyKey::PropertyKey(std::string_view name) {
+    auto &keys = internedKeys();
+    {
+        std::shared_lock lg{keys.mutex};
+        auto it = keys.ids.find(name);
+        if(it != keys.ids.end()) {
+            _name = it->first;
+            _id = it->second;
+            return;
+        }
+    }
+
+    std::unique_lock lg{keys.mutex};
+    // interned by another thread in between releasing the shared lock and acquiring this one
+    auto it = keys.ids.find(name);
+    if(it == keys.ids.end()) {
+        auto &storedName = keys.names.emplace_back(name);
+        it = keys.ids.emplace(storedName, static_cast<uint32_t>(keys.names.size())).first;
+    }
+
+    _name = it->first;
+    _id = it->second;
+}
+
+std::optional<Ichor::PropertyKey> Ichor::PropertyKey::findInterned(std::string_view name) {
+    auto &keys = internedKeys();
+    std::shared_lock lg{keys.mutex};
+    auto it = keys.ids.find(name);
+    if(it == keys.ids.end()) {
+        return {};
+    }
+
+    return PropertyKey{it->first, it->second};
+}
+
+void Ichor::Detail::PropertiesIterator::skipShadowed() noexcept {
+    auto const ownSize = _node->entries.size();
+    if(_node->base == nullptr) {
+        return;
+    }
+
+    auto const &baseEntries = _node->base->entries;
+    while(_idx >= ownSize && _idx - ownSize < baseEntries.size() && findById(_node->entries, baseEntries[_idx - ownSize].first.id()) != _node->entries.end()) {
+        ++_idx;
+    }
+}
+
+Ichor::Properties::Properties(std::initializer_list<std::pair<std::string_view, Ichor::any>> entries) {
+    for(auto const &[key, value] : entries) {
+        emplace(key, value);
+    }
+}
+
+Ichor::Properties::const_iterator Ichor::Properties::find(PropertyKey const &key) const noexcept {
+    if(_node == nullptr) {
+        return end();
+    }
+
+    auto &own = _node->entries;
+    auto it = findById(own, key.id());
+    if(it != own.end()) {
+        return const_iterator{_node.get(), static_cast<size_t>(it - own.begin())};
+    }
+
+    if(_node->base != nullptr) {
+        auto &baseEntries = _node->base->entries;
+        it = findById(baseEntries, key.id());
+        if(it != baseEntries.end()) {
+            return const_iterator{_node.get(), own.size() + static_cast<size_t>(it - baseEntries.begin())};
+        }
+    }
+
+    return end();
+}
+
+Ichor::Properties::const_iterator Ichor::Properties::find(std::string_view key) const noexcept {
+    if(_node == nullptr) {
+        return end();
+    }
+
+    // a name that was never interned cannot be in any set
+    auto const interned = PropertyKey::findInterned(key);
+    if(!interned) {
+        return end();
+    }
+
+    return find(*interned);
+}
+
+Ichor::Properties::size_type Ichor::Properties::size() const noexcept {
+    if(_node == nullptr) {
+        return 0;
+    }
+
+    if(_node->base == nullptr) {
+        return _node->entries.size();
+    }
+
+    return static_cast<size_type>(std::distance(begin(), end()));
+}
+
+Ichor::any& Ichor::Properties::operator[](std::string_view key) {
+    return insertEntry(PropertyKey{key}).first->second;
+}
+
+Ichor::any& Ichor::Properties::operator[](PropertyKey const &key) {
+    return insertEntry(key).first->second;
+}
+
+Ichor::Properties::size_type Ichor::Properties::erase(std::string_view key) {
+    auto const interned = PropertyKey::findInterned(key);
+    if(!interned || !contains(*interned)) {
+        return 0;
+    }
+
+    auto &entries = detach();
+    entries.erase(findById(entries, interned->id()));
+    return 1;
+}
+
+Ichor::Properties Ichor::Properties::with(PropertyKey const &key, Ichor::any value) const {
+    Properties ret{};
+    ret._node = std::make_shared<Detail::PropertiesNode>();
+
+    if(_node != nullptr) {
+        if(_node->base == nullptr) {
+            ret._node->base = _node;
+        } else {
+            // keep the chain one level deep: share the base, copy the (few) entries added on top of it
+            ret._node->base = _node->base;
+            ret._node->entries = _node->entries;
+        }
+    }
+
+    auto &entries = ret._node->entries;
+    auto it = entries.begin() + (lowerBound(entries, key.id()) - entries.cbegin());
+    if(it != entries.end() && it->first == key) {
+        it->second = std::move(value);
+    } else {
+        entries.emplace(it, key, std::move(value));
+    }
+
+    return ret;
+}
+
+std::vector<Ichor::Detail::PropertyEntry>& Ichor::Properties::detach() {
+    if(_node == nullptr) {
+        _node = std::make_shared<Detail::PropertiesNode>();
+        return _node->entries;
+    }
+
+    if(_node->base == nullptr && _node.use_count() == 1) {
+        return _node->entries;
+    }
+
+    auto flat = std::make_shared<Detail::PropertiesNode>();
+    flat->entries.reserve(totalEntries());
+    for(auto const &entry : *this) {
+        flat->entries.push_back(entry);
+    }
+    std::sort(flat->entries.begin(), flat->entries.end(), [](Detail::PropertyEntry const &a, Detail::PropertyEntry const &b) {
+        return a.first.id() < b.first.id();
+    });
+    _node = std::move(flat);
+    return _node->entries;
+}
+
+std::pair<Ichor::Detail::PropertyEntry*, bool> Ichor::Properties::insertEntry(PropertyKey key) {
+    auto &entries = detach();
+    auto it = entries.begin() + (lowerBound(entries, key.id()) - entries.cbegin());
+    if(it != entries.end() && it->first == key) {
+        return {&*it, false};
+    }
+
+    it = entries.emplace(it, key, Ichor::any{});
+    return {&*it, true};
+}
@@ -1,3 +1,53 @@
 #include <ichor/dependency_management/AdvancedService.h>
+#include <ichor/stl/RealtimeMutex.h>
+#include <atomic>
+#include <limits>
+#include <mutex>
+#include <vector>
 
-std::atomic<uint64_t> Ichor::Detail::_serviceIdCounter = 1;
+namespace {
+    struct ServiceIdPool final {
+        std::atomic<uint64_t> nextSlot{1}; // slot 0 is never used, so that no service has id 0
+        std::atomic<size_t> releasedCount{}; // lets reserveServiceId() skip the mutex while there is nothing to reuse
+        Ichor::RealtimeMutex mutex{};
+        std::vector<uint64_t> released{}; // ids of destroyed services, their slots are reused with the next generation
+    };
+
+    // Never destroyed, services in static storage may be destroyed after this translation unit's statics.
+    ServiceIdPool &serviceIdPool() noexcept {
+        static ServiceIdPool &pool = *new ServiceIdPool{};
+        return pool;
+    }
+}
+
+uint64_t Ichor::Detail::reserveServiceId() noexcept {
+    auto &pool = serviceIdPool();
+
+    if(pool.releasedCount.load(std::memory_order_acquire) != 0) {
+        std::unique_lock lg{pool.mutex};
+        if(!pool.released.empty()) {
+            auto const id = pool.released.back();
+            pool.released.pop_back();
+            pool.releasedCount.store(pool.released.size(), std::memory_order_release);
+            return (static_cast<uint64_t>(serviceIdGeneration(id) + 1u) << 32u) | serviceIdSlot(id);
+        }
+    }
+
+    auto const slot = pool.nextSlot.fetch_add(1, std::memory_order_relaxed);
+    if(slot > std::numeric_limits<uint32_t>::max()) [[unlikely]] {
+        std::terminate();
+    }
+    return slot;
+}
+
+void Ichor::Detail::releaseServiceId(uint64_t id) noexcept {
+    // a slot that went through all generations is retired
+    if(id == 0 || serviceIdGeneration(id) == std::numeric_limits<uint32_t>::max()) {
+        return;
+    }
+
+    auto &pool = serviceIdPool();
+    std::unique_lock lg{pool.mutex};
+    pool.released.push_back(id);
+    pool.releasedCount.store(pool.released.size(), std::memory_order_release);
+}
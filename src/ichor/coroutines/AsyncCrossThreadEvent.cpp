@@ -0,0 +1,81 @@
+#include <ichor/coroutines/AsyncCrossThreadEvent.h>
+#include <ichor/DependencyManager.h>
+#include <cassert>
+
+Ichor::AsyncCrossThreadEvent::AsyncCrossThreadEvent(uint64_t priority, bool initiallySet) noexcept
+        : _state(initiallySet ? static_cast<void*>(this) : nullptr), _priority(priority)
+{}
+
+Ichor::AsyncCrossThreadEvent::~AsyncCrossThreadEvent() {
+    // There should be no coroutines still awaiting the event.
+    assert(
+            _state.load(std::memory_order_relaxed) == nullptr ||
+            _state.load(std::memory_order_relaxed) == static_cast<void*>(this));
+}
+
+bool Ichor::AsyncCrossThreadEvent::is_set() const noexcept {
+    return _state.load(std::memory_order_acquire) == static_cast<const void*>(this);
+}
+
+Ichor::AsyncCrossThreadEventOperation Ichor::AsyncCrossThreadEvent::operator co_await() const noexcept {
+    return AsyncCrossThreadEventOperation{ *this };
+}
+
+void Ichor::AsyncCrossThreadEvent::set() noexcept {
+    set(_priority);
+}
+
+void Ichor::AsyncCrossThreadEvent::set(uint64_t priority) noexcept {
+    void* const setState = static_cast<void*>(this);
+
+    // Needs 'release' semantics so that prior writes are visible to event awaiters
+    // that synchronise either via 'is_set()' or 'operator co_await()'.
+    // Needs 'acquire' semantics in case there are any waiters so that we see
+    // prior writes to the waiting coroutine's state and to the contents of
+    // the queued AsyncCrossThreadEventOperation objects.
+    void* oldState = _state.exchange(setState, std::memory_order_acq_rel);
+    if (oldState != setState) {
+        auto* current = static_cast<AsyncCrossThreadEventOperation*>(oldState);
+        while (current != nullptr) {
+            // current may be resumed and destroyed on another thread as soon as it is handed over
+            auto* next = current->_next;
+            current->_resumption.priority = priority;
+            Detail::resumeOn(current->_dm, current->_resumption);
+            current = next;
+        }
+    }
+}
+
+void Ichor::AsyncCrossThreadEvent::reset() noexcept {
+    void* oldState = static_cast<void*>(this);
+    _state.compare_exchange_strong(oldState, nullptr, std::memory_order_relaxed);
+}
+
+Ichor::AsyncCrossThreadEventOperation::AsyncCrossThreadEventOperation(const AsyncCrossThreadEvent& event) noexcept
+        : _event(event)
+{
+}
+
+bool Ichor::AsyncCrossThreadEventOperation::await_ready() const noexcept {
+    return _event.is_set();
+}
+
+bool Ichor::AsyncCrossThreadEventOperation::await_suspend(std::coroutine_handle<> awaiter) noexcept {
+    _dm = Detail::_local_dm;
+    _resumption.awaiter = awaiter;
+
+    const void* const setState = static_cast<const void*>(&_event);
+
+    void* oldState = _event._state.load(std::memory_order_acquire);
+    do {
+        if (oldState == setState) {
+            // State is now 'set' no need to suspend.
+            return false;
+        }
+
+        _next = static_cast<AsyncCrossThreadEventOperation*>(oldState);
+    } while(!_event._state.compare_exchange_weak(oldState, static_cast<void*>(this), std::memory_order_release, std::memory_order_acquire));
+
+    // Successfully queued this waiter to the list.
+    return true;
+}
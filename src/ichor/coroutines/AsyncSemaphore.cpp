@@ -0,0 +1,84 @@
+#include <ichor/coroutines/AsyncSemaphore.h>
+#include <ichor/DependencyManager.h>
+#include <cassert>
+#include <mutex>
+
+void Ichor::Detail::SingleThreadLock::lock() noexcept {
+#ifdef ICHOR_USE_HARDENING
+    // check if currently on a different thread than the first use (which would be a data race)
+    if(_dm == nullptr) {
+        _dm = _local_dm;
+    } else if(_dm != _local_dm) [[unlikely]] {
+        std::terminate();
+    }
+#endif
+}
+
+template <typename Lock>
+Ichor::BasicAsyncSemaphore<Lock>::BasicAsyncSemaphore(uint64_t permits, uint64_t priority) noexcept : _permits(permits), _priority(priority) {
+}
+
+template <typename Lock>
+Ichor::BasicAsyncSemaphore<Lock>::~BasicAsyncSemaphore() {
+    // There should be no coroutines still waiting for a permit.
+    assert(_waiters.empty());
+}
+
+template <typename Lock>
+Ichor::BasicAsyncSemaphoreOperation<Lock> Ichor::BasicAsyncSemaphore<Lock>::acquire() noexcept {
+    return BasicAsyncSemaphoreOperation<Lock>{*this};
+}
+
+template <typename Lock>
+bool Ichor::BasicAsyncSemaphore<Lock>::tryAcquire() noexcept {
+    std::unique_lock const lg{_lock};
+    if(_permits == 0 || !_waiters.empty()) {
+        return false;
+    }
+    _permits--;
+    return true;
+}
+
+template <typename Lock>
+void Ichor::BasicAsyncSemaphore<Lock>::release(uint64_t count) noexcept {
+    Detail::AsyncWaiterQueue resumable{};
+    uint64_t priority;
+    {
+        std::unique_lock const lg{_lock};
+        _permits += count;
+        while(_permits > 0 && !_waiters.empty()) {
+            _permits--;
+            resumable.push(_waiters.pop());
+        }
+        priority = _priority;
+    }
+
+    // resumed coroutines may destroy the semaphore
+    resumable.resumeAll(priority);
+}
+
+template <typename Lock>
+uint64_t Ichor::BasicAsyncSemaphore<Lock>::available() const noexcept {
+    std::unique_lock const lg{_lock};
+    return _waiters.empty() ? _permits : 0;
+}
+
+template <typename Lock>
+bool Ichor::BasicAsyncSemaphoreOperation<Lock>::await_suspend(std::coroutine_handle<> awaiter) noexcept {
+    std::unique_lock const lg{_semaphore._lock};
+    if(_semaphore._permits > 0 && _semaphore._waiters.empty()) {
+        _semaphore._permits--;
+        return false;
+    }
+
+    _waiter.resumption.awaiter = awaiter;
+    _waiter.dm = Detail::_local_dm;
+    _waiter.count = 1;
+    _semaphore._waiters.push(_waiter);
+    return true;
+}
+
+template class Ichor::BasicAsyncSemaphore<Ichor::Detail::SingleThreadLock>;
+template class Ichor::BasicAsyncSemaphore<Ichor::RealtimeMutex>;
+template class Ichor::BasicAsyncSemaphoreOperation<Ichor::Detail::SingleThreadLock>;
+template class Ichor::BasicAsyncSemaphoreOperation<Ichor::RealtimeMutex>;
@@ -0,0 +1,91 @@
+#include <ichor/coroutines/CancellationToken.h>
+#include <algorithm>
+#include <atomic>
+#include <utility>
+#include <vector>
+
+namespace Ichor::Detail {
+    struct CancellationState final {
+        std::atomic<bool> requested{};
+        bool invoking{}; // callbacks are being run, deregistering only clears the callback to keep the vector stable
+        uint64_t registrationIdCounter{};
+        std::vector<std::pair<uint64_t, std::function<void()>>> callbacks{}; // key = registration id
+    };
+}
+
+Ichor::CancellationToken::CancellationToken(std::shared_ptr<Detail::CancellationState> state) noexcept : _state(std::move(state)) {
+}
+
+bool Ichor::CancellationToken::isCancellationRequested() const noexcept {
+    return _state != nullptr && _state->requested.load(std::memory_order_acquire);
+}
+
+bool Ichor::CancellationToken::canBeCancelled() const noexcept {
+    return _state != nullptr;
+}
+
+Ichor::CancellationSource::CancellationSource() : _state(std::make_shared<Detail::CancellationState>()) {
+}
+
+Ichor::CancellationToken Ichor::CancellationSource::getToken() const noexcept {
+    return CancellationToken{_state};
+}
+
+void Ichor::CancellationSource::requestCancellation() {
+    if(_state->requested.exchange(true, std::memory_order_acq_rel)) {
+        return;
+    }
+
+    // keep the state alive, callbacks may destroy the last token and registration referring to it
+    auto state = _state;
+    state->invoking = true;
+    for(std::size_t i = 0; i < state->callbacks.size(); i++) {
+        if(!state->callbacks[i].second) {
+            continue;
+        }
+        auto callback = std::move(state->callbacks[i].second);
+        state->callbacks[i].second = {};
+        callback();
+    }
+    state->invoking = false;
+    state->callbacks.clear();
+}
+
+bool Ichor::CancellationSource::isCancellationRequested() const noexcept {
+    return _state->requested.load(std::memory_order_acquire);
+}
+
+Ichor::CancellationRegistration::CancellationRegistration(CancellationToken const &token, std::function<void()> callback) {
+    if(token._state == nullptr) {
+        return;
+    }
+
+    if(token._state->requested.load(std::memory_order_acquire)) {
+        callback();
+        return;
+    }
+
+    _state = token._state;
+    _id = ++_state->registrationIdCounter;
+    _state->callbacks.emplace_back(_id, std::move(callback));
+}
+
+Ichor::CancellationRegistration::~CancellationRegistration() {
+    if(_state == nullptr) {
+        return;
+    }
+
+    auto it = std::find_if(_state->callbacks.begin(), _state->callbacks.end(), [this](auto const &entry) {
+        return entry.first == _id;
+    });
+
+    if(it == _state->callbacks.end()) {
+        return;
+    }
+
+    if(_state->invoking) {
+        it->second = {};
+    } else {
+        _state->callbacks.erase(it);
+    }
+}
@@ -0,0 +1,180 @@
+#include <ichor/coroutines/CoroutineFramePool.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <new>
+
+namespace {
+    constexpr std::size_t bucketGranularity = 64;
+    constexpr std::size_t bucketCount = 16; // frames up to 1 KiB, including header
+    constexpr uint32_t maxCachedPerBucket = 256;
+
+    struct FramePool;
+
+    // Prepended to every frame. Keeps the frame aligned to __STDCPP_DEFAULT_NEW_ALIGNMENT__, which is what the compiler expects from operator new.
+    struct alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) FrameHeader final {
+        FramePool *pool; // nullptr if allocated directly from the global allocator
+        FrameHeader *next; // free list link while cached
+        std::size_t bucket;
+    };
+
+    struct FramePool final {
+        std::array<FrameHeader*, bucketCount> buckets{};
+        std::array<uint32_t, bucketCount> cachedPerBucket{};
+        std::atomic<FrameHeader*> remoteFrees{}; // frames freed by other threads, drained by the owning thread
+        std::atomic<uint32_t> remoteFreesInProgress{};
+        std::atomic<bool> orphaned{}; // owning thread has exited, frames freed afterwards go directly to the global allocator
+        Ichor::CoroutineFramePoolStats stats{};
+    };
+
+    thread_local FramePool *localPool{};
+    thread_local bool localPoolDestroyed{};
+
+    void cacheFrame(FramePool &pool, FrameHeader *header) noexcept {
+        if(pool.cachedPerBucket[header->bucket] >= maxCachedPerBucket) {
+            ::operator delete(header);
+            return;
+        }
+
+        header->next = pool.buckets[header->bucket];
+        pool.buckets[header->bucket] = header;
+        pool.cachedPerBucket[header->bucket]++;
+        pool.stats.cachedBytes += (header->bucket + 1) * bucketGranularity;
+        pool.stats.highWaterCachedBytes = std::max(pool.stats.highWaterCachedBytes, pool.stats.cachedBytes);
+    }
+
+    void drainRemoteFrees(FramePool &pool) noexcept {
+        auto *header = pool.remoteFrees.exchange(nullptr, std::memory_order_acquire);
+        while(header != nullptr) {
+            auto *next = header->next;
+            pool.stats.outstandingFrames--;
+            pool.stats.remoteFrees++;
+            cacheFrame(pool, header);
+            header = next;
+        }
+    }
+
+    void releaseCachedFrames(FramePool &pool) noexcept {
+        for(std::size_t bucket = 0; bucket < bucketCount; bucket++) {
+            auto *header = pool.buckets[bucket];
+            while(header != nullptr) {
+                auto *next = header->next;
+                ::operator delete(header);
+                header = next;
+            }
+            pool.buckets[bucket] = nullptr;
+            pool.cachedPerBucket[bucket] = 0;
+        }
+        pool.stats.cachedBytes = 0;
+    }
+
+    struct FramePoolOwner final {
+        ~FramePoolOwner() {
+            if(localPool == nullptr) {
+                return;
+            }
+
+            // From here on, other threads free our frames directly. Wait for the ones that did not see the flag yet.
+            localPool->orphaned.store(true, std::memory_order_seq_cst);
+            while(localPool->remoteFreesInProgress.load(std::memory_order_seq_cst) != 0) {
+            }
+            drainRemoteFrees(*localPool);
+            releaseCachedFrames(*localPool);
+
+            // Frames still in use point to the pool, so it has to outlive them. Those are leaked coroutines anyway.
+            if(localPool->stats.outstandingFrames == 0) {
+                delete localPool;
+            }
+            localPool = nullptr;
+            localPoolDestroyed = true;
+        }
+    };
+
+    thread_local FramePoolOwner localPoolOwner{};
+
+    FramePool* getLocalPool() {
+        if(localPool == nullptr && !localPoolDestroyed) {
+            localPool = new FramePool();
+            // odr-use to ensure the owner gets constructed and therefore destructed on thread exit
+            static_cast<void>(&localPoolOwner);
+        }
+        return localPool;
+    }
+}
+
+void* Ichor::Detail::allocateCoroutineFrame(std::size_t size) {
+    auto const total = size + sizeof(FrameHeader);
+    auto const bucket = (total - 1) / bucketGranularity;
+    auto *pool = getLocalPool();
+
+    if(pool == nullptr || bucket >= bucketCount) {
+        auto *header = static_cast<FrameHeader*>(::operator new(total));
+        header->pool = nullptr;
+        if(pool != nullptr) {
+            pool->stats.allocations++;
+        }
+        return header + 1;
+    }
+
+    pool->stats.allocations++;
+    pool->stats.outstandingFrames++;
+    pool->stats.highWaterFrames = std::max(pool->stats.highWaterFrames, pool->stats.outstandingFrames);
+
+    if(pool->buckets[bucket] == nullptr) {
+        drainRemoteFrees(*pool);
+    }
+
+    auto *header = pool->buckets[bucket];
+    if(header != nullptr) {
+        pool->buckets[bucket] = header->next;
+        pool->cachedPerBucket[bucket]--;
+        pool->stats.cachedBytes -= (bucket + 1) * bucketGranularity;
+        pool->stats.hits++;
+    } else {
+        header = static_cast<FrameHeader*>(::operator new((bucket + 1) * bucketGranularity));
+        header->pool = pool;
+        header->bucket = bucket;
+    }
+
+    return header + 1;
+}
+
+void Ichor::Detail::freeCoroutineFrame(void *frame) noexcept {
+    if(frame == nullptr) {
+        return;
+    }
+
+    auto *header = static_cast<FrameHeader*>(frame) - 1;
+    auto *pool = header->pool;
+
+    if(pool == nullptr) {
+        ::operator delete(header);
+        return;
+    }
+
+    if(pool == localPool) {
+        pool->stats.outstandingFrames--;
+        cacheFrame(*pool, header);
+        return;
+    }
+
+    pool->remoteFreesInProgress.fetch_add(1, std::memory_order_seq_cst);
+    if(pool->orphaned.load(std::memory_order_seq_cst)) {
+        pool->remoteFreesInProgress.fetch_sub(1, std::memory_order_seq_cst);
+        ::operator delete(header);
+        return;
+    }
+
+    header->next = pool->remoteFrees.load(std::memory_order_relaxed);
+    while(!pool->remoteFrees.compare_exchange_weak(header->next, header, std::memory_order_release, std::memory_order_relaxed)) {
+    }
+    pool->remoteFreesInProgress.fetch_sub(1, std::memory_order_seq_cst);
+}
+
+Ichor::CoroutineFramePoolStats Ichor::Detail::getCoroutineFramePoolStats() noexcept {
+    if(localPool == nullptr) {
+        return {};
+    }
+
+    return localPool->stats;
+}
@@ -0,0 +1,104 @@
+#include <ichor/dependency_management/DependencyGraphSnapshot.h>
+#include <charconv>
+#include <fmt/format.h>
+
+namespace {
+    constexpr std::string_view snapshotHeader = "ichor-dependency-graph 1";
+
+    std::string_view nextToken(std::string_view &line) noexcept {
+        auto const start = line.find_first_not_of(' ');
+        if(start == std::string_view::npos) {
+            line = {};
+            return {};
+        }
+        line.remove_prefix(start);
+        auto const end = line.find(' ');
+        auto token = line.substr(0, end);
+        line.remove_prefix(end == std::string_view::npos ? line.size() : end + 1);
+        return token;
+    }
+
+    template <typename T>
+    bool parseNumber(std::string_view &line, T &out) noexcept {
+        auto token = nextToken(line);
+        auto [ptr, ec] = std::from_chars(token.data(), token.data() + token.size(), out);
+        return !token.empty() && ec == std::errc{} && ptr == token.data() + token.size();
+    }
+}
+
+std::string Ichor::DependencyGraphSnapshot::serialize() const {
+    fmt::memory_buffer out;
+    fmt::format_to(std::back_inserter(out), "{}\n", snapshotHeader);
+    for(auto const &svc : services) {
+        fmt::format_to(std::back_inserter(out), "service {} {} {}\n", svc.active ? 1 : 0, svc.hasFilter ? 1 : 0, svc.implementationName);
+    }
+    for(auto const &edge : edges) {
+        fmt::format_to(std::back_inserter(out), "edge {} {} {}\n", edge.provider, edge.dependent, edge.interfaceHash);
+    }
+    fmt::format_to(std::back_inserter(out), "start");
+    for(auto idx : startOrder) {
+        fmt::format_to(std::back_inserter(out), " {}", idx);
+    }
+    fmt::format_to(std::back_inserter(out), "\n");
+    return fmt::to_string(out);
+}
+
+std::optional<Ichor::DependencyGraphSnapshot> Ichor::DependencyGraphSnapshot::deserialize(std::string_view data) {
+    DependencyGraphSnapshot ret{};
+    bool headerSeen{};
+    bool startSeen{};
+
+    while(!data.empty()) {
+        auto const lineEnd = data.find('\n');
+        auto line = data.substr(0, lineEnd);
+        data.remove_prefix(lineEnd == std::string_view::npos ? data.size() : lineEnd + 1);
+
+        if(line.empty()) {
+            continue;
+        }
+
+        if(!headerSeen) {
+            if(line != snapshotHeader) {
+                return {};
+            }
+            headerSeen = true;
+            continue;
+        }
+
+        auto const kind = nextToken(line);
+        if(kind == "service") {
+            uint32_t active{};
+            uint32_t hasFilter{};
+            if(!parseNumber(line, active) || !parseNumber(line, hasFilter) || line.empty()) {
+                return {};
+            }
+            ret.services.push_back(Service{std::string{line}, active != 0, hasFilter != 0});
+        } else if(kind == "edge") {
+            Edge edge{};
+            if(!parseNumber(line, edge.provider) || !parseNumber(line, edge.dependent) || !parseNumber(line, edge.interfaceHash)) {
+                return {};
+            }
+            if(edge.provider >= ret.services.size() || edge.dependent >= ret.services.size()) {
+                return {};
+            }
+            ret.edges.push_back(edge);
+        } else if(kind == "start") {
+            while(!line.empty()) {
+                uint32_t idx{};
+                if(!parseNumber(line, idx) || idx >= ret.services.size()) {
+                    return {};
+                }
+                ret.startOrder.push_back(idx);
+            }
+            startSeen = true;
+        } else {
+            return {};
+        }
+    }
+
+    if(!headerSeen || !startSeen) {
+        return {};
+    }
+
+    return ret;
+}
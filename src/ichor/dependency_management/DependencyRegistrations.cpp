@@ -17,14 +17,14 @@ void Ichor::EventCompletionHandlerRegistration::reset() {
 
 Ichor::EventHandlerRegistration::~EventHandlerRegistration() {
     if(_key.type != 0) {
-        Ichor::GetThreadLocalEventQueue().pushPrioritisedEvent<RemoveEventHandlerEvent>(_key.id, _priority, _key);
+        Ichor::GetThreadLocalEventQueue().pushPrioritisedEvent<RemoveEventHandlerEvent>(_key.id, _priority, _key, _targetServiceId);
         _key.type = 0;
     }
 }
 
 void Ichor::EventHandlerRegistration::reset() {
     if(_key.type != 0) {
-        Ichor::GetThreadLocalEventQueue().pushPrioritisedEvent<RemoveEventHandlerEvent>(_key.id, _priority, _key);
+        Ichor::GetThreadLocalEventQueue().pushPrioritisedEvent<RemoveEventHandlerEvent>(_key.id, _priority, _key, _targetServiceId);
         _key.type = 0;
     }
 }
@@ -39,6 +39,14 @@ namespace Ichor {
         _dm->stop();
     }
 
+    std::optional<std::chrono::steady_clock::time_point> IEventQueue::nextTimerExpiry() const noexcept {
+        return _dm->nextTimerExpiry();
+    }
+
+    void IEventQueue::expireTimers() {
+        _dm->expireTimers();
+    }
+
     [[nodiscard]] IEventQueue& GetThreadLocalEventQueue() noexcept {
         return GetThreadLocalManager().getEventQueue();
     }
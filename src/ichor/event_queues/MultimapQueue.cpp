@@ -68,13 +68,21 @@ namespace Ichor {
         startDm();
 
         while(!shouldQuit()) [[likely]] {
+            // Expired timers push their events before an event is picked, so that they are ordered by priority with the queued events.
+            expireTimers();
+
             std::unique_lock l(_eventQueueMutex);
-            while(!shouldQuit() && _eventQueue.empty()) {
+            if(!shouldQuit() && _eventQueue.empty()) {
+                auto wakeup = std::chrono::steady_clock::now() + 500ms;
+                if(auto timerExpiry = nextTimerExpiry(); timerExpiry && *timerExpiry < wakeup) {
+                    wakeup = *timerExpiry;
+                }
+
                 // Spinlock 10ms before going to sleep, improves latency in high workload cases at the expense of CPU usage
                 if(_spinlock) {
                     l.unlock();
-                    auto start = std::chrono::steady_clock::now();
-                    while(std::chrono::steady_clock::now() < start + 10ms) {
+                    auto spinUntil = std::min(std::chrono::steady_clock::now() + 10ms, wakeup);
+                    while(std::chrono::steady_clock::now() < spinUntil) {
                         l.lock();
                         if(!_eventQueue.empty()) {
                             goto spinlockBreak;
@@ -84,7 +92,7 @@ namespace Ichor {
                     l.lock();
                 }
                 // Being woken up from another thread incurs a cost of ~0.4ms on my machine (see benchmarks/README.md for specs)
-                _wakeup.wait_for(l, 500ms, [this]() {
+                _wakeup.wait_until(l, wakeup, [this]() {
                     shouldAddQuitEvent();
                     return shouldQuit() || !_eventQueue.empty();
                 });
@@ -97,6 +105,11 @@ namespace Ichor {
                 break;
             }
 
+            // woken up for a timer or the periodic quit check
+            if(_eventQueue.empty()) {
+                continue;
+            }
+
             auto node = _eventQueue.extract(_eventQueue.begin());
             l.unlock();
             processEvent(std::move(node.mapped()));
@@ -27,6 +27,7 @@ namespace Ichor {
             sd_event_unref(_eventQueue);
             sd_event_source_unref(_eventfdSource);
             sd_event_source_unref(_timerSource);
+            sd_event_source_unref(_timerWheelSource);
         } else {
             close(_eventfd);
         }
@@ -80,6 +81,7 @@ namespace Ichor {
 
                 try {
                     e->queue->processEvent(std::move(e->event));
+                    e->queue->armTimerWheel();
                 } catch(const std::exception &ex) {
                     fmt::print("Encountered exception: \"{}\", quitting\n", ex.what());
                     e->queue->quit();
@@ -178,6 +180,7 @@ namespace Ichor {
         }
 
         startDm();
+        armTimerWheel();
     }
 
     bool SdeventQueue::shouldQuit() {
@@ -269,6 +272,32 @@ namespace Ichor {
         if (ret < 0) [[unlikely]] {
             throw std::system_error(-ret, std::generic_category(), "sd_event_add_io() failed");
         }
+
+        // expiry of the manager's timers, armed by armTimerWheel()
+        ret = sd_event_add_time(_eventQueue, &_timerWheelSource, CLOCK_MONOTONIC, std::numeric_limits<uint64_t>::max(), 0,
+                                  [](sd_event_source *, uint64_t, void *userdata) {
+                                      auto *q = reinterpret_cast<SdeventQueue*>(userdata);
+                                      q->expireTimers();
+                                      q->armTimerWheel();
+                                      return 0;
+                                  }, this);
+
+        if (ret < 0) [[unlikely]] {
+            throw std::system_error(-ret, std::generic_category(), "sd_event_add_time() failed");
+        }
+    }
+
+    void SdeventQueue::armTimerWheel() {
+        auto const expiry = nextTimerExpiry();
+        if(!expiry) {
+            sd_event_source_set_enabled(_timerWheelSource, SD_EVENT_OFF);
+            return;
+        }
+
+        // steady_clock is CLOCK_MONOTONIC, an expiry in the past fires on the next iteration of the loop
+        auto const usec = std::chrono::ceil<std::chrono::microseconds>(expiry->time_since_epoch()).count();
+        sd_event_source_set_time(_timerWheelSource, static_cast<uint64_t>(std::max(decltype(usec){1}, usec)));
+        sd_event_source_set_enabled(_timerWheelSource, SD_EVENT_ONESHOT);
     }
 }
 
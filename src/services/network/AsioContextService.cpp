@@ -2,7 +2,6 @@
 
 #include <ichor/DependencyManager.h>
 #include <ichor/services/network/AsioContextService.h>
-#include <ichor/events/RunFunctionEvent.h>
 #if (defined(WIN32) || defined(_WIN32) || defined(__WIN32)) && !defined(__CYGWIN__)
 #include <processthreadsapi.h>
 #include <fmt/xchar.h>
@@ -38,11 +37,9 @@ Ichor::Task<tl::expected<void, Ichor::StartError>> Ichor::AsioContextService::st
 
     ICHOR_LOG_INFO(_logger, "Using boost version {} beast version {}\n", BOOST_VERSION, BOOST_BEAST_VERSION);
 
-    net::spawn(*_context, [this, &queue = GetThreadLocalEventQueue()](net::yield_context yield) {
+    net::spawn(*_context, [this](net::yield_context yield) {
         // notify start()
-        queue.pushPrioritisedEvent<RunFunctionEvent>(getServiceId(), INTERNAL_COROUTINE_EVENT_PRIORITY, [this]() {
-            _startStopEvent.set();
-        });
+        _startStopEvent.set();
 
         net::steady_timer t{*_context};
         while (!_quit) {
@@ -52,9 +49,7 @@ Ichor::Task<tl::expected<void, Ichor::StartError>> Ichor::AsioContextService::st
         INTERNAL_DEBUG("+++++++++++++++++++++++++++++++++++++++++++++++ NOTIFY STOP ++++++++++++++++++++++++++++++++");
 
         // notify stop()
-        queue.pushPrioritisedEvent<RunFunctionEvent>(getServiceId(), INTERNAL_COROUTINE_EVENT_PRIORITY, [this]() {
-            _startStopEvent.set();
-        });
+        _startStopEvent.set();
     }ASIO_SPAWN_COMPLETION_TOKEN);
 
     for(uint64_t i = 0; i < _threads; i++) {
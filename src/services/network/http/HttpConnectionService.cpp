@@ -1,7 +1,6 @@
 #ifdef ICHOR_USE_BOOST_BEAST
 
 #include <ichor/DependencyManager.h>
-#include <ichor/events/RunFunctionEvent.h>
 #include <ichor/services/network/http/HttpConnectionService.h>
 #include <ichor/services/network/http/HttpScopeGuards.h>
 #include <ichor/services/network/NetworkEvents.h>
@@ -13,6 +12,7 @@ Ichor::HttpConnectionService::HttpConnectionService(DependencyRegister &reg, Pro
 
 Ichor::Task<tl::expected<void, Ichor::StartError>> Ichor::HttpConnectionService::start() {
     _queue = &GetThreadLocalEventQueue();
+    _stopToken = GetThreadLocalManager().getServiceStopToken(getServiceId());
 
     if(!_asioContextService->fibersShouldStop() && !_connecting.load(std::memory_order_acquire) && !_connected.load(std::memory_order_acquire)) {
         _quit.store(false, std::memory_order_release);
@@ -85,7 +85,7 @@ uint64_t Ichor::HttpConnectionService::getPriority() {
     return _priority.load(std::memory_order_acquire);
 }
 
-Ichor::Task<Ichor::HttpResponse> Ichor::HttpConnectionService::sendAsync(Ichor::HttpMethod method, std::string_view route, std::vector<HttpHeader> &&headers, std::vector<uint8_t> &&msg) {
+Ichor::Task<Ichor::HttpResponse> Ichor::HttpConnectionService::sendAsync(Ichor::HttpMethod method, std::string_view route, std::vector<HttpHeader> &&headers, std::vector<uint8_t> &&msg, CancellationToken token) {
     if(method == HttpMethod::get && !msg.empty()) {
         throw std::runtime_error("GET requests cannot have a body.");
     }
@@ -99,9 +99,32 @@ Ichor::Task<Ichor::HttpResponse> Ichor::HttpConnectionService::sendAsync(Ichor::
         co_return response;
     }
 
-    AsyncManualResetEvent event{};
+    std::atomic<bool> cancelled{};
+    uint64_t const requestId = ++_requestIdCounter;
+    auto cancel = [this, &cancelled, requestId]() {
+        cancelled.store(true, std::memory_order_seq_cst);
+        // Abort the request if it is being sent or received, queued requests are skipped by checking cancelled.
+        // Aborting a request on the wire fails the connection, as it cannot be reused with a partially sent request or an unread response.
+        _finishedListenAndRead.fetch_add(1, std::memory_order_acq_rel);
+        net::post(*_asioContextService->getContext(), [this, requestId]() {
+            // _httpStream should only be modified from the boost thread
+            if(_inFlightRequestId.load(std::memory_order_seq_cst) == requestId && _httpStream) {
+                _httpStream->cancel();
+            }
+            _finishedListenAndRead.fetch_sub(1, std::memory_order_acq_rel);
+        });
+    };
+    CancellationRegistration const cancelOnRequest{token, cancel};
+    CancellationRegistration const cancelOnStop{_stopToken, cancel};
 
-    net::spawn(*_asioContextService->getContext(), [this, method, route, &event, &response, &headers, &msg](net::yield_context yield) mutable {
+    if(cancelled.load(std::memory_order_acquire)) {
+        co_return response;
+    }
+
+    // priority 0, see below
+    AsyncCrossThreadEvent event{0u};
+
+    net::spawn(*_asioContextService->getContext(), [this, method, route, &event, &response, &headers, &msg, &cancelled, requestId](net::yield_context yield) mutable {
         static_assert(std::is_trivially_copyable_v<Detail::ConnectionOutboxMessage>, "ConnectionOutboxMessage should be trivially copyable");
         ScopeGuardAtomicCount const guard{_finishedListenAndRead};
 
@@ -109,7 +132,7 @@ Ichor::Task<Ichor::HttpResponse> Ichor::HttpConnectionService::sendAsync(Ichor::
         if(_outbox.full()) {
             _outbox.set_capacity(std::max<uint64_t>(_outbox.capacity() * 2, 10ul));
         }
-        _outbox.push_back({method, route, &event, &response, &headers, &msg});
+        _outbox.push_back({method, route, &event, &response, &headers, &msg, &cancelled, requestId});
         if(_outbox.size() > 1) {
             // handled by existing net::spawn
             return;
@@ -118,20 +141,20 @@ Ichor::Task<Ichor::HttpResponse> Ichor::HttpConnectionService::sendAsync(Ichor::
             // Copy message, should be trivially copyable and prevents iterator invalidation
             auto next = _outbox.front();
             lg.unlock();
+            _inFlightRequestId.store(next.requestId, std::memory_order_seq_cst);
 
-            ScopeGuardFunction const coroutineGuard{[this, &event, &lg]() {
-                // use service id 0 to ensure event gets run, even if service is stopped. Otherwise, the coroutine will never complete.
-                // Similarly, use priority 0 to ensure these events run before any dependency changes, otherwise the service might be destroyed
+            ScopeGuardFunction const coroutineGuard{[this, &next, &lg]() {
+                // The coroutine gets resumed even if the service is stopped, otherwise it would never complete.
+                // The event's priority 0 ensures it gets resumed before any dependency changes, otherwise the service might be destroyed
                 // before we can finish all the coroutines.
-                _queue->pushPrioritisedEvent<RunFunctionEvent>(0u, 0u, [&event]() {
-                    event.set();
-                });
+                _inFlightRequestId.store(0, std::memory_order_seq_cst);
+                next.event->set();
                 lg.lock();
                 _outbox.pop_front();
             }};
 
             // if the service has to quit, we still have to spool through all the remaining messages, to complete coroutines
-            if(_quit.load(std::memory_order_acquire)) {
+            if(_quit.load(std::memory_order_acquire) || next.cancelled->load(std::memory_order_seq_cst)) {
                 continue;
             }
 
@@ -160,11 +183,8 @@ Ichor::Task<Ichor::HttpResponse> Ichor::HttpConnectionService::sendAsync(Ichor::
                 continue;
             }
 
-            // if the service has to quit, we still have to spool through all the remaining messages, to complete coroutines
-            if(_quit.load(std::memory_order_acquire)) {
-                continue;
-            }
-
+            // The request has been sent, so its response has to be read even if the request got cancelled in the meantime.
+            // Otherwise the next request would receive it. A cancel aborting the read makes the connection unusable, fail() closes it.
             // This buffer is used for reading and must be persisted
             beast::basic_flat_buffer b{std::allocator<uint8_t>{}};
 
@@ -187,6 +207,10 @@ Ichor::Task<Ichor::HttpResponse> Ichor::HttpConnectionService::sendAsync(Ichor::
             // unset the timeout for the next operation.
             _httpStream->expires_never();
 
+            if(next.cancelled->load(std::memory_order_seq_cst)) {
+                continue;
+            }
+
             next.response->status = (HttpStatus) (int) res.result();
             next.response->headers.reserve(static_cast<unsigned long>(std::distance(std::begin(res), std::end(res))));
             for (auto const &header: res) {
@@ -213,9 +237,7 @@ Ichor::Task<void> Ichor::HttpConnectionService::close() {
             // _httpStream should only be modified from the boost thread
             _httpStream->cancel();
 
-            _queue->pushEvent<RunFunctionEvent>(getServiceId(), [this]() {
-                _startStopEvent.set();
-            });
+            _startStopEvent.set();
         }ASIO_SPAWN_COMPLETION_TOKEN);
     }
 
@@ -278,9 +300,7 @@ void Ichor::HttpConnectionService::connect(tcp::endpoint endpoint, net::yield_co
     }
 
     // set connected before connecting, or races with the start() function may occur.
-    _queue->pushEvent<RunFunctionEvent>(getServiceId(), [this]() {
-        _startStopEvent.set();
-    });
+    _startStopEvent.set();
     _connected.store(true, std::memory_order_release);
     _connecting.store(false, std::memory_order_release);
 }
@@ -60,9 +60,7 @@ Ichor::Task<void> Ichor::HttpHostService::stop() {
 
             _httpAcceptor = nullptr;
 
-            _queue->pushEvent<RunFunctionEvent>(getServiceId(), [this]() {
-                _startStopEvent.set();
-            });
+            _startStopEvent.set();
         }ASIO_SPAWN_COMPLETION_TOKEN);
     }
 
@@ -6,7 +6,6 @@
 #include <ichor/services/network/NetworkEvents.h>
 #include <ichor/services/network/IHostService.h>
 #include <ichor/services/network/http/HttpScopeGuards.h>
-#include <ichor/events/RunFunctionEvent.h>
 #include <thread>
 
 template<class NextLayer>
@@ -87,10 +86,7 @@ Ichor::Task<void> Ichor::WsConnectionService::stop() {
             if (ec) {
                 ICHOR_LOG_ERROR(_logger, "Boost.BEAST fail: {}", ec.message());
             }
-            _queue->pushPrioritisedEvent<RunFunctionEvent>(getServiceId(), _priority.load(std::memory_order_acquire), [this]() {
-//                fmt::print("{}:{} rfe2\n", getServiceId(), getServiceName());
-                _startStopEvent.set();
-            });
+            _startStopEvent.set(_priority.load(std::memory_order_acquire));
         }ASIO_SPAWN_COMPLETION_TOKEN);
 
 //        fmt::print("----------------------------------------------- {}:{} wait {}\n", getServiceId(), getServiceName(), _startStopEvent.is_set());
@@ -195,10 +191,7 @@ void Ichor::WsConnectionService::fail(beast::error_code ec, const char *what) {
 //    fmt::print("{}:{} fail {}\n", getServiceId(), getServiceName(), ec.message());
     ICHOR_LOG_ERROR(_logger, "Boost.BEAST fail: {}, {}", what, ec.message());
 
-    _queue->pushPrioritisedEvent<RunFunctionEvent>(getServiceId(), _priority.load(std::memory_order_acquire), [this]() {
-//        fmt::print("{}:{} rfe\n", getServiceId(), getServiceName());
-        _startStopEvent.set();
-    });
+    _startStopEvent.set(_priority.load(std::memory_order_acquire));
     _queue->pushEvent<StopServiceEvent>(getServiceId(), getServiceId());
 }
 
@@ -207,21 +200,17 @@ void Ichor::WsConnectionService::accept(net::yield_context yield) {
 
     {
         ScopeGuardFunction const coroutineGuard{[this]() {
-            _queue->pushPrioritisedEvent<RunFunctionEvent>(getServiceId(), _priority.load(std::memory_order_acquire), [this]() {
-//                fmt::print("{}:{} rfe accept\n", getServiceId(), getServiceName());
-                _startStopEvent.set();
-            });
+            _startStopEvent.set(_priority.load(std::memory_order_acquire));
         }};
 
         if (!_ws) {
-            auto socketIt = getProperties().find("Socket");
-
-            if (socketIt == getProperties().end()) [[unlikely]] {
+            if (!getProperties().contains("Socket")) [[unlikely]] {
                 return fail(ec, "socket setup");
             }
 
-            _ws = Ichor::any_cast<std::shared_ptr<websocket::stream<beast::tcp_stream>> &>(socketIt->second);
-            socketIt->second = Ichor::make_any<bool>(false); // ensure we cannot start again by making a bogus reference to socket
+            auto &socketProp = getProperties()["Socket"];
+            _ws = Ichor::any_cast<std::shared_ptr<websocket::stream<beast::tcp_stream>> &>(socketProp);
+            socketProp = Ichor::make_any<bool>(false); // ensure we cannot start again by making a bogus reference to socket
         }
 
         setup_stream(_ws);
@@ -274,10 +263,7 @@ void Ichor::WsConnectionService::connect(net::yield_context yield) {
 
     {
         ScopeGuardFunction const coroutineGuard{[this]() {
-            _queue->pushPrioritisedEvent<RunFunctionEvent>(getServiceId(), _priority.load(std::memory_order_acquire), [this]() {
-//                fmt::print("{}:{} rfe connect\n", getServiceId(), getServiceName());
-                _startStopEvent.set();
-            });
+            _startStopEvent.set(_priority.load(std::memory_order_acquire));
         }};
 
         // Look up the domain name
@@ -5,7 +5,7 @@
 #include <hiredis/hiredis.h>
 #include <hiredis/async.h>
 #include <hiredis/adapters/poll.h>
-#include <ichor/events/RunFunctionEvent.h>
+#include <ichor/coroutines/AsyncCrossThreadEvent.h>
 
 #define FMT_INLINE_BUFFER_SIZE 1024
 
@@ -16,8 +16,10 @@ namespace Ichor {
                 freeReplyObject(reply);
             }
         }
-        redisReply *reply;
-        AsyncManualResetEvent evt{};
+        redisReply *reply{};
+        AsyncCrossThreadEvent evt{INTERNAL_EVENT_PRIORITY};
+        bool replied{};
+        bool cancelled{}; // the awaiting coroutine stopped waiting, _onAsyncReply frees this reply
     };
 
     static void _onRedisConnect(const struct redisAsyncContext *c, int status) {
@@ -30,14 +32,46 @@ namespace Ichor {
         svc->onRedisDisconnect(status);
     }
 
-    static void _onAsyncReply(redisAsyncContext *c, void *reply, void *privdata) {
+    static void _onAsyncReply(redisAsyncContext *, void *reply, void *privdata) {
         auto *ichorReply = static_cast<IchorRedisReply*>(privdata);
-        auto *svc = static_cast<HiredisService*>(c->data);
         ichorReply->reply = static_cast<redisReply *>(reply);
 
-        GetThreadLocalManager().getEventQueue().pushEvent<RunFunctionEvent>(svc->getServiceId(), [ichorReply]() {
-            ichorReply->evt.set();
-        });
+        if(ichorReply->cancelled) {
+            delete ichorReply;
+            return;
+        }
+
+        ichorReply->replied = true;
+        ichorReply->evt.set();
+    }
+
+    /// Waits for the reply of a command issued with _onAsyncReply, unless token or stopToken get cancelled first.
+    /// Hiredis cannot cancel sent commands, so a cancelled reply is handed over to _onAsyncReply to free.
+    /// \return reply or nullptr if cancelled
+    static Task<std::unique_ptr<IchorRedisReply>> _awaitReply(std::unique_ptr<IchorRedisReply> reply, CancellationToken token, CancellationToken stopToken) {
+        // Tracked here rather than in the reply: once cancelled, _onAsyncReply may free the reply before this coroutine resumes.
+        bool cancelled{};
+        {
+            auto cancel = [ichorReply = reply.get(), &cancelled]() {
+                if(cancelled || ichorReply->replied) {
+                    return;
+                }
+                cancelled = true;
+                ichorReply->cancelled = true;
+                ichorReply->evt.set();
+            };
+            CancellationRegistration const cancelOnRequest{token, cancel};
+            CancellationRegistration const cancelOnStop{stopToken, cancel};
+
+            co_await reply->evt;
+        }
+
+        if(cancelled) {
+            static_cast<void>(reply.release());
+            co_return nullptr;
+        }
+
+        co_return std::move(reply);
     }
 
     static fmt::basic_memory_buffer<char, FMT_INLINE_BUFFER_SIZE> _formatSet(std::string_view const &key, std::string_view const &value, RedisSetOptions const &opts) {
@@ -98,6 +132,8 @@ Ichor::Task<tl::expected<void, Ichor::StartError>> Ichor::HiredisService::start(
         co_return tl::unexpected(StartError::FAILED);
     }
 
+    _stopToken = GetThreadLocalManager().getServiceStopToken(getServiceId());
+
     auto &timer = _timerFactory->createTimer();
     timer.setCallback([this]() {
         redisPollTick(_redisContext, 0);
@@ -142,51 +178,51 @@ uint64_t Ichor::HiredisService::getPriority() {
     return _priority.load(std::memory_order_acquire);
 }
 
-Ichor::AsyncGenerator<Ichor::RedisAuthReply> Ichor::HiredisService::auth(std::string_view user, std::string_view password) {
-    IchorRedisReply evt{};
-    auto ret = redisAsyncCommand(_redisContext, _onAsyncReply, &evt, "AUTH %b %b", user.data(), user.size(), password.data(), password.size());
+Ichor::AsyncGenerator<Ichor::RedisAuthReply> Ichor::HiredisService::auth(std::string_view user, std::string_view password, CancellationToken token) {
+    auto evt = std::make_unique<IchorRedisReply>();
+    auto ret = redisAsyncCommand(_redisContext, _onAsyncReply, evt.get(), "AUTH %b %b", user.data(), user.size(), password.data(), password.size());
     if(ret == REDIS_ERR) [[unlikely]] {
         throw std::runtime_error("couldn't run async command");
     }
-    co_await evt.evt;
+    evt = co_await _awaitReply(std::move(evt), std::move(token), _stopToken);
 
-    if(evt.reply == nullptr) [[unlikely]] {
+    if(evt == nullptr || evt->reply == nullptr) [[unlikely]] {
         co_return RedisAuthReply{};
     }
 
     co_return RedisAuthReply{true};
 }
 
-Ichor::AsyncGenerator<Ichor::RedisSetReply> Ichor::HiredisService::set(std::string_view key, std::string_view value) {
-    IchorRedisReply evt{};
-    auto ret = redisAsyncCommand(_redisContext, _onAsyncReply, &evt, "SET %b %b", key.data(), key.size(), value.data(), value.size());
+Ichor::AsyncGenerator<Ichor::RedisSetReply> Ichor::HiredisService::set(std::string_view key, std::string_view value, CancellationToken token) {
+    auto evt = std::make_unique<IchorRedisReply>();
+    auto ret = redisAsyncCommand(_redisContext, _onAsyncReply, evt.get(), "SET %b %b", key.data(), key.size(), value.data(), value.size());
     if(ret == REDIS_ERR) [[unlikely]] {
         throw std::runtime_error("couldn't run async command");
     }
-    co_await evt.evt;
+    evt = co_await _awaitReply(std::move(evt), std::move(token), _stopToken);
 
-    if(evt.reply == nullptr) [[unlikely]] {
+    if(evt == nullptr || evt->reply == nullptr) [[unlikely]] {
         co_return RedisSetReply{};
     }
 
-    co_return RedisSetReply{true, evt.reply->str};
+    co_return RedisSetReply{true, evt->reply->str};
 }
 
-Ichor::AsyncGenerator<Ichor::RedisSetReply> Ichor::HiredisService::set(std::string_view key, std::string_view value, RedisSetOptions const &opts) {
+Ichor::AsyncGenerator<Ichor::RedisSetReply> Ichor::HiredisService::set(std::string_view key, std::string_view value, RedisSetOptions const &opts, CancellationToken token) {
     auto buf = _formatSet(key, value, opts);
 
-    IchorRedisReply evt{};
-    auto ret = redisAsyncCommand(_redisContext, _onAsyncReply, &evt, buf.data());
+    auto evt = std::make_unique<IchorRedisReply>();
+    auto ret = redisAsyncCommand(_redisContext, _onAsyncReply, evt.get(), buf.data());
     if(ret == REDIS_ERR) [[unlikely]] {
         throw std::runtime_error("couldn't run async command");
     }
-    co_await evt.evt;
+    evt = co_await _awaitReply(std::move(evt), std::move(token), _stopToken);
 
-    if(evt.reply == nullptr) [[unlikely]] {
+    if(evt == nullptr || evt->reply == nullptr) [[unlikely]] {
         co_return RedisSetReply{};
     }
 
-    co_return RedisSetReply{true, evt.reply->str};
+    co_return RedisSetReply{true, evt->reply->str};
 }
 
 void Ichor::HiredisService::setAndForget(std::string_view key, std::string_view value) {
@@ -205,19 +241,19 @@ void Ichor::HiredisService::setAndForget(std::string_view key, std::string_view
     }
 }
 
-Ichor::AsyncGenerator<Ichor::RedisGetReply> Ichor::HiredisService::get(std::string_view key) {
-    IchorRedisReply evt{};
-    auto ret = redisAsyncCommand(_redisContext, _onAsyncReply, &evt, "GET %b", key.data(), key.size());
+Ichor::AsyncGenerator<Ichor::RedisGetReply> Ichor::HiredisService::get(std::string_view key, CancellationToken token) {
+    auto evt = std::make_unique<IchorRedisReply>();
+    auto ret = redisAsyncCommand(_redisContext, _onAsyncReply, evt.get(), "GET %b", key.data(), key.size());
     if(ret == REDIS_ERR) [[unlikely]] {
         throw std::runtime_error("couldn't run async command");
     }
-    co_await evt.evt;
+    evt = co_await _awaitReply(std::move(evt), std::move(token), _stopToken);
 
-    if(evt.reply == nullptr) [[unlikely]] {
+    if(evt == nullptr || evt->reply == nullptr) [[unlikely]] {
         co_return RedisGetReply{};
     }
 
-    co_return RedisGetReply{evt.reply->str};
+    co_return RedisGetReply{evt->reply->str};
 }
 
 void Ichor::HiredisService::onRedisConnect(int status) {
@@ -253,7 +289,7 @@ tl::expected<void, Ichor::StartError> Ichor::HiredisService::connect() {
     }
 
     redisOptions opts{};
-    REDIS_OPTIONS_SET_TCP(&opts, Ichor::any_cast<std::string&>(addrIt->second).c_str(), Ichor::any_cast<uint16_t>(portIt->second));
+    REDIS_OPTIONS_SET_TCP(&opts, Ichor::any_cast<std::string const &>(addrIt->second).c_str(), Ichor::any_cast<uint16_t>(portIt->second));
     opts.options |= REDIS_OPT_REUSEADDR;
     opts.options |= REDIS_OPT_NOAUTOFREEREPLIES;
     _redisContext = redisAsyncConnectWithOptions(&opts);
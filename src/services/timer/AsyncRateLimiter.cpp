@@ -0,0 +1,111 @@
+#include <ichor/services/timer/AsyncRateLimiter.h>
+#include <ichor/DependencyManager.h>
+#include <algorithm>
+#include <cassert>
+#include <mutex>
+
+template <typename Lock>
+Ichor::BasicAsyncRateLimiter<Lock>::BasicAsyncRateLimiter(ITimerFactory &timerFactory, uint64_t tokensPerInterval, std::chrono::nanoseconds interval, uint64_t burst, uint64_t priority)
+        : _timerFactory(timerFactory), _tokens(burst), _tokensPerInterval(tokensPerInterval), _burst(burst), _priority(priority) {
+#ifdef ICHOR_USE_HARDENING
+    if(tokensPerInterval == 0 || burst == 0) [[unlikely]] {
+        std::terminate();
+    }
+#endif
+
+    _timer = &_timerFactory.createTimer();
+    _timer->setChronoInterval(interval);
+    _timer->setPriority(priority);
+    _timer->setCallback([this, destroyed = _destroyed]() {
+        if(*destroyed) {
+            return;
+        }
+        refill();
+    });
+}
+
+template <typename Lock>
+Ichor::BasicAsyncRateLimiter<Lock>::~BasicAsyncRateLimiter() {
+    // There should be no coroutines still waiting for tokens.
+    assert(_waiters.empty());
+
+    *_destroyed = true;
+    _timer->stopTimer();
+    _timerFactory.destroyTimer(_timer->getTimerId());
+}
+
+template <typename Lock>
+Ichor::BasicAsyncRateLimiterOperation<Lock> Ichor::BasicAsyncRateLimiter<Lock>::acquire(uint64_t count) noexcept {
+    if(count > _burst) [[unlikely]] {
+        std::terminate();
+    }
+
+    return BasicAsyncRateLimiterOperation<Lock>{*this, count};
+}
+
+template <typename Lock>
+bool Ichor::BasicAsyncRateLimiter<Lock>::tryAcquire(uint64_t count) noexcept {
+    std::unique_lock const lg{_lock};
+    if(_tokens < count || !_waiters.empty()) {
+        return false;
+    }
+    _tokens -= count;
+    startRefilling();
+    return true;
+}
+
+template <typename Lock>
+uint64_t Ichor::BasicAsyncRateLimiter<Lock>::available() const noexcept {
+    std::unique_lock const lg{_lock};
+    return _waiters.empty() ? _tokens : 0;
+}
+
+template <typename Lock>
+void Ichor::BasicAsyncRateLimiter<Lock>::startRefilling() {
+    if(!_timer->running()) {
+        _timer->startTimer();
+    }
+}
+
+template <typename Lock>
+void Ichor::BasicAsyncRateLimiter<Lock>::refill() {
+    Detail::AsyncWaiterQueue resumable{};
+    uint64_t priority;
+    {
+        std::unique_lock const lg{_lock};
+        _tokens = std::min(_burst, _tokens + _tokensPerInterval);
+        while(!_waiters.empty() && _waiters.front().count <= _tokens) {
+            _tokens -= _waiters.front().count;
+            resumable.push(_waiters.pop());
+        }
+
+        if(_tokens == _burst) {
+            _timer->stopTimer();
+        }
+        priority = _priority;
+    }
+
+    resumable.resumeAll(priority);
+}
+
+template <typename Lock>
+bool Ichor::BasicAsyncRateLimiterOperation<Lock>::await_suspend(std::coroutine_handle<> awaiter) noexcept {
+    std::unique_lock const lg{_limiter._lock};
+    if(_limiter._tokens >= _count && _limiter._waiters.empty()) {
+        _limiter._tokens -= _count;
+        _limiter.startRefilling();
+        return false;
+    }
+
+    _waiter.resumption.awaiter = awaiter;
+    _waiter.dm = Detail::_local_dm;
+    _waiter.count = _count;
+    _limiter._waiters.push(_waiter);
+    _limiter.startRefilling();
+    return true;
+}
+
+template class Ichor::BasicAsyncRateLimiter<Ichor::Detail::SingleThreadLock>;
+template class Ichor::BasicAsyncRateLimiter<Ichor::RealtimeMutex>;
+template class Ichor::BasicAsyncRateLimiterOperation<Ichor::Detail::SingleThreadLock>;
+template class Ichor::BasicAsyncRateLimiterOperation<Ichor::RealtimeMutex>;
@@ -1,18 +1,13 @@
 #include <ichor/services/timer/Timer.h>
+#include <ichor/DependencyManager.h>
 #include <ichor/events/RunFunctionEvent.h>
-#if (defined(WIN32) || defined(_WIN32) || defined(__WIN32)) && !defined(__CYGWIN__)
-#include <processthreadsapi.h>
-#include <fmt/xchar.h>
-#endif
 
-using namespace std::chrono_literals;
-
-Ichor::Timer::Timer(Ichor::IEventQueue *queue, uint64_t timerId, uint64_t svcId) noexcept : _queue(queue), _timerId(timerId), _requestingServiceId(svcId) {
-    stopTimer();
+Ichor::Timer::Timer(DependencyManager &dm, uint64_t timerId, uint64_t svcId) : _dm(&dm), _queue(&dm.getEventQueue()), _timerId(timerId), _requestingServiceId(svcId) {
+    _dm->registerTimer(*this);
 }
 
 Ichor::Timer::~Timer() noexcept {
-    stopTimer();
+    _dm->unregisterTimer(*this);
 }
 
 void Ichor::Timer::startTimer() {
@@ -24,25 +19,38 @@ void Ichor::Timer::startTimer(bool fireImmediately) {
         throw std::runtime_error("No callback set.");
     }
 
-    bool expected = true;
-    if(_quit.compare_exchange_strong(expected, false, std::memory_order_acq_rel)) {
-        _eventInsertionThread = std::make_unique<std::thread>([this, fireImmediately]() { this->insertEventLoop(fireImmediately); });
-#if defined(__linux__) || defined(__CYGWIN__)
-        pthread_setname_np(_eventInsertionThread->native_handle(), fmt::format("Tmr #{}", _timerId).c_str());
-#endif
+    if(Detail::_local_dm != _dm) {
+        _fireImmediately.store(fireImmediately, std::memory_order_release);
+        if(!_running.exchange(true, std::memory_order_acq_rel)) {
+            pushReconcile();
+        }
+        return;
+    }
+
+    if(_running.exchange(true, std::memory_order_acq_rel)) {
+        return;
     }
+
+    // still scheduled if a stop from another thread has not been applied yet
+    _dm->cancelTimer(*this);
+    schedule(fireImmediately);
 }
 
 void Ichor::Timer::stopTimer() {
-    bool expected = false;
-    if(_quit.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
-        _eventInsertionThread->join();
-        _eventInsertionThread = nullptr;
+    if(!_running.exchange(false, std::memory_order_acq_rel)) {
+        return;
+    }
+
+    if(Detail::_local_dm != _dm) {
+        pushReconcile();
+        return;
     }
+
+    _dm->cancelTimer(*this);
 }
 
 bool Ichor::Timer::running() const noexcept {
-    return !_quit.load(std::memory_order_acquire);
+    return _running.load(std::memory_order_acquire);
 };
 
 void Ichor::Timer::setCallbackAsync(std::function<AsyncGenerator<IchorBehaviour>()> fn) {
@@ -67,6 +75,14 @@ void Ichor::Timer::setInterval(uint64_t nanoseconds) noexcept {
     _intervalNanosec.store(nanoseconds, std::memory_order_release);
 }
 
+void Ichor::Timer::setSlack(uint64_t nanoseconds) noexcept {
+    _slackNanosec.store(nanoseconds, std::memory_order_release);
+}
+
+void Ichor::Timer::setMissedTickPolicy(TimerMissedTickPolicy policy) noexcept {
+    _missedTickPolicy.store(policy, std::memory_order_release);
+}
+
 
 void Ichor::Timer::setPriority(uint64_t priority) noexcept {
     _priority.store(priority, std::memory_order_release);
@@ -80,40 +96,72 @@ uint64_t Ichor::Timer::getTimerId() const noexcept {
     return _timerId;
 }
 
-void Ichor::Timer::insertEventLoop(bool fireImmediately) {
-#if defined(__APPLE__)
-    pthread_setname_np(fmt::format("Tmr #{}", _timerId).c_str());
-#endif
-#if (defined(WIN32) || defined(_WIN32) || defined(__WIN32)) && !defined(__CYGWIN__)
-    SetThreadDescription(GetCurrentThread(), fmt::format(L"Tmr #{}", _timerId).c_str());
-#endif
+void Ichor::Timer::schedule(bool fireImmediately) noexcept {
+    _next = std::chrono::steady_clock::now();
+    _skippedLast = false;
+    if(!fireImmediately) {
+        _next += std::chrono::nanoseconds(_intervalNanosec.load(std::memory_order_acquire));
+    }
+    scheduleNext();
+}
+
+void Ichor::Timer::scheduleNext() noexcept {
+    // More slack than half the interval could push an expiry past the next one
+    auto const slack = std::min(_slackNanosec.load(std::memory_order_acquire), _intervalNanosec.load(std::memory_order_acquire) / 2);
+    _dm->scheduleTimer(*this, _next, std::chrono::nanoseconds(slack));
+}
 
+void Ichor::Timer::reconcile() noexcept {
+    bool const shouldRun = running();
+    if(shouldRun && !isScheduled()) {
+        schedule(_fireImmediately.load(std::memory_order_acquire));
+    } else if(!shouldRun && isScheduled()) {
+        _dm->cancelTimer(*this);
+    }
+}
+
+void Ichor::Timer::pushReconcile() {
+    // looked up by id, the timer may be destroyed before the event is handled
+    _queue->pushEvent<RunFunctionEvent>(0, [dm = _dm, timerId = _timerId]() {
+        auto timerIt = dm->_timers.find(timerId);
+        if(timerIt != dm->_timers.end()) {
+            timerIt->second->reconcile();
+        }
+    });
+}
 
-    while(!_quit.load(std::memory_order_acquire) && _queue == nullptr) {
-        std::this_thread::sleep_for(1ms);
+void Ichor::Timer::expire(std::chrono::steady_clock::time_point now) {
+    // stopped from another thread, the stop has not been applied yet
+    if(!running()) {
+        return;
     }
 
-    auto now = std::chrono::steady_clock::now();
-    auto next = now;
-    if(!fireImmediately) {
-        next += std::chrono::nanoseconds(_intervalNanosec.load(std::memory_order_acquire));
+    // Expiries on the schedule that passed as well, e.g. because the event loop was busy. Counted from the deadline rather than
+    // from the moment of expiry, so the timer stays on the schedule it was started with.
+    auto const interval = std::chrono::nanoseconds(_intervalNanosec.load(std::memory_order_acquire));
+    uint64_t missed{};
+    if(interval.count() > 0 && now - _next >= interval) {
+        missed = static_cast<uint64_t>((now - _next) / interval);
     }
-    while(!_quit.load(std::memory_order_acquire)) {
-        while(now < next) {
-            std::this_thread::sleep_for(std::chrono::nanoseconds(_intervalNanosec.load(std::memory_order_acquire)/10));
-            now = std::chrono::steady_clock::now();
-
-            if(_quit.load(std::memory_order_acquire)) {
-                return;
-            }
-        }
-        // Make copy of function, in case setCallback() gets called during async stuff.
-        if(_fnAsync) {
-            _queue->pushPrioritisedEvent<RunFunctionEventAsync>(_requestingServiceId, getPriority(), _fnAsync);
-        } else {
-            _queue->pushPrioritisedEvent<RunFunctionEvent>(_requestingServiceId, getPriority(), _fn);
-        }
+    _next += interval * static_cast<int64_t>(missed + 1);
+
+    auto const policy = _missedTickPolicy.load(std::memory_order_acquire);
+    uint64_t expiries{1};
+    if(policy == TimerMissedTickPolicy::CATCH_UP) {
+        expiries += missed;
+    } else if(policy == TimerMissedTickPolicy::SKIP && missed > 0 && !_skippedLast) {
+        // The next expiry runs the callback even if it is late as well, otherwise a timer on a loop that is always late would never run
+        expiries = 0;
+    }
+    _skippedLast = expiries == 0;
 
-        next += std::chrono::nanoseconds(_intervalNanosec.load(std::memory_order_acquire));
+    if(expiries > 0) {
+        // At most one event per timer in the queue, an expiry while it is queued counts as missed instead of piling up events
+        if(_queuedExpiries == 0) {
+            _queue->pushPrioritisedEvent<TimerEvent>(_requestingServiceId, getPriority(), _timerId);
+        }
+        _queuedExpiries = policy == TimerMissedTickPolicy::CATCH_UP ? _queuedExpiries + expiries : 1;
     }
+
+    scheduleNext();
 }
@@ -5,8 +5,7 @@
 
 class Ichor::TimerFactory final : public Ichor::ITimerFactory, public Ichor::AdvancedService<TimerFactory> {
 public:
-    TimerFactory(Ichor::DependencyRegister &reg, Ichor::Properties props) : Ichor::AdvancedService<TimerFactory>(std::move(props)) {
-        reg.registerDependency<Ichor::IEventQueue>(this, true);
+    TimerFactory(Ichor::Properties props) : Ichor::AdvancedService<TimerFactory>(std::move(props)) {
         _requestingSvcId = Ichor::any_cast<uint64_t>(getProperties()["requestingSvcId"]);
     }
     ~TimerFactory() final = default;
@@ -17,7 +16,10 @@ public:
             std::terminate();
         }
 #endif
-        return *(_timers.emplace_back(new Ichor::Timer(_queue, _timerIdCounter.fetch_add(1, std::memory_order_relaxed), _requestingSvcId)));
+        auto const timerId = _timerIdCounter.fetch_add(1, std::memory_order_relaxed);
+        // std::make_unique doesn't work with friends
+        auto [timerIt, inserted] = _timers.emplace(timerId, std::unique_ptr<Ichor::Timer>(new Ichor::Timer(Ichor::GetThreadLocalManager(), timerId, _requestingSvcId)));
+        return *timerIt->second;
     }
 
     void destroyTimer(uint64_t timerId) final {
@@ -26,22 +28,11 @@ public:
             std::terminate();
         }
 #endif
-        std::erase_if(_timers, [timerId](std::unique_ptr<Ichor::Timer> const &timer) {
-            return timer->getTimerId() == timerId;
-        });
-    }
-
-    void addDependencyInstance(Ichor::IEventQueue &q, IService&) noexcept {
-        _queue = &q;
-    }
-
-    void removeDependencyInstance(Ichor::IEventQueue&, IService&) noexcept {
-        _queue = nullptr;
+        _timers.erase(timerId);
     }
 
     static std::atomic<uint64_t> _timerIdCounter;
-    std::vector<std::unique_ptr<Ichor::Timer>> _timers;
-    Ichor::IEventQueue* _queue{};
+    Ichor::unordered_map<uint64_t, std::unique_ptr<Ichor::Timer>> _timers; // key = timer id
     uint64_t _requestingSvcId{};
 };
 std::atomic<uint64_t> Ichor::TimerFactory::_timerIdCounter{};
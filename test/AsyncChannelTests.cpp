@@ -0,0 +1,184 @@
+#include "Common.h"
+#include <ichor/coroutines/AsyncChannel.h>
+#include <ichor/coroutines/AsyncCrossThreadChannel.h>
+#include <ichor/event_queues/MultimapQueue.h>
+#include <ichor/events/RunFunctionEvent.h>
+
+template<typename F>
+Ichor::AsyncGenerator<void> run(F f) {
+    co_await f();
+    co_return;
+}
+
+TEST_CASE("AsyncChannelTests") {
+
+    SECTION("values are buffered up to capacity")
+    {
+        Ichor::AsyncChannel<int> channel{2};
+        std::vector<int> received;
+        bool sent{};
+        auto gen = run([&]() -> Ichor::Task<void> {
+            sent = co_await channel.send(1);
+            sent = sent && co_await channel.send(2);
+            received.push_back(*co_await channel.receive());
+            received.push_back(*co_await channel.receive());
+        });
+        auto it = gen.begin();
+        CHECK(it.get_finished());
+        CHECK(sent);
+        CHECK(received == std::vector<int>{1, 2});
+        CHECK(channel.size() == 0);
+    }
+
+    SECTION("send suspends while full")
+    {
+        Ichor::AsyncChannel<int> channel{1};
+        bool sent{};
+        auto gen = run([&]() -> Ichor::Task<void> {
+            co_await channel.send(1);
+            co_await channel.send(2);
+            sent = true;
+        });
+        auto it = gen.begin();
+        CHECK(!sent);
+        CHECK(channel.size() == 1);
+        int value{};
+        CHECK(!channel.trySend(value));
+
+        CHECK(channel.tryReceive() == 1);
+        CHECK(sent);
+        CHECK(channel.tryReceive() == 2);
+        CHECK(!channel.tryReceive());
+    }
+
+    SECTION("receive suspends while empty")
+    {
+        Ichor::AsyncChannel<int> channel{1};
+        std::optional<int> received;
+        auto gen = run([&]() -> Ichor::Task<void> {
+            received = co_await channel.receive();
+        });
+        auto it = gen.begin();
+        CHECK(!received);
+
+        int value{5};
+        CHECK(channel.trySend(value));
+        CHECK(received == 5);
+        CHECK(channel.size() == 0);
+    }
+
+    SECTION("close fails senders and drains receivers")
+    {
+        Ichor::AsyncChannel<int> channel{1};
+        bool sent{true};
+        std::vector<std::optional<int>> received;
+        auto sender = run([&]() -> Ichor::Task<void> {
+            co_await channel.send(1);
+            sent = co_await channel.send(2);
+        });
+        auto senderIt = sender.begin();
+        channel.close();
+        CHECK(!sent);
+
+        auto receiver = run([&]() -> Ichor::Task<void> {
+            received.push_back(co_await channel.receive());
+            received.push_back(co_await channel.receive());
+        });
+        auto receiverIt = receiver.begin();
+        CHECK(received == std::vector<std::optional<int>>{1, std::nullopt});
+
+        int value{};
+        CHECK(!channel.trySend(value));
+    }
+
+    SECTION("cross-thread channel without contention")
+    {
+        Ichor::AsyncCrossThreadChannel<int> channel{3};
+        CHECK(channel.capacity() == 4);
+        std::vector<int> received;
+        bool sent{};
+        auto gen = run([&]() -> Ichor::Task<void> {
+            for(int i = 0; i < 5; i++) {
+                co_await channel.send(i);
+            }
+            sent = true;
+        });
+        auto it = gen.begin();
+        CHECK(!sent);
+
+        while(auto value = channel.tryReceive()) {
+            received.push_back(*value);
+        }
+        CHECK(sent);
+        CHECK(received == std::vector<int>{0, 1, 2, 3, 4});
+
+        channel.close();
+        std::optional<int> closed{-1};
+        auto receiver = run([&]() -> Ichor::Task<void> {
+            closed = co_await channel.receive();
+        });
+        auto receiverIt = receiver.begin();
+        CHECK(!closed);
+    }
+
+    SECTION("cross-thread channel between managers")
+    {
+        constexpr uint64_t count = 10'000;
+        Ichor::AsyncCrossThreadChannel<uint64_t> channel{8};
+        uint64_t sum{};
+        uint64_t received{};
+        std::atomic<bool> done{};
+
+        auto queue1 = std::make_unique<MultimapQueue>();
+        auto &dm1 = queue1->createManager();
+        auto queue2 = std::make_unique<MultimapQueue>();
+        auto &dm2 = queue2->createManager();
+
+        std::thread t1([&]() {
+            dm1.createServiceManager<CoutFrameworkLogger, IFrameworkLogger>();
+            queue1->start(CaptureSigInt);
+        });
+        std::thread t2([&]() {
+            dm2.createServiceManager<CoutFrameworkLogger, IFrameworkLogger>();
+            queue2->start(CaptureSigInt);
+        });
+
+        waitForRunning(dm1);
+        waitForRunning(dm2);
+
+        queue2->pushEvent<RunFunctionEventAsync>(0, [&]() -> AsyncGenerator<IchorBehaviour> {
+            auto values = receiveAll(channel);
+            while(true) {
+                auto value = *co_await values.begin();
+                if(!value) {
+                    break;
+                }
+                sum += *value;
+                received++;
+            }
+            done = true;
+            co_return {};
+        });
+
+        queue1->pushEvent<RunFunctionEventAsync>(0, [&]() -> AsyncGenerator<IchorBehaviour> {
+            for(uint64_t i = 1; i <= count; i++) {
+                co_await channel.send(i);
+            }
+            channel.close();
+            co_return {};
+        });
+
+        while(!done.load()) {
+            std::this_thread::sleep_for(1ms);
+        }
+
+        queue1->pushEvent<QuitEvent>(0);
+        queue2->pushEvent<QuitEvent>(0);
+
+        t1.join();
+        t2.join();
+
+        CHECK(received == count);
+        CHECK(sum == count * (count + 1) / 2);
+    }
+}
@@ -0,0 +1,96 @@
+#include "Common.h"
+#include <ichor/services/timer/AsyncRateLimiter.h>
+
+/// Timer that only fires when the test calls fire()
+struct ManualTimer final : public ITimer {
+    void startTimer() final { running_ = true; }
+    void startTimer(bool) final { running_ = true; }
+    void stopTimer() final { running_ = false; }
+    [[nodiscard]] bool running() const noexcept final { return running_; }
+    void setInterval(uint64_t) noexcept final {}
+    void setSlack(uint64_t) noexcept final {}
+    void setMissedTickPolicy(TimerMissedTickPolicy) noexcept final {}
+    void setPriority(uint64_t) noexcept final {}
+    [[nodiscard]] uint64_t getPriority() const noexcept final { return 0; }
+    [[nodiscard]] uint64_t getTimerId() const noexcept final { return 1; }
+    void setCallbackAsync(std::function<AsyncGenerator<IchorBehaviour>()>) final { std::terminate(); }
+    void setCallback(std::function<void()> fn) final { fn_ = std::move(fn); }
+
+    void fire() {
+        REQUIRE(running_);
+        fn_();
+    }
+
+    bool running_{};
+    std::function<void()> fn_{};
+};
+
+struct ManualTimerFactory final : public ITimerFactory {
+    ITimer& createTimer() final { return timer; }
+    void destroyTimer(uint64_t) final { destroyed = true; }
+
+    ManualTimer timer{};
+    bool destroyed{};
+};
+
+template<typename F>
+Ichor::AsyncGenerator<void> run(F f) {
+    co_await f();
+    co_return;
+}
+
+TEST_CASE("AsyncRateLimiterTests") {
+    ManualTimerFactory factory;
+
+    SECTION("bucket starts full and refills while not full")
+    {
+        {
+            Ichor::AsyncRateLimiter limiter{factory, 1, 10ms, 2};
+            CHECK(limiter.available() == 2);
+            CHECK(!factory.timer.running());
+
+            CHECK(limiter.tryAcquire(2));
+            CHECK(!limiter.tryAcquire());
+            CHECK(factory.timer.running());
+
+            factory.timer.fire();
+            CHECK(limiter.available() == 1);
+            CHECK(factory.timer.running());
+
+            factory.timer.fire();
+            CHECK(limiter.available() == 2);
+            CHECK(!factory.timer.running());
+        }
+        CHECK(factory.destroyed);
+    }
+
+    SECTION("waiters are resumed in order once enough tokens are available")
+    {
+        Ichor::AsyncRateLimiter limiter{factory, 1, 10ms, 3};
+        std::vector<int> order;
+        CHECK(limiter.tryAcquire(3));
+
+        auto gen1 = run([&]() -> Ichor::Task<void> {
+            co_await limiter.acquire(2);
+            order.push_back(1);
+        });
+        auto gen2 = run([&]() -> Ichor::Task<void> {
+            co_await limiter.acquire();
+            order.push_back(2);
+        });
+        auto it1 = gen1.begin();
+        auto it2 = gen2.begin();
+
+        // the second waiter does not overtake the first
+        factory.timer.fire();
+        CHECK(order.empty());
+        CHECK(limiter.available() == 0);
+
+        factory.timer.fire();
+        CHECK(order == std::vector<int>{1});
+
+        factory.timer.fire();
+        CHECK(order == std::vector<int>{1, 2});
+        CHECK(factory.timer.running());
+    }
+}
@@ -0,0 +1,140 @@
+#include "Common.h"
+#include <ichor/coroutines/AsyncSemaphore.h>
+#include <ichor/coroutines/AsyncMutex.h>
+#include <ichor/event_queues/MultimapQueue.h>
+#include <ichor/events/RunFunctionEvent.h>
+
+template<typename F>
+Ichor::AsyncGenerator<void> run(F f) {
+    co_await f();
+    co_return;
+}
+
+TEST_CASE("AsyncSemaphoreTests") {
+
+    SECTION("acquire does not suspend while permits are available")
+    {
+        Ichor::AsyncSemaphore semaphore{2};
+        uint32_t acquired{};
+        auto gen = run([&]() -> Ichor::Task<void> {
+            co_await semaphore.acquire();
+            acquired++;
+            co_await semaphore.acquire();
+            acquired++;
+        });
+        auto it = gen.begin();
+        CHECK(it.get_finished());
+        CHECK(acquired == 2);
+        CHECK(semaphore.available() == 0);
+        CHECK(!semaphore.tryAcquire());
+    }
+
+    SECTION("release resumes waiters in order")
+    {
+        Ichor::AsyncSemaphore semaphore{0};
+        std::vector<int> order;
+        auto gen1 = run([&]() -> Ichor::Task<void> {
+            co_await semaphore.acquire();
+            order.push_back(1);
+        });
+        auto gen2 = run([&]() -> Ichor::Task<void> {
+            co_await semaphore.acquire();
+            order.push_back(2);
+        });
+        auto it1 = gen1.begin();
+        auto it2 = gen2.begin();
+        CHECK(order.empty());
+
+        // waiters come first
+        semaphore.release();
+        CHECK(!semaphore.tryAcquire());
+        CHECK(order == std::vector<int>{1});
+
+        semaphore.release(2);
+        CHECK(order == std::vector<int>{1, 2});
+        CHECK(semaphore.available() == 1);
+        CHECK(semaphore.tryAcquire());
+    }
+
+    SECTION("mutex serialises coroutines")
+    {
+        Ichor::AsyncMutex mutex;
+        Ichor::AsyncManualResetEvent evt;
+        std::vector<int> order;
+        auto gen1 = run([&]() -> Ichor::Task<void> {
+            auto lock = co_await mutex.lock();
+            order.push_back(1);
+            co_await evt;
+            order.push_back(2);
+        });
+        auto gen2 = run([&]() -> Ichor::Task<void> {
+            auto lock = co_await mutex.lock();
+            order.push_back(3);
+        });
+        auto it1 = gen1.begin();
+        auto it2 = gen2.begin();
+        CHECK(mutex.isLocked());
+        CHECK(!mutex.tryLock());
+        CHECK(order == std::vector<int>{1});
+
+        evt.set();
+        CHECK(order == std::vector<int>{1, 2, 3});
+        CHECK(!mutex.isLocked());
+
+        auto lock = mutex.tryLock();
+        REQUIRE(lock);
+        CHECK(mutex.isLocked());
+        lock->unlock();
+        CHECK(!mutex.isLocked());
+    }
+
+    SECTION("cross-thread mutex between managers")
+    {
+        constexpr uint32_t iterations = 1'000;
+        Ichor::AsyncCrossThreadMutex mutex;
+        uint64_t counter{};
+        std::atomic<uint32_t> finished{};
+
+        auto queue1 = std::make_unique<MultimapQueue>();
+        auto &dm1 = queue1->createManager();
+        auto queue2 = std::make_unique<MultimapQueue>();
+        auto &dm2 = queue2->createManager();
+
+        auto increment = [&]() -> AsyncGenerator<IchorBehaviour> {
+            for(uint32_t i = 0; i < iterations; i++) {
+                auto lock = co_await mutex.lock();
+                counter++;
+            }
+            finished++;
+            co_return {};
+        };
+
+        std::thread t1([&]() {
+            dm1.createServiceManager<CoutFrameworkLogger, IFrameworkLogger>();
+            queue1->start(CaptureSigInt);
+        });
+        std::thread t2([&]() {
+            dm2.createServiceManager<CoutFrameworkLogger, IFrameworkLogger>();
+            queue2->start(CaptureSigInt);
+        });
+
+        waitForRunning(dm1);
+        waitForRunning(dm2);
+
+        queue1->pushEvent<RunFunctionEventAsync>(0, increment);
+        queue2->pushEvent<RunFunctionEventAsync>(0, increment);
+
+        while(finished.load() != 2) {
+            std::this_thread::sleep_for(1ms);
+        }
+
+        queue1->pushEvent<QuitEvent>(0);
+        queue2->pushEvent<QuitEvent>(0);
+
+        t1.join();
+        t2.join();
+
+        CHECK(counter == 2 * iterations);
+        CHECK(!mutex.isLocked());
+    }
+}
@@ -0,0 +1,76 @@
+#include "Common.h"
+#include <ichor/coroutines/CancellationToken.h>
+
+TEST_CASE("CancellationTokenTests") {
+
+    SECTION("default constructed token cannot be cancelled")
+    {
+        Ichor::CancellationToken token;
+        CHECK(!token.canBeCancelled());
+        CHECK(!token.isCancellationRequested());
+
+        bool called{};
+        Ichor::CancellationRegistration registration{token, [&called]() { called = true; }};
+        CHECK(!called);
+    }
+
+    SECTION("requesting cancellation runs registrations")
+    {
+        Ichor::CancellationSource source;
+        auto token = source.getToken();
+        CHECK(token.canBeCancelled());
+        CHECK(!token.isCancellationRequested());
+
+        uint32_t calls{};
+        Ichor::CancellationRegistration registration{token, [&calls]() { calls++; }};
+        Ichor::CancellationRegistration registration2{token, [&calls]() { calls++; }};
+        CHECK(calls == 0);
+
+        source.requestCancellation();
+        CHECK(calls == 2);
+        CHECK(token.isCancellationRequested());
+        CHECK(source.isCancellationRequested());
+
+        source.requestCancellation();
+        CHECK(calls == 2);
+    }
+
+    SECTION("registering after cancellation runs immediately")
+    {
+        Ichor::CancellationSource source;
+        source.requestCancellation();
+
+        bool called{};
+        Ichor::CancellationRegistration registration{source.getToken(), [&called]() { called = true; }};
+        CHECK(called);
+    }
+
+    SECTION("destroyed registrations are not run")
+    {
+        Ichor::CancellationSource source;
+        bool called{};
+        {
+            Ichor::CancellationRegistration registration{source.getToken(), [&called]() { called = true; }};
+        }
+        source.requestCancellation();
+        CHECK(!called);
+    }
+
+    SECTION("callbacks can destroy registrations")
+    {
+        Ichor::CancellationSource source;
+        bool secondCalled{};
+        auto second = std::make_unique<Ichor::CancellationRegistration>(source.getToken(), [&secondCalled]() { secondCalled = true; });
+        std::unique_ptr<Ichor::CancellationRegistration> first;
+        first = std::make_unique<Ichor::CancellationRegistration>(source.getToken(), [&]() {
+            second.reset();
+            first.reset();
+        });
+
+        // second was registered first, so it runs before first gets to destroy it
+        source.requestCancellation();
+        CHECK(secondCalled);
+        CHECK(first == nullptr);
+        CHECK(second == nullptr);
+    }
+}
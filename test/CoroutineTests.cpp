@@ -7,6 +7,7 @@
 #include "TestServices/StopsInAsyncStartService.h"
 #include "TestServices/DependencyOfflineWhileStartingService.h"
 #include "TestServices/DependencyOnlineWhileStoppingService.h"
+#include "TestServices/TimeoutService.h"
 #include <ichor/event_queues/MultimapQueue.h>
 #include <ichor/events/RunFunctionEvent.h>
 #include <ichor/services/timer/TimerFactoryFactory.h>
@@ -18,6 +19,13 @@ uint64_t AwaitNoCopy::countConstructed{};
 uint64_t AwaitNoCopy::countDestructed{};
 uint64_t AwaitNoCopy::countMoved{};
 
+static Ichor::Task<uint64_t> countDown(uint64_t n) {
+    if(n == 0) {
+        co_return 0;
+    }
+    co_return 1 + co_await countDown(n - 1);
+}
+
 TEST_CASE("CoroutineTests") {
     _evt = std::make_unique<Ichor::AsyncManualResetEvent>();
 
@@ -350,5 +358,149 @@ TEST_CASE("CoroutineTests") {
         REQUIRE_FALSE(dm.isRunning());
     }
 
+    SECTION("co_await cross-thread event") {
+        auto queue = std::make_unique<MultimapQueue>();
+        auto &dm = queue->createManager();
+        AsyncCrossThreadEvent evt{};
+        std::atomic<uint64_t> waiting{};
+        std::atomic<uint64_t> resumed{};
+        std::thread::id dmThreadId{};
+        std::thread::id resumedThreadId{};
+
+        std::thread t([&]() {
+            dm.createServiceManager<CoutFrameworkLogger, IFrameworkLogger>();
+            queue->start(CaptureSigInt);
+        });
+
+        waitForRunning(dm);
+
+        for(uint64_t i = 0; i < 2; i++) {
+            queue->pushEvent<RunFunctionEventAsync>(0, [&]() -> AsyncGenerator<IchorBehaviour> {
+                dmThreadId = std::this_thread::get_id();
+                waiting++;
+                co_await evt;
+                resumedThreadId = std::this_thread::get_id();
+                if(++resumed == 2) {
+                    dm.getEventQueue().pushEvent<QuitEvent>(0);
+                }
+                co_return {};
+            });
+        }
+
+        while(waiting.load() != 2) {
+            std::this_thread::sleep_for(1ms);
+        }
+
+        // set from a thread without a manager, awaiting coroutines have to be resumed on the manager's thread
+        evt.set();
+
+        t.join();
+
+        REQUIRE(resumed == 2);
+        REQUIRE(resumedThreadId == dmThreadId);
+        REQUIRE(evt.is_set());
+        REQUIRE_FALSE(dm.isRunning());
+    }
+
+    SECTION("withTimeout and service stop tokens") {
+        auto queue = std::make_unique<MultimapQueue>();
+        auto &dm = queue->createManager();
+        TimeoutService *svc{};
+
+        std::thread t([&]() {
+            dm.createServiceManager<CoutFrameworkLogger, IFrameworkLogger>();
+            dm.createServiceManager<TimerFactoryFactory>();
+            svc = dm.createServiceManager<TimeoutService>();
+            queue->start(CaptureSigInt);
+        });
+
+        waitForRunning(dm);
+
+        while(!svc->waitingForStop.load()) {
+            std::this_thread::sleep_for(1ms);
+        }
+
+        REQUIRE(svc->timedOut);
+        REQUIRE(svc->completedValue == 5);
+        REQUIRE(svc->lateValue == 7);
+
+        queue->pushEvent<StopServiceEvent>(0, svc->getServiceId());
+
+        while(!svc->cancelledByStop.load()) {
+            std::this_thread::sleep_for(1ms);
+        }
+
+        queue->pushEvent<QuitEvent>(0);
+
+        t.join();
+
+        REQUIRE_FALSE(dm.isRunning());
+    }
+
+    SECTION("Deep task chains run in constant stack space") {
+        // every task completes synchronously, resuming the awaiting coroutine on top of the finished one would overflow the stack
+#ifdef ICHOR_TESTS_GUARANTEED_TAIL_CALLS
+        constexpr uint64_t count = 1'000'000;
+#else
+        // symmetric transfer is only guaranteed to be a tail call at -O2 and higher without instrumentation, see test/CMakeLists.txt
+        constexpr uint64_t count = 1'000;
+#endif
+        auto one = []() -> Ichor::Task<uint64_t> { co_return 1; };
+        uint64_t sum{};
+        uint64_t depth{};
+        auto run = [&]() -> Ichor::AsyncGenerator<void> {
+            for(uint64_t i = 0; i < count; i++) {
+                sum += co_await one();
+            }
+            depth = co_await countDown(count);
+            co_return;
+        };
+
+        auto gen = run();
+        auto it = gen.begin();
+        REQUIRE(it.get_finished());
+        REQUIRE(sum == count);
+        REQUIRE(depth == count);
+    }
+
+#ifdef ICHOR_USE_COROUTINE_FRAME_POOL
+    SECTION("Coroutine frame pool") {
+        auto makeTask = []() -> Ichor::Task<void> { co_return; };
+
+        std::thread t([&]() {
+            {
+                auto task = makeTask();
+            }
+            {
+                auto task = makeTask();
+            }
+
+            auto stats = Ichor::Detail::getCoroutineFramePoolStats();
+            REQUIRE(stats.allocations == 2);
+            REQUIRE(stats.hits == 1);
+            REQUIRE(stats.outstandingFrames == 0);
+            REQUIRE(stats.highWaterFrames == 1);
+            REQUIRE(stats.cachedBytes > 0);
+
+            // frame freed on another thread goes back to this thread's pool
+            auto task = std::make_unique<Ichor::Task<void>>(makeTask());
+            std::thread other([&]() {
+                task.reset();
+            });
+            other.join();
+
+            REQUIRE(Ichor::Detail::getCoroutineFramePoolStats().outstandingFrames == 1);
+            {
+                auto task2 = makeTask();
+            }
+            stats = Ichor::Detail::getCoroutineFramePoolStats();
+            REQUIRE(stats.remoteFrees == 1);
+            REQUIRE(stats.hits == 3);
+            REQUIRE(stats.outstandingFrames == 0);
+        });
+        t.join();
+    }
+#endif
+
     _evt.reset();
 }
@@ -1,10 +1,20 @@
 #include <ichor/event_queues/MultimapQueue.h>
 #include <ichor/events/RunFunctionEvent.h>
 #include <ichor/coroutines/AsyncManualResetEvent.h>
+#include <ichor/dependency_management/ParallelServiceCreator.h>
 #include "TestServices/UselessService.h"
 #include "TestServices/RegistrationCheckerService.h"
+#include "TestServices/DependencyService.h"
 #include "Common.h"
 
+struct GraphConstructorService final {
+    GraphConstructorService(ICountService *countSvc) {
+        if(countSvc == nullptr || !countSvc->isRunning()) {
+            std::terminate();
+        }
+    }
+};
+
 TEST_CASE("DependencyManager") {
     SECTION("DependencyManager", "QuitOnQuitEvent") {
         auto queue = std::make_unique<MultimapQueue>();
@@ -79,6 +89,74 @@ TEST_CASE("DependencyManager") {
             auto startedSvc = dm.getStartedServices<IUselessService>();
             REQUIRE(startedSvc.size() == 2);
 
+            uint64_t found{};
+            for(auto [intf, isvc] : uselessSvcs) {
+                auto byId = dm.getService<IUselessService>(isvc.getServiceId());
+                REQUIRE(byId.has_value());
+                REQUIRE(byId->first == &intf);
+                found += isvc.getServiceId() == uselessSvcId ? 1 : 0;
+            }
+            REQUIRE(found == 1);
+            REQUIRE(dm.getStartedServices<ICountService>().empty());
+            REQUIRE_FALSE(dm.getService<ICountService>(uselessSvcId).has_value());
+
+            // stopping a service removes it from the started services
+            dm.getEventQueue().pushEvent<StopServiceEvent>(0, uselessSvcId);
+        });
+
+        dm.runForOrQueueEmpty();
+
+        queue->pushEvent<RunFunctionEvent>(0, [&]() {
+            REQUIRE(dm.getStartedServices<IUselessService>().size() == 1);
+            REQUIRE(dm.getAllServicesOfType<IUselessService>().size() == 2);
+
+            queue->pushEvent<QuitEvent>(0);
+        });
+
+        t.join();
+
+        REQUIRE_FALSE(dm.isRunning());
+    }
+
+    SECTION("DependencyManager", "Ids of removed services are not found") {
+        auto queue = std::make_unique<MultimapQueue>();
+        auto &dm = queue->createManager();
+        uint64_t removedSvcId{};
+        uint64_t newSvcId{};
+
+        std::thread t([&]() {
+            dm.createServiceManager<CoutFrameworkLogger, IFrameworkLogger>();
+            removedSvcId = dm.createServiceManager<UselessService, IUselessService>()->getServiceId();
+            queue->start(CaptureSigInt);
+        });
+
+        waitForRunning(dm);
+
+        dm.runForOrQueueEmpty();
+
+        queue->pushEvent<RunFunctionEvent>(0, [&]() {
+            dm.getEventQueue().pushEvent<StopServiceEvent>(0, removedSvcId);
+            dm.getEventQueue().pushPrioritisedEvent<RemoveServiceEvent>(0, INTERNAL_EVENT_PRIORITY + 11, removedSvcId);
+        });
+
+        dm.runForOrQueueEmpty();
+
+        queue->pushEvent<RunFunctionEvent>(0, [&]() {
+            REQUIRE_FALSE(dm.getIService(removedSvcId).has_value());
+            newSvcId = dm.createServiceManager<UselessService, IUselessService>()->getServiceId();
+        });
+
+        dm.runForOrQueueEmpty();
+
+        queue->pushEvent<RunFunctionEvent>(0, [&]() {
+            // the slot of the removed service is reused with a newer generation
+            REQUIRE(Detail::serviceIdSlot(newSvcId) == Detail::serviceIdSlot(removedSvcId));
+            REQUIRE(Detail::serviceIdGeneration(newSvcId) > Detail::serviceIdGeneration(removedSvcId));
+            REQUIRE_FALSE(dm.getIService(removedSvcId).has_value());
+            REQUIRE_FALSE(dm.getService<IUselessService>(removedSvcId).has_value());
+            REQUIRE(dm.getIService(newSvcId).has_value());
+            REQUIRE(dm.getService<IUselessService>(newSvcId).has_value());
+
             queue->pushEvent<QuitEvent>(0);
         });
 
@@ -137,4 +215,238 @@ TEST_CASE("DependencyManager") {
 
         REQUIRE_FALSE(dm.isRunning());
     }
+
+    SECTION("DependencyManager", "Service graph") {
+        using CountNode = GraphService<DependencyService<true>, InterfacesList_t<ICountService>, RequiredList_t<IUselessService>>;
+        using UselessNode = GraphService<UselessService, InterfacesList_t<IUselessService>>;
+        using Graph = ServiceGraph<GraphService<GraphConstructorService, InterfacesList_t<>, RequiredList_t<ICountService>>, CountNode, UselessNode>;
+
+        static_assert(Graph::error == ServiceGraphError::NONE);
+        static_assert(Graph::startOrder == std::array<size_t, 3>{2, 1, 0});
+        static_assert(ServiceGraph<CountNode>::error == ServiceGraphError::MISSING_PROVIDER);
+        static_assert(ServiceGraph<CountNode, UselessNode, UselessNode>::error == ServiceGraphError::AMBIGUOUS_PROVIDER);
+        static_assert(ServiceGraph<CountNode, GraphService<UselessService, InterfacesList_t<IUselessService>, RequiredList_t<ICountService>>>::error == ServiceGraphError::CYCLE);
+
+        auto queue = std::make_unique<MultimapQueue>();
+        auto &dm = queue->createManager();
+        std::array<uint64_t, 3> ids{};
+
+        std::thread t([&]() {
+            dm.createServiceManager<CoutFrameworkLogger, IFrameworkLogger>();
+            ids = dm.createServiceGraph<Graph>();
+            queue->start(CaptureSigInt);
+        });
+
+        waitForRunning(dm);
+
+        dm.runForOrQueueEmpty();
+
+        queue->pushEvent<RunFunctionEvent>(0, [&]() {
+            for(auto id : ids) {
+                auto svc = dm.getIService(id);
+                REQUIRE(svc.has_value());
+                REQUIRE(svc.value()->getServiceState() == ServiceState::ACTIVE);
+            }
+
+            auto countSvcs = dm.getStartedServices<ICountService>();
+            REQUIRE(countSvcs.size() == 1);
+            REQUIRE(countSvcs[0]->getSvcCount() == 1);
+
+            // dynamic services can still depend on graph services
+            dm.createServiceManager<DependencyService<true>, ICountService>();
+        });
+
+        dm.runForOrQueueEmpty();
+
+        queue->pushEvent<RunFunctionEvent>(0, [&]() {
+            auto countSvcs = dm.getStartedServices<ICountService>();
+            REQUIRE(countSvcs.size() == 2);
+            for(auto svc : countSvcs) {
+                REQUIRE(svc->getSvcCount() == 1);
+            }
+
+            queue->pushEvent<QuitEvent>(0);
+        });
+
+        t.join();
+
+        REQUIRE_FALSE(dm.isRunning());
+    }
+
+    SECTION("DependencyManager", "Parallel service creation") {
+        auto queue = std::make_unique<MultimapQueue>();
+        auto &dm = queue->createManager();
+        std::vector<uint64_t> ids{};
+
+        std::thread t([&]() {
+            ParallelServiceCreator creator{dm};
+            creator.add<CoutFrameworkLogger, IFrameworkLogger>();
+            creator.add<GraphConstructorService>();
+            creator.add<DependencyService<true>, ICountService>();
+            for(uint32_t i = 0; i < 8; i++) {
+                creator.add<UselessService, IUselessService>();
+            }
+            ids = creator.create(4);
+            queue->start(CaptureSigInt);
+        });
+
+        waitForRunning(dm);
+
+        dm.runForOrQueueEmpty();
+
+        queue->pushEvent<RunFunctionEvent>(0, [&]() {
+            REQUIRE(ids.size() == 11);
+            REQUIRE(dm.getLogger() != nullptr);
+            for(auto id : ids) {
+                auto svc = dm.getIService(id);
+                REQUIRE(svc.has_value());
+                REQUIRE(svc.value()->getServiceState() == ServiceState::ACTIVE);
+            }
+
+            auto countSvcs = dm.getStartedServices<ICountService>();
+            REQUIRE(countSvcs.size() == 1);
+            REQUIRE(countSvcs[0]->getSvcCount() == 8);
+
+            queue->pushEvent<QuitEvent>(0);
+        });
+
+        t.join();
+
+        REQUIRE_FALSE(dm.isRunning());
+    }
+
+    SECTION("DependencyManager", "Dependency graph snapshot") {
+        auto createServices = [](DependencyManager &dm, bool withUseless) {
+            dm.createServiceManager<CoutFrameworkLogger, IFrameworkLogger>();
+            dm.createServiceManager<GraphConstructorService>();
+            dm.createServiceManager<DependencyService<true>, ICountService>();
+            if(withUseless) {
+                dm.createServiceManager<UselessService, IUselessService>();
+            }
+        };
+
+        std::string serialized{};
+        {
+            auto queue = std::make_unique<MultimapQueue>();
+            auto &dm = queue->createManager();
+
+            std::thread t([&]() {
+                createServices(dm, true);
+                queue->start(CaptureSigInt);
+            });
+
+            waitForRunning(dm);
+
+            dm.runForOrQueueEmpty();
+
+            queue->pushEvent<RunFunctionEvent>(0, [&]() {
+                auto snapshot = dm.createDependencyGraphSnapshot();
+                REQUIRE(snapshot.startOrder.size() == snapshot.services.size());
+                REQUIRE(snapshot.edges.size() == 2);
+
+                serialized = snapshot.serialize();
+                auto deserialized = DependencyGraphSnapshot::deserialize(serialized);
+                REQUIRE(deserialized.has_value());
+                REQUIRE(deserialized->serialize() == serialized);
+
+                queue->pushEvent<QuitEvent>(0);
+            });
+
+            t.join();
+        }
+
+        REQUIRE_FALSE(DependencyGraphSnapshot::deserialize("not a snapshot").has_value());
+
+        // replaying the snapshot, once with the same configuration and once with a mismatching one that falls back to normal resolution
+        for(bool withUseless : {true, false}) {
+            auto queue = std::make_unique<MultimapQueue>();
+            auto &dm = queue->createManager();
+
+            std::thread t([&]() {
+                createServices(dm, withUseless);
+                dm.replayDependencyGraphSnapshot(DependencyGraphSnapshot::deserialize(serialized).value());
+                queue->start(CaptureSigInt);
+            });
+
+            waitForRunning(dm);
+
+            dm.runForOrQueueEmpty();
+
+            queue->pushEvent<RunFunctionEvent>(0, [&]() {
+                auto countSvcs = dm.getStartedServices<ICountService>();
+                REQUIRE(countSvcs.size() == (withUseless ? 1 : 0));
+                if(withUseless) {
+                    REQUIRE(countSvcs[0]->getSvcCount() == 1);
+                    REQUIRE(dm.getStartedServices<IUselessService>().size() == 1);
+                }
+
+                queue->pushEvent<QuitEvent>(0);
+            });
+
+            t.join();
+        }
+    }
+
+    SECTION("DependencyManager", "Compiled filters") {
+        struct ScopeEntry final {
+            [[nodiscard]] bool matches(ILifecycleManager const &manager) const noexcept {
+                auto const scopeProp = manager.getProperties().find("scope");
+                return scopeProp != cend(manager.getProperties()) && Ichor::any_cast<std::string const &>(scopeProp->second) == scope;
+            }
+
+            std::string scope;
+        };
+
+        auto mgr = Detail::LifecycleManager<UselessService>::create(Properties{{"scope", Ichor::make_any<std::string>("one")}, {"count", Ichor::make_any<uint64_t>(5u)}}, InterfacesList<IUselessService>);
+
+        Filter idFilter{ServiceIdFilterEntry{mgr->serviceId()}};
+        REQUIRE(idFilter.compareTo(*mgr));
+        REQUIRE(idFilter.selectedServiceId() == mgr->serviceId());
+        REQUIRE_FALSE(Filter{ServiceIdFilterEntry{mgr->serviceId() + 1}}.compareTo(*mgr));
+
+        Filter propFilter{PropertiesFilterEntry<uint64_t>{"count", 5u}};
+        REQUIRE(propFilter.compareTo(*mgr));
+        REQUIRE_FALSE(propFilter.selectedServiceId().has_value());
+        REQUIRE_FALSE(Filter{PropertiesFilterEntry<uint64_t>{"count", 6u}}.compareTo(*mgr));
+        REQUIRE_FALSE(Filter{PropertiesFilterEntry<uint32_t>{"count", 5u}}.compareTo(*mgr));
+        REQUIRE_FALSE(Filter{PropertiesFilterEntry<uint64_t>{"missing", 5u}}.compareTo(*mgr));
+
+        REQUIRE(Filter{ScopeEntry{"one"}}.compareTo(*mgr));
+        REQUIRE_FALSE(Filter{ScopeEntry{"two"}}.compareTo(*mgr));
+
+        Filter combined{ServiceIdFilterEntry{mgr->serviceId()}, PropertiesFilterEntry<std::string>{"scope", "one"}, ScopeEntry{"one"}};
+        auto combinedCopy = combined;
+        REQUIRE(combinedCopy.compareTo(*mgr));
+        REQUIRE_FALSE(Filter{ServiceIdFilterEntry{mgr->serviceId()}, ScopeEntry{"two"}}.compareTo(*mgr));
+
+        PropertyKey key{"count"};
+        REQUIRE(key == PropertyKey{"count"});
+        REQUIRE_FALSE(key == PropertyKey{"scope"});
+        REQUIRE(mgr->getProperties().find(key) != mgr->getProperties().end());
+    }
+
+    SECTION("DependencyManager", "Property keys of filters are interned ids") {
+        // keys only hold an id and a view of the interned name, never a copy of the name
+        static_assert(std::is_trivially_copyable_v<PropertyKey>);
+        static_assert(sizeof(PropertyKey) <= sizeof(std::string_view) + sizeof(uint64_t));
+
+        std::string const runtimeName = std::string{"filter."} + "count";
+        PropertyKey const key{"filter.count"};
+        PropertyKey const runtimeKey{runtimeName};
+        REQUIRE(runtimeKey.id() == key.id());
+        REQUIRE(runtimeKey.name().data() == key.name().data());
+        REQUIRE(runtimeKey.name().data() != runtimeName.data());
+
+        PropertiesFilterEntry<uint64_t> const entry{runtimeName, 5u};
+        REQUIRE(entry.key.id() == key.id());
+        REQUIRE(entry.key.name().data() == key.name().data());
+
+        Properties const props{{"filter.count", Ichor::make_any<uint64_t>(5u)}};
+        REQUIRE(props.begin()->first.id() == key.id());
+
+        // looking up names never interns them
+        REQUIRE_FALSE(PropertyKey::findInterned("filter.never.inserted").has_value());
+        REQUIRE_FALSE(props.contains("filter.never.inserted"));
+        REQUIRE_FALSE(PropertyKey::findInterned("filter.never.inserted").has_value());
+    }
 }
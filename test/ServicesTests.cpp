@@ -5,7 +5,10 @@
 #include "TestServices/DependencyService.h"
 #include "TestServices/MixingInterfacesService.h"
 #include "TestServices/TimerRunsOnceService.h"
+#include "TestServices/ManyTimersService.h"
+#include "TestServices/MissedTicksService.h"
 #include "TestServices/AddEventHandlerDuringEventHandlingService.h"
+#include "TestServices/EventHandlerService.h"
 #include "TestServices/RequestsLoggingService.h"
 #include "TestServices/ConstructorInjectionTestServices.h"
 #include <ichor/event_queues/MultimapQueue.h>
@@ -234,6 +237,108 @@ TEST_CASE("ServicesTests") {
         t.join();
     }
 
+    SECTION("Many timers share the manager's event loop") {
+        auto queue = std::make_unique<MultimapQueue>();
+        auto &dm = queue->createManager();
+        uint64_t svcId{};
+
+        std::thread t([&]() {
+            dm.createServiceManager<CoutFrameworkLogger, IFrameworkLogger>();
+            svcId = dm.createServiceManager<ManyTimersService, IManyTimersService>()->getServiceId();
+            dm.createServiceManager<TimerFactoryFactory>();
+            queue->start(CaptureSigInt);
+        });
+
+        waitForRunning(dm);
+
+        std::atomic<IManyTimersService*> svcPtr{};
+        while(svcPtr.load() == nullptr) {
+            queue->pushEvent<RunFunctionEvent>(0, [&]() {
+                auto ret = dm.getService<IManyTimersService>(svcId);
+                if(ret) {
+                    svcPtr.store(ret->first);
+                }
+            });
+            std::this_thread::sleep_for(1ms);
+        }
+        auto *svc = svcPtr.load();
+
+        constexpr uint64_t expected = ManyTimersService::timerCount * ManyTimersService::firesPerTimer;
+        while(svc->getFired() < expected) {
+            std::this_thread::sleep_for(1ms);
+        }
+
+        // started and stopped from a thread other than the manager's
+        auto &remoteTimer = svc->getRemoteTimer();
+        remoteTimer.startTimer();
+        REQUIRE(remoteTimer.running());
+        while(svc->getRemoteFired() < 3) {
+            std::this_thread::sleep_for(1ms);
+        }
+        remoteTimer.stopTimer();
+        REQUIRE_FALSE(remoteTimer.running());
+
+        // give stopped timers the chance to misbehave
+        std::this_thread::sleep_for(20ms);
+        auto const remoteFired = svc->getRemoteFired();
+        std::this_thread::sleep_for(20ms);
+        REQUIRE(svc->getFired() == expected);
+        REQUIRE(svc->getRemoteFired() == remoteFired);
+
+        queue->pushEvent<QuitEvent>(0);
+
+        t.join();
+    }
+
+    SECTION("Missed timer expiries follow the timer's policy") {
+        auto queue = std::make_unique<MultimapQueue>();
+        auto &dm = queue->createManager();
+        uint64_t svcId{};
+
+        std::thread t([&]() {
+            dm.createServiceManager<CoutFrameworkLogger, IFrameworkLogger>();
+            svcId = dm.createServiceManager<MissedTicksService, IMissedTicksService>()->getServiceId();
+            dm.createServiceManager<TimerFactoryFactory>();
+            queue->start(CaptureSigInt);
+        });
+
+        waitForRunning(dm);
+
+        std::atomic<IMissedTicksService*> svcPtr{};
+        while(svcPtr.load() == nullptr) {
+            queue->pushEvent<RunFunctionEvent>(0, [&]() {
+                auto ret = dm.getService<IMissedTicksService>(svcId);
+                if(ret) {
+                    svcPtr.store(ret->first);
+                }
+            });
+            std::this_thread::sleep_for(1ms);
+        }
+        auto *svc = svcPtr.load();
+
+        while(!svc->done()) {
+            std::this_thread::sleep_for(1ms);
+        }
+
+        // The event loop was blocked for ten intervals. CATCH_UP ran the callback for every one of them, FIRE_ONCE once for all
+        // of them together and SKIP not at all, it continued with the next expiry on the schedule.
+        auto const fireOnce = svc->getFired(TimerMissedTickPolicy::FIRE_ONCE);
+        auto const skip = svc->getFired(TimerMissedTickPolicy::SKIP);
+        REQUIRE(svc->getFired(TimerMissedTickPolicy::CATCH_UP) == MissedTicksService::catchUpFires);
+        REQUIRE(svc->getEarlyFires() == 0);
+        REQUIRE(fireOnce >= 1);
+        REQUIRE(fireOnce + 5 < MissedTicksService::catchUpFires);
+        REQUIRE(skip >= 1);
+        REQUIRE(skip < fireOnce);
+        // a single event replays the missed expiries of the async callback
+        REQUIRE(svc->getAsyncCatchUpFired() > fireOnce);
+        REQUIRE(svc->getAsyncCatchUpFired() <= MissedTicksService::catchUpFires);
+
+        queue->pushEvent<QuitEvent>(0);
+
+        t.join();
+    }
+
     SECTION("Add event handler during event handling") {
         auto queue = std::make_unique<MultimapQueue>();
         auto &dm = queue->createManager();
@@ -258,6 +363,123 @@ TEST_CASE("ServicesTests") {
         t.join();
     }
 
+    SECTION("Synchronous event handlers") {
+        auto queue = std::make_unique<MultimapQueue>();
+        auto &dm = queue->createManager();
+        IEventHandlerService *voidHandler{};
+        IEventHandlerService *stoppingHandler{};
+        IEventHandlerService *asyncHandler{};
+
+        std::thread t([&]() {
+            dm.createServiceManager<CoutFrameworkLogger, IFrameworkLogger>();
+            voidHandler = dm.createServiceManager<SyncEventHandlerService<TestEvent, void>, IEventHandlerService>();
+            stoppingHandler = dm.createServiceManager<SyncEventHandlerService<TestEvent, bool>, IEventHandlerService>();
+            asyncHandler = dm.createServiceManager<EventHandlerService<TestEvent>, IEventHandlerService>();
+            queue->start(CaptureSigInt);
+        });
+
+        waitForRunning(dm);
+
+        dm.runForOrQueueEmpty();
+
+        queue->pushEvent<TestEvent>(0);
+
+        dm.runForOrQueueEmpty();
+
+        queue->pushEvent<RunFunctionEvent>(0, [&]() {
+            REQUIRE(voidHandler->getHandledEvents()[TestEvent::TYPE] == 1);
+            REQUIRE(stoppingHandler->getHandledEvents()[TestEvent::TYPE] == 1);
+            // registered after the handler returning false
+            REQUIRE(asyncHandler->getHandledEvents().empty());
+
+            dm.getEventQueue().pushEvent<QuitEvent>(0);
+        });
+
+        t.join();
+    }
+
+    SECTION("Targeted event handlers") {
+        auto queue = std::make_unique<MultimapQueue>();
+        auto &dm = queue->createManager();
+        uint64_t targetId{};
+        IEventHandlerService *targetedHandler{};
+        IEventHandlerService *otherTargetedHandler{};
+        IEventHandlerService *allHandler{};
+
+        std::thread t([&]() {
+            dm.createServiceManager<CoutFrameworkLogger, IFrameworkLogger>();
+            targetId = dm.createServiceManager<UselessService, IUselessService>()->getServiceId();
+            targetedHandler = dm.createServiceManager<TargetedEventHandlerService<TestEvent>, IEventHandlerService>(Properties{{"TargetServiceId", Ichor::make_any<uint64_t>(targetId)}});
+            otherTargetedHandler = dm.createServiceManager<TargetedEventHandlerService<TestEvent>, IEventHandlerService>(Properties{{"TargetServiceId", Ichor::make_any<uint64_t>(targetId + 1000)}});
+            allHandler = dm.createServiceManager<EventHandlerService<TestEvent>, IEventHandlerService>();
+            queue->start(CaptureSigInt);
+        });
+
+        waitForRunning(dm);
+
+        dm.runForOrQueueEmpty();
+
+        queue->pushEvent<TestEvent>(targetId);
+        queue->pushEvent<TestEvent>(0);
+
+        dm.runForOrQueueEmpty();
+
+        queue->pushEvent<RunFunctionEvent>(0, [&]() {
+            REQUIRE(targetedHandler->getHandledEvents()[TestEvent::TYPE] == 1);
+            REQUIRE(otherTargetedHandler->getHandledEvents().empty());
+            REQUIRE(allHandler->getHandledEvents()[TestEvent::TYPE] == 2);
+
+            dm.getEventQueue().pushEvent<QuitEvent>(0);
+        });
+
+        t.join();
+    }
+
+    SECTION("Targeted and untargeted event handlers are called in registration order") {
+        auto queue = std::make_unique<MultimapQueue>();
+        auto &dm = queue->createManager();
+        uint64_t firstTargetId{};
+        uint64_t secondTargetId{};
+        IEventHandlerService *allHandler{};
+        IEventHandlerService *stoppingTargetedHandler{};
+        IEventHandlerService *stoppingHandler{};
+        IEventHandlerService *targetedHandler{};
+
+        std::thread t([&]() {
+            dm.createServiceManager<CoutFrameworkLogger, IFrameworkLogger>();
+            firstTargetId = dm.createServiceManager<UselessService, IUselessService>()->getServiceId();
+            secondTargetId = dm.createServiceManager<UselessService, IUselessService>()->getServiceId();
+            allHandler = dm.createServiceManager<EventHandlerService<TestEvent>, IEventHandlerService>();
+            stoppingTargetedHandler = dm.createServiceManager<TargetedEventHandlerService<TestEvent, bool>, IEventHandlerService>(Properties{{"TargetServiceId", Ichor::make_any<uint64_t>(firstTargetId)}});
+            stoppingHandler = dm.createServiceManager<SyncEventHandlerService<TestEvent, bool>, IEventHandlerService>();
+            targetedHandler = dm.createServiceManager<TargetedEventHandlerService<TestEvent>, IEventHandlerService>(Properties{{"TargetServiceId", Ichor::make_any<uint64_t>(secondTargetId)}});
+            queue->start(CaptureSigInt);
+        });
+
+        waitForRunning(dm);
+
+        dm.runForOrQueueEmpty();
+
+        queue->pushEvent<TestEvent>(firstTargetId);
+        queue->pushEvent<TestEvent>(secondTargetId);
+
+        dm.runForOrQueueEmpty();
+
+        queue->pushEvent<RunFunctionEvent>(0, [&]() {
+            // registered before both handlers returning false
+            REQUIRE(allHandler->getHandledEvents()[TestEvent::TYPE] == 2);
+            // stops the event of the first target before it reaches the untargeted stoppingHandler registered after it
+            REQUIRE(stoppingTargetedHandler->getHandledEvents()[TestEvent::TYPE] == 1);
+            REQUIRE(stoppingHandler->getHandledEvents()[TestEvent::TYPE] == 1);
+            // registered after stoppingHandler, so it does not get the event of the second target
+            REQUIRE(targetedHandler->getHandledEvents().empty());
+
+            dm.getEventQueue().pushEvent<QuitEvent>(0);
+        });
+
+        t.join();
+    }
+
     SECTION("LoggerAdmin removes logger when service is gone") {
         auto queue = std::make_unique<MultimapQueue>();
         auto &dm = queue->createManager();
@@ -332,6 +554,70 @@ TEST_CASE("ServicesTests") {
         t.join();
     }
 
+    SECTION("Lazy services") {
+        // properties of the wrong type are ignored rather than thrown on
+        REQUIRE_FALSE(Detail::isLazy(Properties{{"Lazy", Ichor::make_any<std::string>("true")}}));
+        REQUIRE(Detail::lazyIdleTimeout(Properties{{"LazyIdleTimeout", Ichor::make_any<uint64_t>(20u)}}) == 0ms);
+
+        auto queue = std::make_unique<MultimapQueue>();
+        auto &dm = queue->createManager();
+        uint64_t lazyId{};
+        uint64_t countId{};
+
+        std::thread t([&]() {
+            dm.createServiceManager<LoggerFactory<CoutLogger>, ILoggerFactory>();
+            lazyId = dm.createServiceManager<UselessService, IUselessService>(Properties{{"Lazy", Ichor::make_any<bool>(true)}, {"LazyIdleTimeout", Ichor::make_any<std::chrono::milliseconds>(20ms)}})->getServiceId();
+            queue->start(CaptureSigInt);
+        });
+
+        waitForRunning(dm);
+
+        dm.runForOrQueueEmpty();
+
+        queue->pushEvent<RunFunctionEvent>(0, [&]() {
+            REQUIRE(dm.getIService(lazyId).value()->getServiceState() == ServiceState::INSTALLED);
+
+            countId = dm.createServiceManager<DependencyService<true>, ICountService>()->getServiceId();
+        });
+
+        dm.runForOrQueueEmpty();
+
+        queue->pushEvent<RunFunctionEvent>(0, [&]() {
+            REQUIRE(dm.getIService(lazyId).value()->getServiceState() == ServiceState::ACTIVE);
+            auto countSvcs = dm.getStartedServices<ICountService>();
+            REQUIRE(countSvcs.size() == 1);
+            REQUIRE(countSvcs[0]->getSvcCount() == 1);
+
+            dm.getEventQueue().pushEvent<StopServiceEvent>(0, countId);
+            // + 11 because the first stop triggers a dep offline event and inserts a new stop with 10 higher priority.
+            dm.getEventQueue().pushPrioritisedEvent<RemoveServiceEvent>(0, INTERNAL_EVENT_PRIORITY + 11, countId);
+        });
+
+        // stopped by the idle check once it has been without dependees for LazyIdleTimeout
+        std::atomic<bool> stoppedWhenIdle{};
+        while(!stoppedWhenIdle.load()) {
+            queue->pushEvent<RunFunctionEvent>(0, [&]() {
+                stoppedWhenIdle = dm.getIService(lazyId).value()->getServiceState() == ServiceState::INSTALLED;
+            });
+            dm.runForOrQueueEmpty();
+        }
+
+        queue->pushEvent<RunFunctionEvent>(0, [&]() {
+            // requesting it again reactivates it
+            dm.createServiceManager<DependencyService<true>, ICountService>();
+        });
+
+        dm.runForOrQueueEmpty();
+
+        queue->pushEvent<RunFunctionEvent>(0, [&]() {
+            REQUIRE(dm.getIService(lazyId).value()->getServiceState() == ServiceState::ACTIVE);
+
+            dm.getEventQueue().pushEvent<QuitEvent>(0);
+        });
+
+        t.join();
+    }
+
     SECTION("ConstructorInjectionQuitService") {
         std::thread t([]() {
             auto queue = std::make_unique<MultimapQueue>();
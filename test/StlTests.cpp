@@ -2,6 +2,9 @@
 #include <ichor/stl/RealtimeMutex.h>
 #include <ichor/stl/RealtimeReadWriteMutex.h>
 #include <ichor/stl/NeverAlwaysNull.h>
+#include <ichor/stl/TimingWheel.h>
+#include <random>
+#include <set>
 #include "TestServices/UselessService.h"
 
 using namespace Ichor;
@@ -67,6 +70,111 @@ TEST_CASE("STL Tests") {
 
     }
 
+    SECTION("Any small buffer") {
+        static_assert(sizeof(any) == 3 * sizeof(void*));
+        static_assert(Detail::any_stores_inline<uint64_t>);
+        static_assert(Detail::any_stores_inline<bool>);
+        static_assert(!Detail::any_stores_inline<std::string>);
+
+        auto someBool = make_any<bool>(true);
+        auto someString = make_any<std::string>("a string that is too long for small string optimization");
+        REQUIRE(someBool.type_hash() == typeNameHash<bool>());
+        REQUIRE(someBool.get_size() == sizeof(bool));
+        REQUIRE(someBool.type_name() == typeName<bool>());
+        REQUIRE(someString.get_size() == sizeof(std::string));
+
+        auto copiedBool = someBool;
+        auto copiedString = someString;
+        any_cast<bool&>(someBool) = false;
+        any_cast<std::string&>(someString) = "changed";
+        REQUIRE(any_cast<bool>(copiedBool));
+        REQUIRE(any_cast<std::string>(copiedString) == "a string that is too long for small string optimization");
+
+        copiedBool = copiedString;
+        REQUIRE(any_cast<std::string const &>(copiedBool) == "a string that is too long for small string optimization");
+        copiedString = std::move(someBool);
+        REQUIRE_FALSE(any_cast<bool>(copiedString));
+        REQUIRE_FALSE(someBool.has_value());
+
+        any noneAny;
+        auto copiedNoneAny = noneAny;
+        REQUIRE_FALSE(copiedNoneAny.has_value());
+        REQUIRE(copiedNoneAny.type_hash() == 0);
+        REQUIRE(copiedNoneAny.get_size() == 0);
+    }
+
+    SECTION("Properties sharing") {
+        Properties base{{"Address", make_any<std::string>("localhost")}, {"Port", make_any<uint16_t>(static_cast<uint16_t>(8001))}};
+        REQUIRE(base.size() == 2);
+        REQUIRE(base.contains("Address"));
+        REQUIRE(base.contains(PropertyKey{"Port"}));
+        REQUIRE(!base.contains("Filter"));
+
+        auto copy = base;
+        REQUIRE(copy.sharesStorageWith(base));
+
+        auto derived = base.with("Filter", make_any<uint64_t>(5u));
+        REQUIRE(derived.sharesStorageWith(base));
+        REQUIRE(derived.size() == 3);
+        REQUIRE(base.size() == 2);
+        REQUIRE(any_cast<uint64_t>(derived.find("Filter")->second) == 5u);
+        REQUIRE(any_cast<std::string const &>(derived.find(PropertyKey{"Address"})->second) == "localhost");
+
+        auto overridden = derived.with("Port", make_any<uint16_t>(static_cast<uint16_t>(8002)));
+        REQUIRE(overridden.size() == 3);
+        REQUIRE(any_cast<uint16_t>(overridden.find("Port")->second) == 8002);
+        REQUIRE(any_cast<uint16_t>(derived.find("Port")->second) == 8001);
+
+        uint64_t count{};
+        for(auto const &[key, val] : overridden) {
+            REQUIRE(overridden.contains(key));
+            count++;
+        }
+        REQUIRE(count == 3);
+
+        // modifying a shared set leaves the other sets untouched
+        copy["Address"] = make_any<std::string>("example.com");
+        REQUIRE(!copy.sharesStorageWith(base));
+        REQUIRE(any_cast<std::string const &>(base.find("Address")->second) == "localhost");
+        REQUIRE(any_cast<std::string const &>(derived.find("Address")->second) == "localhost");
+
+        REQUIRE(derived.emplace("Priority", make_any<uint64_t>(10u)).second);
+        REQUIRE(!derived.emplace("Priority", make_any<uint64_t>(11u)).second);
+        REQUIRE(derived.size() == 4);
+        REQUIRE(derived.erase("Filter") == 1);
+        REQUIRE(derived.size() == 3);
+        REQUIRE(!derived.contains("Filter"));
+        REQUIRE(base.size() == 2);
+    }
+
+    SECTION("Properties with runtime built keys") {
+        Properties props{};
+        for(uint64_t i = 0; i < 100; i++) {
+            props[fmt::format("runtime.key.{}", i)] = make_any<uint64_t>(i);
+        }
+        REQUIRE(props.size() == 100);
+
+        for(uint64_t i = 0; i < 100; i++) {
+            auto const name = fmt::format("runtime.key.{}", i);
+            REQUIRE(any_cast<uint64_t>(props.find(name)->second) == i);
+            REQUIRE(any_cast<uint64_t>(props.find(PropertyKey{name})->second) == i);
+        }
+        REQUIRE(!props.contains("runtime.key.100"));
+        REQUIRE(!props.contains(PropertyKey{"runtime.key.100"}));
+
+        auto derived = props.with(fmt::format("runtime.key.{}", 5), make_any<uint64_t>(500u));
+        REQUIRE(derived.size() == 100);
+        REQUIRE(any_cast<uint64_t>(derived.find("runtime.key.5")->second) == 500u);
+        REQUIRE(any_cast<uint64_t>(props.find("runtime.key.5")->second) == 5u);
+
+        for(uint64_t i = 0; i < 100; i += 2) {
+            REQUIRE(derived.erase(fmt::format("runtime.key.{}", i)) == 1);
+        }
+        REQUIRE(derived.size() == 50);
+        REQUIRE(!derived.contains("runtime.key.4"));
+        REQUIRE(derived.contains(PropertyKey{"runtime.key.5"}));
+    }
+
     SECTION("RealTimeMutex basics") {
         RealtimeMutex m;
         m.lock();
@@ -120,4 +228,158 @@ TEST_CASE("STL Tests") {
         REQUIRE(*p == 121);
         delete p;
     }
+
+    SECTION("TimingWheel expires entries at their deadline") {
+        Detail::TimingWheel wheel;
+        std::vector<uint64_t> deadlines{1, 63, 64, 65, 100, 4'095, 4'096, 300'000, (uint64_t{1} << 30) + 5, Detail::TimingWheel::maxDuration * 3 + 7};
+        std::vector<Detail::TimingWheelEntry> entries(deadlines.size());
+        for(std::size_t i = 0; i < entries.size(); i++) {
+            wheel.insert(entries[i], deadlines[i]);
+        }
+        REQUIRE(wheel.size() == entries.size());
+
+        std::vector<uint64_t> fired;
+        auto onExpired = [&](Detail::TimingWheelEntry &entry) {
+            REQUIRE_FALSE(entry.isScheduled());
+            fired.push_back(entry.deadline);
+        };
+
+        for(auto deadline : deadlines) {
+            // the wheel may need to wake up earlier to move entries down a level, but never later than the deadline
+            while(true) {
+                auto next = wheel.nextDeadline();
+                REQUIRE(next);
+                REQUIRE(*next <= deadline);
+                if(*next == deadline) {
+                    break;
+                }
+                wheel.advance(*next, onExpired);
+            }
+            REQUIRE(fired.size() < deadlines.size());
+            REQUIRE((fired.empty() || fired.back() < deadline));
+
+            wheel.advance(deadline - 1, onExpired);
+            REQUIRE((fired.empty() || fired.back() != deadline));
+            wheel.advance(deadline, onExpired);
+            REQUIRE(fired.back() == deadline);
+        }
+
+        REQUIRE(fired == deadlines);
+        REQUIRE(wheel.empty());
+        REQUIRE_FALSE(wheel.nextDeadline());
+    }
+
+    SECTION("TimingWheel removal and past deadlines") {
+        Detail::TimingWheel wheel;
+        Detail::TimingWheelEntry a;
+        Detail::TimingWheelEntry b;
+        Detail::TimingWheelEntry c;
+        uint64_t fired{};
+        auto onExpired = [&](Detail::TimingWheelEntry &) {
+            fired++;
+        };
+
+        wheel.insert(a, 10);
+        wheel.insert(b, 5'000);
+        wheel.remove(b);
+        wheel.remove(b);
+        REQUIRE_FALSE(b.isScheduled());
+        REQUIRE(wheel.size() == 1);
+        REQUIRE(wheel.nextDeadline() == 10);
+
+        wheel.advance(20'000, onExpired);
+        REQUIRE(fired == 1);
+        REQUIRE(wheel.elapsed() == 20'000);
+
+        // already passed, expires on the next advance, even if time stood still
+        wheel.insert(c, 100);
+        REQUIRE(wheel.nextDeadline() == 20'000);
+        wheel.advance(20'000, onExpired);
+        REQUIRE(fired == 2);
+        REQUIRE(wheel.empty());
+    }
+
+    SECTION("TimingWheel entries re-inserted while expiring") {
+        Detail::TimingWheel wheel;
+        Detail::TimingWheelEntry periodic;
+        Detail::TimingWheelEntry other;
+        uint64_t fired{};
+        wheel.insert(periodic, 10);
+        wheel.insert(other, 10);
+
+        auto onExpired = [&](Detail::TimingWheelEntry &entry) {
+            fired++;
+            if(&entry == &periodic) {
+                // already passed and the other entry is removed before it gets handed out
+                wheel.insert(periodic, 10);
+                wheel.remove(other);
+            }
+        };
+
+        wheel.advance(10, onExpired);
+        REQUIRE(fired == 1);
+        REQUIRE(periodic.isScheduled());
+        REQUIRE_FALSE(other.isScheduled());
+
+        wheel.advance(10, [&](Detail::TimingWheelEntry &) {
+            fired++;
+        });
+        REQUIRE(fired == 2);
+        REQUIRE(wheel.empty());
+    }
+
+    SECTION("TimingWheel many entries") {
+        Detail::TimingWheel wheel;
+        std::mt19937_64 rng{1234};
+        std::uniform_int_distribution<uint64_t> deadlineDist{0, 1'000'000};
+        std::uniform_int_distribution<uint64_t> stepDist{1, 5'000};
+        std::vector<Detail::TimingWheelEntry> entries(100'000);
+        for(auto &entry : entries) {
+            wheel.insert(entry, deadlineDist(rng));
+        }
+        // remove every tenth entry
+        for(std::size_t i = 0; i < entries.size(); i += 10) {
+            wheel.remove(entries[i]);
+        }
+        REQUIRE(wheel.size() == 90'000);
+
+        uint64_t previousNow{};
+        uint64_t now{};
+        uint64_t fired{};
+        while(!wheel.empty()) {
+            now += stepDist(rng);
+            wheel.advance(now, [&](Detail::TimingWheelEntry &entry) {
+                REQUIRE(entry.deadline <= now);
+                REQUIRE((entry.deadline > previousNow || entry.deadline == 0));
+                fired++;
+            });
+            previousNow = now;
+        }
+        REQUIRE(fired == 90'000);
+    }
+
+    SECTION("TimingWheel coalesce") {
+        REQUIRE(Detail::TimingWheel::coalesce(12'345, 0) == 12'345);
+        REQUIRE(Detail::TimingWheel::coalesce(UINT64_MAX - 10, 100) == UINT64_MAX - 10);
+        REQUIRE(Detail::TimingWheel::coalesce(1'000, 24) == 1'024);
+        REQUIRE(Detail::TimingWheel::coalesce(1'024, 1'000) == 1'024);
+
+        std::mt19937_64 rng{1234};
+        std::uniform_int_distribution<uint64_t> deadlineDist{0, 1'000'000'000};
+        std::uniform_int_distribution<uint64_t> slackDist{0, 100'000};
+        for(uint64_t i = 0; i < 100'000; i++) {
+            auto const deadline = deadlineDist(rng);
+            auto const slack = slackDist(rng);
+            auto const coalesced = Detail::TimingWheel::coalesce(deadline, slack);
+            REQUIRE(coalesced >= deadline);
+            REQUIRE(coalesced <= deadline + slack);
+        }
+
+        // 500 deadlines within half the slack of each other share a handful of ticks
+        std::set<uint64_t> ticks;
+        for(uint64_t deadline = 10'000; deadline < 10'500; deadline++) {
+            ticks.insert(Detail::TimingWheel::coalesce(deadline, 1'000));
+        }
+        REQUIRE(ticks.size() <= 3);
+    }
 }
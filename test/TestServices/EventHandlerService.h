@@ -47,3 +47,69 @@ struct EventHandlerService final : public IEventHandlerService, public AdvancedS
     EventHandlerRegistration _handler{};
     std::unordered_map<uint64_t, uint64_t> handledEvents;
 };
+
+/// Same as EventHandlerService, but with a handler that cannot suspend. Returning false stops propagation to other handlers.
+template <Derived<Event> EventT, typename ReturnT>
+struct SyncEventHandlerService final : public IEventHandlerService, public AdvancedService<SyncEventHandlerService<EventT, ReturnT>> {
+    SyncEventHandlerService() = default;
+
+    Task<tl::expected<void, Ichor::StartError>> start() final {
+        _handler = GetThreadLocalManager().template registerEventHandler<EventT>(this, this);
+
+        co_return {};
+    }
+
+    Task<void> stop() final {
+        _handler.reset();
+
+        co_return;
+    }
+
+    ReturnT handleEvent(EventT const &evt) {
+        handledEvents[evt.type]++;
+
+        if constexpr (std::is_same_v<ReturnT, bool>) {
+            return false;
+        }
+    }
+
+    std::unordered_map<uint64_t, uint64_t>& getHandledEvents() final {
+        return handledEvents;
+    }
+
+    EventHandlerRegistration _handler{};
+    std::unordered_map<uint64_t, uint64_t> handledEvents;
+};
+
+/// Only handles events originating from the service id in the "TargetServiceId" property. Returning false stops propagation to other handlers.
+template <Derived<Event> EventT, typename ReturnT = void>
+struct TargetedEventHandlerService final : public IEventHandlerService, public AdvancedService<TargetedEventHandlerService<EventT, ReturnT>> {
+    TargetedEventHandlerService(Properties props) : AdvancedService<TargetedEventHandlerService<EventT, ReturnT>>(std::move(props)) {}
+
+    Task<tl::expected<void, Ichor::StartError>> start() final {
+        _handler = GetThreadLocalManager().template registerEventHandler<EventT>(this, this, Ichor::any_cast<uint64_t>(this->getProperties().find("TargetServiceId")->second));
+
+        co_return {};
+    }
+
+    Task<void> stop() final {
+        _handler.reset();
+
+        co_return;
+    }
+
+    ReturnT handleEvent(EventT const &evt) {
+        handledEvents[evt.type]++;
+
+        if constexpr (std::is_same_v<ReturnT, bool>) {
+            return false;
+        }
+    }
+
+    std::unordered_map<uint64_t, uint64_t>& getHandledEvents() final {
+        return handledEvents;
+    }
+
+    EventHandlerRegistration _handler{};
+    std::unordered_map<uint64_t, uint64_t> handledEvents;
+};
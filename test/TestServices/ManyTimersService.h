@@ -0,0 +1,59 @@
+#pragma once
+
+#include <ichor/services/timer/ITimerFactory.h>
+#include <ichor/dependency_management/AdvancedService.h>
+
+using namespace Ichor;
+
+class IManyTimersService {
+public:
+    virtual uint64_t getFired() const noexcept = 0;
+    virtual uint64_t getRemoteFired() const noexcept = 0;
+    virtual ITimer& getRemoteTimer() noexcept = 0;
+protected:
+    ~IManyTimersService() = default;
+};
+
+/// Runs timerCount timers that stop themselves after firing firesPerTimer times, plus one timer that is left to be started and stopped by another thread
+class ManyTimersService final : public IManyTimersService {
+public:
+    static constexpr uint64_t timerCount = 1'000;
+    static constexpr uint64_t firesPerTimer = 3;
+
+    ManyTimersService(ITimerFactory *factory) {
+        for(uint64_t i = 0; i < timerCount; i++) {
+            auto &timer = factory->createTimer();
+            timer.setChronoInterval(std::chrono::milliseconds(10 + i % 10));
+            timer.setCallback([this, &timer = timer, fires = uint64_t{}]() mutable {
+                fired.fetch_add(1, std::memory_order_acq_rel);
+                if(++fires == firesPerTimer) {
+                    timer.stopTimer();
+                }
+            });
+            timer.startTimer();
+        }
+
+        remoteTimer = &factory->createTimer();
+        remoteTimer->setChronoInterval(std::chrono::milliseconds(1));
+        remoteTimer->setCallback([this]() {
+            remoteFired.fetch_add(1, std::memory_order_acq_rel);
+        });
+    }
+
+    uint64_t getFired() const noexcept final {
+        return fired.load(std::memory_order_acquire);
+    }
+
+    uint64_t getRemoteFired() const noexcept final {
+        return remoteFired.load(std::memory_order_acquire);
+    }
+
+    ITimer& getRemoteTimer() noexcept final {
+        return *remoteTimer;
+    }
+
+private:
+    std::atomic<uint64_t> fired{};
+    std::atomic<uint64_t> remoteFired{};
+    ITimer *remoteTimer{};
+};
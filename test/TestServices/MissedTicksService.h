@@ -0,0 +1,97 @@
+#pragma once
+
+#include <ichor/services/timer/ITimerFactory.h>
+#include <ichor/dependency_management/AdvancedService.h>
+#include <ichor/events/RunFunctionEvent.h>
+#include <thread>
+
+using namespace Ichor;
+
+class IMissedTicksService {
+public:
+    virtual uint64_t getFired(TimerMissedTickPolicy policy) const noexcept = 0;
+    virtual uint64_t getEarlyFires() const noexcept = 0;
+    virtual uint64_t getAsyncCatchUpFired() const noexcept = 0;
+    virtual bool done() const noexcept = 0;
+protected:
+    ~IMissedTicksService() = default;
+};
+
+/// Runs a timer per missed tick policy plus a CATCH_UP timer with an async callback and blocks the event loop for ten intervals right after starting them.
+/// All timers are stopped once the CATCH_UP timer fired catchUpFires times.
+class MissedTicksService final : public IMissedTicksService {
+public:
+    static constexpr std::chrono::milliseconds interval{10};
+    static constexpr uint64_t catchUpFires = 15;
+
+    MissedTicksService(ITimerFactory *factory) {
+        _start = std::chrono::steady_clock::now();
+        // FIRE_ONCE first, so that its expiries are handled before those of the others
+        for(auto policy : {TimerMissedTickPolicy::FIRE_ONCE, TimerMissedTickPolicy::SKIP, TimerMissedTickPolicy::CATCH_UP}) {
+            auto &timer = factory->createTimer();
+            timer.setChronoInterval(interval);
+            timer.setChronoSlack(std::chrono::milliseconds(2));
+            timer.setMissedTickPolicy(policy);
+            timer.setCallback([this, policy]() {
+                auto const fired = _fired[static_cast<uint8_t>(policy)].fetch_add(1, std::memory_order_acq_rel) + 1;
+                if(policy != TimerMissedTickPolicy::CATCH_UP) {
+                    return;
+                }
+
+                // every expiry is handled, so the nth one cannot happen before its deadline
+                if(std::chrono::steady_clock::now() < _start + interval * fired) {
+                    _earlyFires.fetch_add(1, std::memory_order_acq_rel);
+                }
+                if(fired == catchUpFires) {
+                    for(auto *t : _timers) {
+                        t->stopTimer();
+                    }
+                    _done.store(true, std::memory_order_release);
+                }
+            });
+            _timers.push_back(&timer);
+        }
+
+        auto &asyncTimer = factory->createTimer();
+        asyncTimer.setChronoInterval(interval);
+        asyncTimer.setChronoSlack(std::chrono::milliseconds(2));
+        asyncTimer.setMissedTickPolicy(TimerMissedTickPolicy::CATCH_UP);
+        asyncTimer.setCallbackAsync([this]() -> AsyncGenerator<IchorBehaviour> {
+            _asyncCatchUpFired.fetch_add(1, std::memory_order_acq_rel);
+            co_return {};
+        });
+        _timers.push_back(&asyncTimer);
+
+        for(auto *timer : _timers) {
+            timer->startTimer();
+        }
+
+        GetThreadLocalEventQueue().pushEvent<RunFunctionEvent>(0, []() {
+            std::this_thread::sleep_for(interval * 10);
+        });
+    }
+
+    uint64_t getFired(TimerMissedTickPolicy policy) const noexcept final {
+        return _fired[static_cast<uint8_t>(policy)].load(std::memory_order_acquire);
+    }
+
+    uint64_t getEarlyFires() const noexcept final {
+        return _earlyFires.load(std::memory_order_acquire);
+    }
+
+    uint64_t getAsyncCatchUpFired() const noexcept final {
+        return _asyncCatchUpFired.load(std::memory_order_acquire);
+    }
+
+    bool done() const noexcept final {
+        return _done.load(std::memory_order_acquire);
+    }
+
+private:
+    std::chrono::steady_clock::time_point _start{};
+    std::vector<ITimer*> _timers{};
+    std::array<std::atomic<uint64_t>, 3> _fired{};
+    std::atomic<uint64_t> _earlyFires{};
+    std::atomic<uint64_t> _asyncCatchUpFired{};
+    std::atomic<bool> _done{};
+};
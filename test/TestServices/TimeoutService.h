@@ -0,0 +1,84 @@
+#pragma once
+
+#include <ichor/services/timer/ITimerFactory.h>
+#include <ichor/services/timer/WithTimeout.h>
+#include <ichor/coroutines/AsyncCrossThreadEvent.h>
+#include <ichor/dependency_management/AdvancedService.h>
+#include <ichor/events/RunFunctionEvent.h>
+#include <ichor/DependencyManager.h>
+
+using namespace Ichor;
+
+/// Awaits an operation that only completes when cancelled, once with a timeout and once until the service gets stopped.
+/// Also awaits operations with a timeout that complete on time or ignore the cancellation and complete late.
+class TimeoutService final : public AdvancedService<TimeoutService> {
+public:
+    TimeoutService(DependencyRegister &reg, Properties props) : AdvancedService(std::move(props)) {
+        reg.registerDependency<ITimerFactory>(this, true);
+    }
+    ~TimeoutService() final = default;
+
+    Task<tl::expected<void, Ichor::StartError>> start() final {
+        auto expired = co_await withTimeout(*_timerFactory, 10ms, [](CancellationToken token) -> Task<std::optional<int>> {
+            co_await waitForCancellation(std::move(token));
+            co_return std::nullopt;
+        });
+        timedOut = !expired && expired.error() == TimeoutError::TIMED_OUT;
+
+        auto late = co_await withTimeout(*_timerFactory, 1ms, [this](CancellationToken) -> Task<std::optional<int>> {
+            // ignores the token, completing after the outer timeout expired
+            co_await withTimeout(*_timerFactory, 20ms, [](CancellationToken token) {
+                return waitForCancellation(std::move(token));
+            });
+            co_return 7;
+        });
+        lateValue = late ? late->value_or(0) : 0;
+
+        auto completed = co_await withTimeout(*_timerFactory, 10s, [](CancellationToken) -> Task<int> {
+            co_return 5;
+        });
+        completedValue = completed.value_or(0);
+
+        // in-flight coroutine, which would prevent stopping this service if it did not observe the stop token
+        GetThreadLocalEventQueue().pushEvent<RunFunctionEventAsync>(getServiceId(), [this]() -> AsyncGenerator<IchorBehaviour> {
+            auto token = GetThreadLocalManager().getServiceStopToken(getServiceId());
+            waitingForStop = true;
+            co_await waitForCancellation(std::move(token));
+            cancelledByStop = true;
+            co_return {};
+        });
+
+        co_return {};
+    }
+
+    Task<void> stop() final {
+        co_return;
+    }
+
+    void addDependencyInstance(ITimerFactory &factory, IService &) {
+        _timerFactory = &factory;
+    }
+
+    void removeDependencyInstance(ITimerFactory &, IService&) {
+        _timerFactory = nullptr;
+    }
+
+    bool timedOut{};
+    int completedValue{};
+    int lateValue{};
+    std::atomic<bool> waitingForStop{};
+    std::atomic<bool> cancelledByStop{};
+
+private:
+    static Task<void> waitForCancellation(CancellationToken token) {
+        AsyncCrossThreadEvent evt{};
+        CancellationRegistration const registration{token, [&evt]() {
+            evt.set();
+        }};
+        co_await evt;
+    }
+
+    ITimerFactory *_timerFactory{};
+
+    friend DependencyRegister;
+};
@@ -0,0 +1,198 @@
+#include "Common.h"
+#include <ichor/coroutines/WhenAll.h>
+#include <ichor/coroutines/WhenAny.h>
+#include <ichor/coroutines/AsyncManualResetEvent.h>
+#include <stdexcept>
+
+Ichor::Task<int> task_immediate(int value) {
+    co_return value;
+}
+
+Ichor::Task<int> task_waiting_on(Ichor::AsyncManualResetEvent &evt, int value) {
+    co_await evt;
+    co_return value;
+}
+
+Ichor::Task<void> task_void_waiting_on(Ichor::AsyncManualResetEvent &evt, bool &ran) {
+    co_await evt;
+    ran = true;
+}
+
+Ichor::Task<int> task_throwing_on(Ichor::AsyncManualResetEvent &evt) {
+    co_await evt;
+    throw std::runtime_error("task_throwing_on");
+}
+
+Ichor::Task<tl::expected<int, Ichor::StartError>> task_expected(Ichor::AsyncManualResetEvent &evt, bool fail) {
+    co_await evt;
+    if(fail) {
+        co_return tl::unexpected(Ichor::StartError::FAILED);
+    }
+    co_return 1;
+}
+
+Ichor::AsyncGenerator<int> generator_waiting_on(Ichor::AsyncManualResetEvent &evt, int value) {
+    co_await evt;
+    co_return value;
+}
+
+template<typename F>
+Ichor::AsyncGenerator<void> run(F f) {
+    co_await f();
+    co_return;
+}
+
+TEST_CASE("WhenAllTests") {
+
+    SECTION("whenAll of completed tasks does not suspend") {
+        std::tuple<int, int> result{};
+        auto gen = run([&]() -> Ichor::Task<void> {
+            result = co_await Ichor::whenAll(task_immediate(1), task_immediate(2));
+        });
+        auto it = gen.begin();
+        CHECK(it.get_finished());
+        CHECK(result == std::tuple<int, int>{1, 2});
+    }
+
+    SECTION("whenAll resumes after the last task completes") {
+        Ichor::AsyncManualResetEvent evt1;
+        Ichor::AsyncManualResetEvent evt2;
+        bool ran{};
+        bool done{};
+        int value{};
+        auto gen = run([&]() -> Ichor::Task<void> {
+            auto [v, empty] = co_await Ichor::whenAll(task_waiting_on(evt1, 5), task_void_waiting_on(evt2, ran));
+            static_assert(std::is_same_v<decltype(empty), Ichor::Empty>);
+            value = v;
+            done = true;
+        });
+        auto it = gen.begin();
+        CHECK(!done);
+        evt2.set();
+        CHECK(ran);
+        CHECK(!done);
+        evt1.set();
+        CHECK(done);
+        CHECK(value == 5);
+        CHECK(it.get_finished());
+    }
+
+    SECTION("whenAll rethrows once all tasks completed") {
+        Ichor::AsyncManualResetEvent evt1;
+        Ichor::AsyncManualResetEvent evt2;
+        bool ran{};
+        bool caught{};
+        auto gen = run([&]() -> Ichor::Task<void> {
+            try {
+                co_await Ichor::whenAll(task_throwing_on(evt1), task_void_waiting_on(evt2, ran));
+            } catch(std::runtime_error const &) {
+                caught = true;
+            }
+        });
+        auto it = gen.begin();
+        evt1.set();
+        CHECK(!caught);
+        evt2.set();
+        CHECK(ran);
+        CHECK(caught);
+    }
+
+    SECTION("whenAll of a vector of tasks") {
+        Ichor::AsyncManualResetEvent evt;
+        std::vector<int> result;
+        auto gen = run([&]() -> Ichor::Task<void> {
+            std::vector<Ichor::Task<int>> tasks;
+            tasks.emplace_back(task_waiting_on(evt, 1));
+            tasks.emplace_back(task_immediate(2));
+            tasks.emplace_back(task_waiting_on(evt, 3));
+            result = co_await Ichor::whenAll(std::move(tasks));
+        });
+        auto it = gen.begin();
+        CHECK(result.empty());
+        evt.set();
+        CHECK(result == std::vector<int>{1, 2, 3});
+    }
+
+    SECTION("whenAll awaits the first value of generators") {
+        Ichor::AsyncManualResetEvent evt;
+        std::tuple<int, int> result{};
+        auto gen = run([&]() -> Ichor::Task<void> {
+            result = co_await Ichor::whenAll(generator_waiting_on(evt, 3), task_immediate(4));
+        });
+        auto it = gen.begin();
+        evt.set();
+        CHECK(result == std::tuple<int, int>{3, 4});
+    }
+
+    SECTION("whenAllExpected returns the first error") {
+        Ichor::AsyncManualResetEvent evt;
+        std::optional<tl::expected<std::tuple<int, int>, Ichor::StartError>> failed;
+        std::optional<tl::expected<std::tuple<int, int>, Ichor::StartError>> succeeded;
+        auto gen = run([&]() -> Ichor::Task<void> {
+            failed = co_await Ichor::whenAllExpected(task_expected(evt, false), task_expected(evt, true));
+            succeeded = co_await Ichor::whenAllExpected(task_expected(evt, false), task_expected(evt, false));
+        });
+        auto it = gen.begin();
+        evt.set();
+        REQUIRE(failed);
+        CHECK(!*failed);
+        CHECK(failed->error() == Ichor::StartError::FAILED);
+        REQUIRE(succeeded);
+        CHECK(*succeeded);
+        CHECK(**succeeded == std::tuple<int, int>{1, 1});
+    }
+
+    SECTION("whenAny resumes after the first task completes") {
+        Ichor::AsyncManualResetEvent evt1;
+        Ichor::AsyncManualResetEvent evt2;
+        std::optional<Ichor::WhenAnyResult<int>> result;
+        auto gen = run([&]() -> Ichor::Task<void> {
+            result = co_await Ichor::whenAny(task_waiting_on(evt1, 1), task_waiting_on(evt2, 2));
+        });
+        auto it = gen.begin();
+        CHECK(!result);
+        evt2.set();
+        REQUIRE(result);
+        CHECK(result->index == 1);
+        CHECK(result->value == 2);
+        CHECK(it.get_finished());
+
+        // the other task keeps running and is cleaned up on completion
+        evt1.set();
+        CHECK(result->index == 1);
+    }
+
+    SECTION("whenAny does not start tasks after one that completes immediately") {
+        Ichor::AsyncManualResetEvent evt;
+        bool ran{};
+        std::optional<Ichor::WhenAnyResult<Ichor::Empty>> result;
+        auto gen = run([&]() -> Ichor::Task<void> {
+            std::vector<Ichor::Task<void>> tasks;
+            tasks.emplace_back([]() -> Ichor::Task<void> { co_return; }());
+            tasks.emplace_back(task_void_waiting_on(evt, ran));
+            result = co_await Ichor::whenAny(std::move(tasks));
+        });
+        auto it = gen.begin();
+        REQUIRE(result);
+        CHECK(result->index == 0);
+        evt.set();
+        CHECK(!ran);
+    }
+
+    SECTION("whenAny rethrows when the first task to complete throws") {
+        Ichor::AsyncManualResetEvent evt1;
+        Ichor::AsyncManualResetEvent evt2;
+        bool caught{};
+        auto gen = run([&]() -> Ichor::Task<void> {
+            try {
+                co_await Ichor::whenAny(task_throwing_on(evt1), task_waiting_on(evt2, 2));
+            } catch(std::runtime_error const &) {
+                caught = true;
+            }
+        });
+        auto it = gen.begin();
+        evt1.set();
+        CHECK(caught);
+        evt2.set();
+    }
+}